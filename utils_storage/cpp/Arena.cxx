@@ -0,0 +1,206 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "Arena.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * --- Arena ------------------------------------------------------------------
+ */
+
+Arena::Arena(size_t block_size)
+    : block_size_(block_size),
+      offset_(0),
+      used_size_(0),
+      reserved_size_(0)
+{
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    if (!blocks_.empty()) {
+        Block& block = blocks_.back();
+        uintptr_t address =
+                reinterpret_cast<uintptr_t>(block.data.get()) + offset_;
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (offset_ + padding + size <= block.size) {
+            char *memory = block.data.get() + offset_ + padding;
+            offset_ += padding + size;
+            used_size_ += size;
+            return memory;
+        }
+        // the remaining space of the block is left unused
+    }
+
+    Block block;
+    block.size = std::max(block_size_, size + alignment);
+    block.data.reset(new char[block.size]);
+    reserved_size_ += block.size;
+    blocks_.push_back(std::move(block));
+    offset_ = 0;
+
+    return allocate(size, alignment);
+}
+
+size_t Arena::used_size() const
+{
+    return used_size_;
+}
+
+size_t Arena::reserved_size() const
+{
+    return reserved_size_;
+}
+
+size_t Arena::BLOCK_SIZE_DEFAULT()
+{
+    return 64 * 1024;
+}
+
+
+/*
+ * --- ArenaString ------------------------------------------------------------
+ */
+
+ArenaString::ArenaString()
+    : data_(""),
+      length_(0)
+{
+}
+
+ArenaString::ArenaString(const char *value, size_t length, Arena& arena)
+    : data_(""),
+      length_(length)
+{
+    if (length == 0) {
+        return;
+    }
+    char *data = static_cast<char *>(arena.allocate(length + 1, 1));
+    std::memcpy(data, value, length);
+    data[length] = '\0';
+    data_ = data;
+}
+
+ArenaString ArenaString::reference(const char *value, size_t length)
+{
+    ArenaString result;
+    result.data_ = value;
+    result.length_ = length;
+
+    return result;
+}
+
+const char* ArenaString::c_str() const
+{
+    return data_;
+}
+
+size_t ArenaString::length() const
+{
+    return length_;
+}
+
+bool ArenaString::empty() const
+{
+    return length_ == 0;
+}
+
+std::string ArenaString::str() const
+{
+    return std::string(data_, length_);
+}
+
+bool ArenaString::operator==(const ArenaString& other) const
+{
+    return length_ == other.length_
+            && std::memcmp(data_, other.data_, length_) == 0;
+}
+
+bool ArenaString::operator!=(const ArenaString& other) const
+{
+    return !(*this == other);
+}
+
+bool ArenaString::operator==(const char *other) const
+{
+    return std::strncmp(data_, other, length_) == 0
+            && other[length_] == '\0';
+}
+
+bool ArenaString::operator==(const std::string& other) const
+{
+    return length_ == other.length()
+            && std::memcmp(data_, other.data(), length_) == 0;
+}
+
+std::string& operator+=(std::string& output, const ArenaString& value)
+{
+    return output.append(value.c_str(), value.length());
+}
+
+std::ostream& operator<<(std::ostream& os, const ArenaString& value)
+{
+    return os.write(value.c_str(), value.length());
+}
+
+
+/*
+ * --- StringPool -------------------------------------------------------------
+ */
+
+size_t StringPool::Hash::operator()(const ArenaString& value) const
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    const char *data = value.c_str();
+    for (size_t i = 0; i < value.length(); i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    return static_cast<size_t>(hash);
+}
+
+StringPool::StringPool(Arena& arena)
+    : arena_(arena),
+      strings_(
+              0,
+              Hash(),
+              std::equal_to<ArenaString>(),
+              ArenaAllocator<ArenaString>(arena))
+{
+}
+
+ArenaString StringPool::intern(const std::string& value)
+{
+    auto found = strings_.find(
+            ArenaString::reference(value.c_str(), value.length()));
+    if (found != strings_.end()) {
+        return *found;
+    }
+    ArenaString copy(value.c_str(), value.length(), arena_);
+    strings_.insert(copy);
+
+    return copy;
+}
+
+size_t StringPool::size() const
+{
+    return strings_.size();
+}
+
+} } }
@@ -0,0 +1,232 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_ARENA_HPP_
+#define RTI_RECORDER_UTILS_ARENA_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Monotonic memory resource.
+ *
+ * Memory is handed out from large blocks by advancing an offset, and it's
+ * never released individually: the blocks are freed when the arena is
+ * destroyed, without running the destructors of the objects they contain.
+ *
+ * An Arena is meant for data structures built once and freed as a whole,
+ * such as the ColumnInfo tree of a type, which would otherwise allocate and
+ * free every node individually. The objects are expected to be trivially
+ * destructible.
+ */
+class Arena {
+public:
+    /**
+     * @brief Creates an arena that allocates blocks of the specified size.
+     * Larger requests get a block of their own.
+     */
+    explicit Arena(size_t block_size = BLOCK_SIZE_DEFAULT());
+
+    /**
+     * @brief Returns memory for size bytes with the specified alignment,
+     * which must be a power of two.
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * @brief Returns the number of bytes handed out
+     */
+    size_t used_size() const;
+
+    /**
+     * @brief Returns the number of bytes of the allocated blocks
+     */
+    size_t reserved_size() const;
+
+    static size_t BLOCK_SIZE_DEFAULT();
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    // offset of the next allocation in the last block
+    size_t offset_;
+    size_t used_size_;
+    size_t reserved_size_;
+};
+
+/**
+ * @brief Allocator of the standard containers that draws from an Arena.
+ *
+ * deallocate() is a no-op: the memory is reclaimed when the arena is
+ * destroyed, so the arena must outlive the containers that use it.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(Arena& arena) : arena_(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_)
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t)
+    {
+    }
+
+    /**
+     * @brief Returns the arena this allocator draws from
+     */
+    Arena& arena() const
+    {
+        return *arena_;
+    }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    Arena *arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& left, const ArenaAllocator<U>& right)
+{
+    return &left.arena() == &right.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& left, const ArenaAllocator<U>& right)
+{
+    return !(left == right);
+}
+
+/**
+ * @brief Null-terminated string whose characters are stored in an Arena.
+ *
+ * It's a pointer and a length, trivially copyable and destructible, and it
+ * remains valid while the arena exists. The default value is the empty
+ * string, which needs no arena.
+ */
+class ArenaString {
+public:
+    ArenaString();
+
+    /**
+     * @brief Copies the characters of a value into an arena
+     */
+    ArenaString(const char *value, size_t length, Arena& arena);
+
+    /**
+     * @brief Refers to the null-terminated characters of a value without
+     * copying them, which must remain valid while the result is used, e.g.
+     * to look up a value.
+     */
+    static ArenaString reference(const char *value, size_t length);
+
+    const char* c_str() const;
+
+    size_t length() const;
+
+    bool empty() const;
+
+    /**
+     * @brief Returns a copy of the value as a std::string
+     */
+    std::string str() const;
+
+    bool operator==(const ArenaString& other) const;
+
+    bool operator!=(const ArenaString& other) const;
+
+    bool operator==(const char *other) const;
+
+    bool operator==(const std::string& other) const;
+
+private:
+    const char *data_;
+    size_t length_;
+};
+
+/**
+ * @brief Appends an ArenaString to a std::string
+ */
+std::string& operator+=(std::string& output, const ArenaString& value);
+
+std::ostream& operator<<(std::ostream& os, const ArenaString& value);
+
+/**
+ * @brief Set of unique ArenaStrings.
+ *
+ * Interning a string returns the single copy in the arena, which remains
+ * valid while the arena exists, even after the pool is destroyed. Repeated
+ * names, such as the member names of the elements of an array of
+ * structures, are stored once. A pool is only needed while the strings are
+ * added, and its lookup table is allocated from the arena as well.
+ */
+class StringPool {
+public:
+    explicit StringPool(Arena& arena);
+
+    /**
+     * @brief Returns the pooled copy of the specified value, adding it if
+     * it's not in the pool yet.
+     */
+    ArenaString intern(const std::string& value);
+
+    /**
+     * @brief Returns the number of unique strings in the pool
+     */
+    size_t size() const;
+
+private:
+    struct Hash {
+        size_t operator()(const ArenaString& value) const;
+    };
+
+    typedef std::unordered_set<
+            ArenaString,
+            Hash,
+            std::equal_to<ArenaString>,
+            ArenaAllocator<ArenaString>> string_set;
+
+    Arena& arena_;
+    string_set strings_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,266 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/*
+ * Command-line tool that converts the segment files generated with the CDR
+ * output format into any of the other output formats. The samples of each
+ * segment are deserialized and stored through the same StreamWriter that
+ * the plug-in uses during recording. Segment files are converted in
+ * parallel, one per thread.
+ *
+ * Usage: utilsstorage_cdr_replay --types <XML file> [--threads <count>]
+ *         [--property <name>=<value>]... <segment file>...
+ *
+ * The types of the segments are loaded from the XML file. Property names
+ * without the plug-in namespace are prefixed with it.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <dds/core/QosProvider.hpp>
+#include <rti/core/xtypes/DynamicDataFuncs.hpp>
+
+#include "CdrSegmentFormat.hpp"
+#include "FileContent.hpp"
+#include "UtilsStorageWriter.hpp"
+
+using namespace rti::recorder::utils;
+
+// maximum number of samples passed to each call to store()
+const size_t BATCH_SIZE = 256;
+
+/*
+ * State shared by the conversion threads
+ */
+struct ReplayContext {
+    ReplayContext(
+            const std::string& types_file_path,
+            const rti::routing::PropertySet& properties) :
+        qos_provider(types_file_path),
+        storage_writer(properties),
+        next_file(0),
+        failed(false)
+    {
+    }
+
+    dds::core::QosProvider qos_provider;
+    UtilsStorageWriter storage_writer;
+    // serializes access to the storage writer
+    std::mutex mutex;
+    std::vector<std::string> file_paths;
+    std::atomic<size_t> next_file;
+    std::atomic<bool> failed;
+};
+
+std::string index_file_path(const std::string& segment_file_path)
+{
+    const std::string& extension = UtilsStorageWriter::CDR_FILE_EXTENSION();
+    if (segment_file_path.length() < extension.length()
+            || segment_file_path.compare(
+                    segment_file_path.length() - extension.length(),
+                    extension.length(),
+                    extension) != 0) {
+        return "";
+    }
+    return segment_file_path.substr(
+                    0,
+                    segment_file_path.length() - extension.length())
+            + UtilsStorageWriter::CDR_INDEX_FILE_EXTENSION();
+}
+
+void convert_file(ReplayContext& context, const std::string& file_path)
+{
+    using namespace dds::core::xtypes;
+
+    FileContent segment_content(file_path);
+    // the index is optional: records are scanned if it's not present
+    std::unique_ptr<FileContent> index_content;
+    try {
+        std::string index_path = index_file_path(file_path);
+        if (!index_path.empty()) {
+            index_content.reset(new FileContent(index_path));
+        }
+    } catch (const std::exception&) {
+    }
+    cdr_segment::SegmentReader reader(
+            segment_content.data(),
+            segment_content.size(),
+            index_content ? index_content->data() : NULL,
+            index_content ? index_content->size() : 0);
+
+    const DynamicType *type = NULL;
+    {
+        std::lock_guard<std::mutex> guard(context.mutex);
+        type = &context.qos_provider->type(reader.type_name());
+    }
+    rti::routing::StreamInfo stream_info(
+            reader.topic_name(),
+            reader.type_name());
+    stream_info.type_info().type_representation_kind(
+            rti::routing::TypeRepresentationKind::DYNAMIC_TYPE);
+    stream_info.type_info().type_representation(
+            const_cast<DynamicType *>(type));
+
+    rti::recording::storage::StorageStreamWriter *writer = NULL;
+    {
+        std::lock_guard<std::mutex> guard(context.mutex);
+        writer = context.storage_writer.create_stream_writer(
+                stream_info,
+                rti::routing::PropertySet());
+    }
+    rti::recording::storage::DynamicDataStorageStreamWriter *stream_writer =
+            static_cast<rti::recording::storage::DynamicDataStorageStreamWriter *>(
+                    writer);
+
+    std::vector<DynamicData> samples(BATCH_SIZE, DynamicData(*type));
+    std::vector<dds::sub::SampleInfo> infos(BATCH_SIZE);
+    std::vector<DynamicData *> sample_seq;
+    std::vector<dds::sub::SampleInfo *> info_seq;
+    std::vector<char> cdr_buffer;
+    try {
+        uint64_t record = 0;
+        while (record < reader.record_count()) {
+            sample_seq.clear();
+            info_seq.clear();
+            for (size_t i = 0;
+                    i < BATCH_SIZE && record < reader.record_count();
+                    i++, record++) {
+                cdr_buffer.assign(
+                        reader.data(record),
+                        reader.data(record) + reader.length(record));
+                rti::core::xtypes::from_cdr_buffer(samples[i], cdr_buffer);
+
+                DDS_SampleInfo& native_info = infos[i]->native();
+                native_info.reception_timestamp.sec = static_cast<DDS_Long>(
+                        reader.timestamp(record) / 1000000000);
+                native_info.reception_timestamp.nanosec =
+                        static_cast<DDS_UnsignedLong>(
+                                reader.timestamp(record) % 1000000000);
+                native_info.valid_data = DDS_BOOLEAN_TRUE;
+
+                sample_seq.push_back(&samples[i]);
+                info_seq.push_back(&infos[i]);
+            }
+            stream_writer->store(sample_seq, info_seq);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> guard(context.mutex);
+        context.storage_writer.delete_stream_writer(writer);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> guard(context.mutex);
+    context.storage_writer.delete_stream_writer(writer);
+}
+
+void convert_files(ReplayContext& context)
+{
+    size_t index;
+    while ((index = context.next_file++) < context.file_paths.size()) {
+        const std::string& file_path = context.file_paths[index];
+        try {
+            convert_file(context, file_path);
+        } catch (const std::exception& ex) {
+            std::lock_guard<std::mutex> guard(context.mutex);
+            std::cerr << "failed to convert file=" << file_path
+                    << ": " << ex.what() << std::endl;
+            context.failed = true;
+        }
+    }
+}
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program
+            << " --types <XML file> [--threads <count>]"
+            << " [--property <name>=<value>]... <segment file>..."
+            << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *types_file_path = NULL;
+    unsigned int thread_count = std::thread::hardware_concurrency();
+    rti::routing::PropertySet properties;
+    std::vector<std::string> file_paths;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--types") == 0 && i + 1 < argc) {
+            types_file_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = static_cast<unsigned int>(
+                    std::strtoul(argv[++i], NULL, 10));
+        } else if (std::strcmp(argv[i], "--property") == 0 && i + 1 < argc) {
+            std::string property(argv[++i]);
+            size_t separator = property.find('=');
+            if (separator == std::string::npos) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            std::string name = property.substr(0, separator);
+            if (name.compare(
+                    0,
+                    UtilsStorageWriter::PROPERTY_NAMESPACE().length(),
+                    UtilsStorageWriter::PROPERTY_NAMESPACE()) != 0) {
+                name = UtilsStorageWriter::PROPERTY_NAMESPACE() + "." + name;
+            }
+            properties[name] = property.substr(separator + 1);
+        } else {
+            file_paths.push_back(argv[i]);
+        }
+    }
+    if (types_file_path == NULL || file_paths.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+
+    auto format = properties.find(
+            UtilsStorageWriter::OUTPUT_FORMAT_PROPERTY_NAME());
+    if (format != properties.end() && format->second == "CDR") {
+        std::cerr << "segments cannot be replayed into CDR format" << std::endl;
+        return 1;
+    }
+    // files are converted concurrently so they cannot be consolidated
+    properties[UtilsStorageWriter::OUTPUT_MERGE_PROPERTY_NAME()] = "false";
+
+    try {
+        ReplayContext context(types_file_path, properties);
+        context.file_paths = file_paths;
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1;
+                i < thread_count && i < file_paths.size();
+                i++) {
+            threads.push_back(std::thread(convert_files, std::ref(context)));
+        }
+        convert_files(context);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        return context.failed ? 1 : 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,252 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include "CdrSegmentFormat.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+namespace cdr_segment {
+
+const char* MAGIC()
+{
+    static const char value[MAGIC_SIZE] = {
+        'R', 'T', 'I', 'C', 'D', 'R', '1', '\0'
+    };
+    return value;
+}
+
+const char* INDEX_MAGIC()
+{
+    static const char value[MAGIC_SIZE] = {
+        'R', 'T', 'I', 'C', 'D', 'X', '1', '\0'
+    };
+    return value;
+}
+
+/*
+ * Helpers to serialize the headers
+ */
+template <typename T>
+void put(std::ostream& output, T value)
+{
+    output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void put_string(std::ostream& output, const std::string& value)
+{
+    put<uint32_t>(output, static_cast<uint32_t>(value.size()));
+    output.write(value.data(), value.size());
+}
+
+/*
+ * --- SegmentWriter ----------------------------------------------------------
+ */
+
+SegmentWriter::SegmentWriter(
+        std::ostream& segment,
+        std::ostream& index,
+        const std::string& topic_name,
+        const std::string& type_name) :
+    segment_(segment),
+    index_(index),
+    offset_(0),
+    record_count_(0)
+{
+    segment_.write(MAGIC(), MAGIC_SIZE);
+    put<uint32_t>(segment_, VERSION);
+    put<uint32_t>(segment_, ENDIANNESS_MARKER);
+    put_string(segment_, topic_name);
+    put_string(segment_, type_name);
+    offset_ = MAGIC_SIZE + 4 * sizeof(uint32_t)
+            + topic_name.size()
+            + type_name.size();
+
+    index_.write(INDEX_MAGIC(), MAGIC_SIZE);
+    put<uint32_t>(index_, VERSION);
+    put<uint32_t>(index_, ENDIANNESS_MARKER);
+}
+
+void SegmentWriter::append(int64_t timestamp, const char *data, uint32_t length)
+{
+    put<int64_t>(segment_, timestamp);
+    put<uint32_t>(segment_, length);
+    segment_.write(data, length);
+
+    put<uint64_t>(index_, offset_);
+    put<int64_t>(index_, timestamp);
+
+    offset_ += RECORD_HEADER_SIZE + length;
+    ++record_count_;
+}
+
+uint64_t SegmentWriter::record_count() const
+{
+    return record_count_;
+}
+
+void SegmentWriter::flush()
+{
+    // the index must never refer to records that are not in the segment
+    segment_.flush();
+    index_.flush();
+}
+
+/*
+ * --- SegmentReader ----------------------------------------------------------
+ */
+
+SegmentReader::SegmentReader(
+        const char *segment_data,
+        uint64_t segment_size,
+        const char *index_data,
+        uint64_t index_size) :
+    data_(segment_data),
+    size_(segment_size)
+{
+    uint64_t first_record = read_header();
+    if (index_data != NULL) {
+        read_index(index_data, index_size);
+    } else {
+        scan_records(first_record);
+    }
+}
+
+uint64_t SegmentReader::read_header()
+{
+    if (size_ < MAGIC_SIZE + 4 * sizeof(uint32_t)
+            || std::memcmp(data_, MAGIC(), MAGIC_SIZE) != 0) {
+        throw std::runtime_error("not a CDR segment file");
+    }
+
+    uint32_t fields[2];
+    std::memcpy(fields, data_ + MAGIC_SIZE, sizeof(fields));
+    if (fields[0] != VERSION) {
+        throw std::runtime_error("unsupported CDR segment file version");
+    }
+    if (fields[1] != ENDIANNESS_MARKER) {
+        throw std::runtime_error(
+                "CDR segment file was produced on a host with different byte order");
+    }
+
+    uint64_t offset = MAGIC_SIZE + sizeof(fields);
+    std::string *names[] = { &topic_name_, &type_name_ };
+    for (auto name : names) {
+        uint32_t length;
+        if (offset + sizeof(length) > size_) {
+            throw std::runtime_error("CDR segment file header is truncated");
+        }
+        std::memcpy(&length, data_ + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > size_) {
+            throw std::runtime_error("CDR segment file header is truncated");
+        }
+        name->assign(data_ + offset, length);
+        offset += length;
+    }
+
+    return offset;
+}
+
+void SegmentReader::read_index(const char *index_data, uint64_t index_size)
+{
+    if (index_size < INDEX_HEADER_SIZE
+            || std::memcmp(index_data, INDEX_MAGIC(), MAGIC_SIZE) != 0) {
+        throw std::runtime_error("not a CDR segment index file");
+    }
+    uint32_t fields[2];
+    std::memcpy(fields, index_data + MAGIC_SIZE, sizeof(fields));
+    if (fields[0] != VERSION || fields[1] != ENDIANNESS_MARKER) {
+        throw std::runtime_error("CDR segment index file does not match segment");
+    }
+
+    // an incomplete entry at the end is ignored
+    uint64_t entry_count = (index_size - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+    records_.reserve(entry_count);
+    const char *entry_data = index_data + INDEX_HEADER_SIZE;
+    for (uint64_t i = 0; i < entry_count; i++) {
+        uint64_t offset;
+        std::memcpy(&offset, entry_data, sizeof(offset));
+        entry_data += INDEX_ENTRY_SIZE;
+
+        RecordEntry entry;
+        if (!read_record(offset, entry)) {
+            // the index may be written ahead of a segment that was not
+            // flushed completely
+            break;
+        }
+        records_.push_back(entry);
+    }
+}
+
+void SegmentReader::scan_records(uint64_t offset)
+{
+    RecordEntry entry;
+    // stops at the end or at a truncated record
+    while (read_record(offset, entry)) {
+        records_.push_back(entry);
+        offset += RECORD_HEADER_SIZE + entry.length;
+    }
+}
+
+bool SegmentReader::read_record(uint64_t offset, RecordEntry& entry) const
+{
+    // written as differences, since the offset and the length of a corrupt
+    // index may wrap the sums around
+    if (offset > size_ || size_ - offset < RECORD_HEADER_SIZE) {
+        return false;
+    }
+    entry.offset = offset;
+    std::memcpy(&entry.timestamp, data_ + offset, sizeof(entry.timestamp));
+    std::memcpy(
+            &entry.length,
+            data_ + offset + sizeof(entry.timestamp),
+            sizeof(entry.length));
+
+    return entry.length <= size_ - offset - RECORD_HEADER_SIZE;
+}
+
+const std::string& SegmentReader::topic_name() const
+{
+    return topic_name_;
+}
+
+const std::string& SegmentReader::type_name() const
+{
+    return type_name_;
+}
+
+uint64_t SegmentReader::record_count() const
+{
+    return records_.size();
+}
+
+int64_t SegmentReader::timestamp(uint64_t record) const
+{
+    return records_[record].timestamp;
+}
+
+const char* SegmentReader::data(uint64_t record) const
+{
+    return data_ + records_[record].offset + RECORD_HEADER_SIZE;
+}
+
+uint32_t SegmentReader::length(uint64_t record) const
+{
+    return records_[record].length;
+}
+
+} /* namespace cdr_segment */
+
+} } }
@@ -0,0 +1,152 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_CDRSEGMENTFORMAT_HPP_
+#define RTI_RECORDER_UTILS_CDRSEGMENTFORMAT_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * This file has no dependencies on RTI Connext so it can be used to build
+ * standalone readers of the segment files.
+ */
+
+namespace rti { namespace recorder { namespace utils {
+
+namespace cdr_segment {
+
+/**
+ * @brief Layout of a CDR segment file and its index.
+ *
+ * A segment file is append-only:
+ *
+ * - Header: MAGIC(), format VERSION(), ENDIANNESS_MARKER() as written by the
+ *   host, and the topic and type names as strings (uint32 length followed by
+ *   the characters).
+ * - Records, one per sample: int64 reception timestamp in nanoseconds,
+ *   uint32 length and the serialized sample in CDR.
+ *
+ * The index file contains INDEX_MAGIC(), VERSION() and ENDIANNESS_MARKER(),
+ * followed by an entry for each record: uint64 offset of the record in the
+ * segment file and int64 reception timestamp. An entry is appended after its
+ * record, so a reader can ignore a truncated record at the end of a segment
+ * that was not closed properly.
+ *
+ * The integers of the header, records and index entries are written in the
+ * byte order of the host that produces the files.
+ */
+
+/**
+ * @brief Value: "RTICDR1" followed by a null character
+ */
+const char* MAGIC();
+
+/**
+ * @brief Value: "RTICDX1" followed by a null character
+ */
+const char* INDEX_MAGIC();
+const uint32_t MAGIC_SIZE = 8;
+const uint32_t VERSION = 1;
+const uint32_t ENDIANNESS_MARKER = 0x01020304;
+const uint32_t RECORD_HEADER_SIZE = 12;
+const uint32_t INDEX_HEADER_SIZE = 16;
+const uint32_t INDEX_ENTRY_SIZE = 16;
+
+/**
+ * @brief Appends records to a segment file and its index.
+ *
+ * The headers are written on construction. Records are written as they are
+ * appended, without intermediate copies.
+ */
+class SegmentWriter {
+public:
+    SegmentWriter(
+            std::ostream& segment,
+            std::ostream& index,
+            const std::string& topic_name,
+            const std::string& type_name);
+
+    /**
+     * @brief Appends a record with the serialized sample
+     */
+    void append(int64_t timestamp, const char *data, uint32_t length);
+
+    uint64_t record_count() const;
+
+    /**
+     * @brief Flushes the segment file and then the index file
+     */
+    void flush();
+
+private:
+    std::ostream& segment_;
+    std::ostream& index_;
+    uint64_t offset_;
+    uint64_t record_count_;
+};
+
+/**
+ * @brief Provides access to the records of a segment file loaded or mapped
+ * into memory.
+ *
+ * The record offsets are obtained from the index if provided or by scanning
+ * the segment otherwise. data() returns a pointer into the provided buffer,
+ * which must outlive the reader.
+ *
+ * Construction throws std::runtime_error if the content is not a valid
+ * segment file or the index does not match the segment.
+ */
+class SegmentReader {
+public:
+    SegmentReader(
+            const char *segment_data,
+            uint64_t segment_size,
+            const char *index_data = NULL,
+            uint64_t index_size = 0);
+
+    const std::string& topic_name() const;
+    const std::string& type_name() const;
+
+    uint64_t record_count() const;
+
+    int64_t timestamp(uint64_t record) const;
+    const char* data(uint64_t record) const;
+    uint32_t length(uint64_t record) const;
+
+private:
+    struct RecordEntry {
+        uint64_t offset;
+        int64_t timestamp;
+        uint32_t length;
+    };
+
+    uint64_t read_header();
+    void read_index(const char *index_data, uint64_t index_size);
+    void scan_records(uint64_t offset);
+    // returns false if the record does not fit in the segment
+    bool read_record(uint64_t offset, RecordEntry& entry) const;
+
+    const char *data_;
+    uint64_t size_;
+    std::string topic_name_;
+    std::string type_name_;
+    std::vector<RecordEntry> records_;
+};
+
+} /* namespace cdr_segment */
+
+} } }
+
+#endif
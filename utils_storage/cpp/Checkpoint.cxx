@@ -0,0 +1,212 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef RTI_WIN32
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fcntl.h>
+    #include <io.h>
+    #include <windows.h>
+#endif
+
+#include "Checkpoint.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+StreamCheckpoint::StreamCheckpoint() :
+    timestamp(0),
+    timestamp_sample_count(0),
+    row_id(0)
+{
+}
+
+/*
+ * --- CheckpointFile ---------------------------------------------------------
+ */
+
+CheckpointFile::CheckpointFile(const std::string& path) :
+    path_(path)
+{
+}
+
+const std::string& CheckpointFile::path() const
+{
+    return path_;
+}
+
+const std::string& CheckpointFile::FILE_EXTENSION()
+{
+    static const std::string value = ".checkpoint";
+    return value;
+}
+
+bool CheckpointFile::read(StreamCheckpoint& checkpoint) const
+{
+    std::ifstream input(path_.c_str());
+    if (!input.is_open()) {
+        return false;
+    }
+
+    // one key=value line per field
+    checkpoint = StreamCheckpoint();
+    std::string line;
+    while (std::getline(input, line)) {
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            throw std::runtime_error(
+                    "invalid line in checkpoint file=" + path_);
+        }
+        std::string key = line.substr(0, separator);
+        std::istringstream value(line.substr(separator + 1));
+        if (key == "timestamp") {
+            value >> checkpoint.timestamp;
+        } else if (key == "timestamp_samples") {
+            value >> checkpoint.timestamp_sample_count;
+        } else if (key == "row_id") {
+            value >> checkpoint.row_id;
+        } else if (key == "file_size") {
+            uint64_t size = 0;
+            value >> size;
+            checkpoint.file_sizes.push_back(size);
+        }
+        if (value.fail()) {
+            throw std::runtime_error(
+                    "invalid value of " + key
+                    + " in checkpoint file=" + path_);
+        }
+    }
+
+    return true;
+}
+
+void CheckpointFile::write(const StreamCheckpoint& checkpoint) const
+{
+    std::string temporary_path = path_ + ".tmp";
+    {
+        std::ofstream output(temporary_path.c_str(), std::ios::out | std::ios::trunc);
+        output << "timestamp=" << checkpoint.timestamp << "\n"
+                << "timestamp_samples=" << checkpoint.timestamp_sample_count << "\n"
+                << "row_id=" << checkpoint.row_id << "\n";
+        for (auto size : checkpoint.file_sizes) {
+            output << "file_size=" << size << "\n";
+        }
+        output.close();
+        if (output.fail()) {
+            throw std::runtime_error(
+                    "failed to write checkpoint file=" + temporary_path);
+        }
+    }
+    sync_file(temporary_path);
+
+#ifndef RTI_WIN32
+    if (std::rename(temporary_path.c_str(), path_.c_str()) != 0) {
+        throw std::runtime_error(
+                "failed to replace checkpoint file=" + path_);
+    }
+    // the rename is durable once the directory is synchronized
+    size_t separator = path_.find_last_of('/');
+    std::string directory_path = separator == std::string::npos
+            ? std::string(".")
+            : path_.substr(0, separator + 1);
+    int descriptor = open(directory_path.c_str(), O_RDONLY);
+    if (descriptor >= 0) {
+        fsync(descriptor);
+        close(descriptor);
+    }
+#else
+    if (!MoveFileExA(
+            temporary_path.c_str(),
+            path_.c_str(),
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw std::runtime_error(
+                "failed to replace checkpoint file=" + path_);
+    }
+#endif
+}
+
+void CheckpointFile::remove() const
+{
+    std::remove(path_.c_str());
+}
+
+/*
+ * --- File operations --------------------------------------------------------
+ */
+
+void sync_file(const std::string& path)
+{
+#ifndef RTI_WIN32
+    int descriptor = open(path.c_str(), O_WRONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("failed to open file=" + path);
+    }
+    int result = fsync(descriptor);
+    close(descriptor);
+#else
+    int descriptor = _open(path.c_str(), _O_WRONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("failed to open file=" + path);
+    }
+    int result = _commit(descriptor);
+    _close(descriptor);
+#endif
+    if (result != 0) {
+        throw std::runtime_error("failed to synchronize file=" + path);
+    }
+}
+
+void resume_file(
+        std::ofstream& output,
+        const std::string& path,
+        uint64_t size,
+        std::ios::openmode mode)
+{
+#ifndef RTI_WIN32
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) != 0
+            || static_cast<uint64_t>(file_stat.st_size) < size) {
+        throw std::runtime_error(
+                "file=" + path + " is shorter than its checkpoint");
+    }
+    // the content after the checkpoint may have partial rows
+    if (truncate(path.c_str(), static_cast<off_t>(size)) != 0) {
+        throw std::runtime_error("failed to truncate file=" + path);
+    }
+#else
+    int descriptor = _open(path.c_str(), _O_WRONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("failed to open file=" + path);
+    }
+    bool is_truncated = static_cast<uint64_t>(_filelengthi64(descriptor)) >= size
+            && _chsize_s(descriptor, static_cast<__int64>(size)) == 0;
+    _close(descriptor);
+    if (!is_truncated) {
+        throw std::runtime_error(
+                "file=" + path + " is shorter than its checkpoint");
+    }
+#endif
+
+    // in and out open the file without truncating it
+    output.open(path.c_str(), std::ios::in | std::ios::out | mode);
+    if (!output.good()) {
+        throw std::runtime_error("failed to open file=" + path);
+    }
+    output.seekp(0, std::ios::end);
+}
+
+} } }
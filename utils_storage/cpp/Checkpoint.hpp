@@ -0,0 +1,116 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_CHECKPOINT_HPP_
+#define RTI_RECORDER_UTILS_CHECKPOINT_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * This file has no dependencies on RTI Connext so it can be used by the
+ * standalone tools.
+ */
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Progress of the conversion of a stream: the samples received and
+ * the content of its output files at a row boundary.
+ */
+struct StreamCheckpoint {
+    StreamCheckpoint();
+
+    // reception timestamp of the last sample received
+    int64_t timestamp;
+    // samples received with that timestamp
+    uint64_t timestamp_sample_count;
+    // identifier of the next row, for the formats that number their rows
+    uint64_t row_id;
+    // sizes of the output files of the stream, in bytes
+    std::vector<uint64_t> file_sizes;
+};
+
+/**
+ * @brief File with the last StreamCheckpoint of a stream.
+ *
+ * The file is replaced atomically: the checkpoint is written into a
+ * temporary file that is flushed to the storage device and renamed. After
+ * a crash, the file has either the previous or the new checkpoint.
+ *
+ * Operations throw std::runtime_error on failure.
+ */
+class CheckpointFile {
+public:
+    explicit CheckpointFile(const std::string& path);
+
+    const std::string& path() const;
+
+    /**
+     * @brief Reads the checkpoint
+     *
+     * @return false if there is no checkpoint file
+     */
+    bool read(StreamCheckpoint& checkpoint) const;
+
+    /**
+     * @brief Replaces the checkpoint. The output files must have been
+     * synchronized before.
+     *
+     * @see sync_file
+     */
+    void write(const StreamCheckpoint& checkpoint) const;
+
+    /**
+     * @brief Removes the checkpoint file, if any
+     */
+    void remove() const;
+
+    /**
+     * @brief Returns the extension appended to the path of the first output
+     * file of a stream to name its checkpoint file.
+     *
+     * Value: .checkpoint
+     */
+    static const std::string& FILE_EXTENSION();
+
+private:
+    std::string path_;
+};
+
+/**
+ * @brief Flushes the content of a file to the storage device
+ */
+void sync_file(const std::string& path);
+
+/**
+ * @brief Reopens an output file to continue it from a checkpoint. The
+ * content after the specified size is discarded and the output position is
+ * placed at the end.
+ *
+ * @param[in] output Stream to open
+ * @param[in] path Path of the output file. It must have at least size
+ *                 bytes.
+ * @param[in] size Size of the file at the checkpoint
+ * @param[in] mode Additional open mode flags, e.g. std::ios::binary
+ */
+void resume_file(
+        std::ofstream& output,
+        const std::string& path,
+        uint64_t size,
+        std::ios::openmode mode = std::ios::openmode());
+
+} } }
+
+#endif
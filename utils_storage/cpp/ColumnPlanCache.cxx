@@ -0,0 +1,168 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include "ColumnPlanCache.hpp"
+#include "Tracer.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+ColumnPlanCache::PlanEntry::PlanEntry(
+        const dds::core::xtypes::DynamicType& type,
+        const ColumnProjection& projection) :
+    type(type),
+    projection(projection),
+    is_started(false),
+    plan(promise.get_future().share())
+{
+}
+
+ColumnPlanCache::ColumnPlanCache(
+        const PrintFormatCsvProperty& property,
+        uint32_t thread_count) :
+    property_(property),
+    size_(0),
+    memory_size_(0),
+    is_stopped_(false)
+{
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads_.push_back(std::thread(&ColumnPlanCache::run_builds, this));
+    }
+}
+
+ColumnPlanCache::~ColumnPlanCache()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        is_stopped_ = true;
+        builds_.clear();
+    }
+    build_condition_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+ColumnPlanCache::PlanEntryPtr ColumnPlanCache::entry(
+        const dds::core::xtypes::DynamicType& type,
+        const ColumnProjection& projection,
+        bool& is_new)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    std::vector<PlanEntryPtr>& candidates = plans_[type.name()];
+    for (auto& candidate : candidates) {
+        if (candidate->projection.patterns() == projection.patterns()
+                && candidate->type == type) {
+            is_new = false;
+            return candidate;
+        }
+    }
+
+    candidates.push_back(std::make_shared<PlanEntry>(type, projection));
+    ++size_;
+    is_new = true;
+
+    return candidates.back();
+}
+
+void ColumnPlanCache::build(PlanEntry& entry)
+{
+    if (entry.is_started.exchange(true)) {
+        return;
+    }
+
+    // the lock is not held, so different plans are built in parallel
+    TraceScope trace_scope("column_plan_build");
+    try {
+        ColumnPlanPtr plan = std::make_shared<const PrintFormatCsv::ColumnPlan>(
+                entry.type,
+                property_,
+                entry.projection);
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            memory_size_ += plan->memory_size();
+        }
+        entry.promise.set_value(plan);
+    } catch (...) {
+        entry.promise.set_exception(std::current_exception());
+    }
+}
+
+void ColumnPlanCache::run_builds()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        build_condition_.wait(lock, [this]() {
+            return is_stopped_ || !builds_.empty();
+        });
+        if (is_stopped_) {
+            return;
+        }
+
+        PlanEntryPtr entry = builds_.front();
+        builds_.pop_front();
+        lock.unlock();
+        build(*entry);
+        lock.lock();
+    }
+}
+
+ColumnPlanCache::ColumnPlanPtr ColumnPlanCache::plan(
+        const dds::core::xtypes::DynamicType& type,
+        const ColumnProjection& projection)
+{
+    bool is_new = false;
+    PlanEntryPtr found = entry(type, projection, is_new);
+    // a queued build that didn't start yet is done by this thread
+    build(*found);
+
+    return found->plan.get();
+}
+
+void ColumnPlanCache::prefetch(
+        const dds::core::xtypes::DynamicType& type,
+        const ColumnProjection& projection)
+{
+    if (threads_.empty()) {
+        return;
+    }
+
+    bool is_new = false;
+    PlanEntryPtr found = entry(type, projection, is_new);
+    if (!is_new) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        builds_.push_back(found);
+    }
+    build_condition_.notify_one();
+}
+
+size_t ColumnPlanCache::size() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return size_;
+}
+
+uint64_t ColumnPlanCache::memory_size() const
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return memory_size_;
+}
+
+uint32_t ColumnPlanCache::thread_count() const
+{
+    return static_cast<uint32_t>(threads_.size());
+}
+
+} } }
@@ -0,0 +1,158 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_COLUMNPLANCACHE_HPP_
+#define RTI_RECORDER_UTILS_COLUMNPLANCACHE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "PrintFormatCsv.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Cache of the column plans of the types of the recorded streams.
+ *
+ * Building the ColumnInfo tree and the type header of a large type is
+ * expensive, and many streams usually share the same type. The cache
+ * builds the plan of a type once and returns the same immutable plan for
+ * all the streams of an equal type.
+ *
+ * Plans are looked up by type name, and types with the same name are
+ * compared structurally, so different types registered with the same name
+ * get different plans. Plans of the same type with different projections
+ * are different plans as well.
+ *
+ * Plans are built outside of the cache lock, so plans of different types
+ * are built in parallel by the threads that request them. With build
+ * threads, prefetch() also queues the build of a plan in the background,
+ * and plan() only waits for it if it's in progress.
+ *
+ * All the plans of a cache are built with the same PrintFormatCsvProperty.
+ * Operations are thread-safe.
+ */
+class ColumnPlanCache {
+public:
+    typedef std::shared_ptr<const PrintFormatCsv::ColumnPlan> ColumnPlanPtr;
+
+    /**
+     * @brief Creates an empty cache
+     *
+     * @param[in] property Configuration elements used to build the plans.
+     *                     It must outlive this object.
+     * @param[in] thread_count Number of threads that build the plans
+     *                         requested with prefetch(). With 0, plans are
+     *                         only built by plan().
+     */
+    explicit ColumnPlanCache(
+            const PrintFormatCsvProperty& property,
+            uint32_t thread_count = 0);
+
+    /**
+     * @brief Stops the build threads. The queued builds are discarded.
+     */
+    ~ColumnPlanCache();
+
+    /**
+     * @brief Returns the plan of the specified type, which is built if the
+     * cache has no plan for an equal type and projection. If the plan is
+     * being built by another thread, waits for it.
+     *
+     * @param[in] type Type of the samples
+     * @param[in] projection Selected columns. Patterns are compared
+     *                       textually.
+     *
+     * Throws the exception of the build of the plan, if it failed.
+     */
+    ColumnPlanPtr plan(
+            const dds::core::xtypes::DynamicType& type,
+            const ColumnProjection& projection = ColumnProjection());
+
+    /**
+     * @brief Queues the build of the plan of the specified type in the
+     * build threads, if the cache has no plan for an equal type and
+     * projection. Does nothing without build threads.
+     *
+     * @see plan
+     */
+    void prefetch(
+            const dds::core::xtypes::DynamicType& type,
+            const ColumnProjection& projection = ColumnProjection());
+
+    /**
+     * @brief Returns the number of plans in the cache, including the ones
+     * that are being built.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the bytes of all the plans built so far
+     *
+     * @see PrintFormatCsv::ColumnPlan::memory_size
+     */
+    uint64_t memory_size() const;
+
+    /**
+     * @brief Returns the number of build threads
+     */
+    uint32_t thread_count() const;
+
+private:
+    // plan of a type and projection, built by a single thread
+    struct PlanEntry {
+        PlanEntry(
+                const dds::core::xtypes::DynamicType& type,
+                const ColumnProjection& projection);
+
+        dds::core::xtypes::DynamicType type;
+        ColumnProjection projection;
+        // set by the thread that builds the plan
+        std::atomic<bool> is_started;
+        std::promise<ColumnPlanPtr> promise;
+        std::shared_future<ColumnPlanPtr> plan;
+    };
+    typedef std::shared_ptr<PlanEntry> PlanEntryPtr;
+
+    // returns the entry of the type and projection, adding it if needed
+    PlanEntryPtr entry(
+            const dds::core::xtypes::DynamicType& type,
+            const ColumnProjection& projection,
+            bool& is_new);
+    // builds the plan of an entry, unless another thread started it
+    void build(PlanEntry& entry);
+    void run_builds();
+
+    const PrintFormatCsvProperty& property_;
+    mutable std::mutex mutex_;
+    // plans of the types with the same name
+    std::unordered_map<std::string, std::vector<PlanEntryPtr> > plans_;
+    size_t size_;
+    uint64_t memory_size_;
+    // queued builds of the build threads
+    std::deque<PlanEntryPtr> builds_;
+    std::condition_variable build_condition_;
+    bool is_stopped_;
+    std::vector<std::thread> threads_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "ColumnProjection.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * Parses a range wildcard "[first..last]" at the beginning of the pattern.
+ * Returns the position after the wildcard or NULL if it's not a range.
+ */
+static const char* parse_range(const char *pattern, unsigned long& first, unsigned long& last)
+{
+    if (*pattern != '[') {
+        return NULL;
+    }
+    char *end = NULL;
+    first = std::strtoul(pattern + 1, &end, 10);
+    if (end == pattern + 1 || std::strncmp(end, "..", 2) != 0) {
+        return NULL;
+    }
+    const char *last_begin = end + 2;
+    last = std::strtoul(last_begin, &end, 10);
+    if (end == last_begin || *end != ']') {
+        return NULL;
+    }
+
+    return end + 1;
+}
+
+ColumnProjection::ColumnProjection()
+{
+}
+
+ColumnProjection::ColumnProjection(const std::string& patterns) :
+    patterns_(patterns)
+{
+    size_t begin = 0;
+    while (begin <= patterns.length()) {
+        size_t end = patterns.find(',', begin);
+        if (end == std::string::npos) {
+            end = patterns.length();
+        }
+        // surrounding spaces are ignored
+        size_t first = patterns.find_first_not_of(" \t", begin);
+        size_t last = patterns.find_last_not_of(" \t", end - 1);
+        if (first != std::string::npos && first < end && last >= first) {
+            std::string pattern = patterns.substr(first, last - first + 1);
+            for (size_t i = 0; i < pattern.length(); i++) {
+                unsigned long range_first = 0;
+                unsigned long range_last = 0;
+                if (pattern[i] == '['
+                        && pattern.find("..", i) < pattern.find(']', i)
+                        && (parse_range(pattern.c_str() + i, range_first, range_last) == NULL
+                                || range_first > range_last)) {
+                    throw std::runtime_error(
+                            "invalid element range in column pattern=" + pattern);
+                }
+            }
+            pattern_list_.push_back(pattern);
+        }
+        begin = end + 1;
+    }
+}
+
+bool ColumnProjection::selects_all() const
+{
+    return pattern_list_.empty();
+}
+
+bool ColumnProjection::matches(const std::string& column_name) const
+{
+    if (pattern_list_.empty()) {
+        return true;
+    }
+
+    for (auto& pattern : pattern_list_) {
+        // the pattern may match the column or any of its enclosing members
+        std::string prefix;
+        for (size_t i = 0; i <= column_name.length(); i++) {
+            if (i == column_name.length()
+                    || (i > 0 && (column_name[i] == '.' || column_name[i] == '['))) {
+                prefix.assign(column_name, 0, i);
+                if (match(pattern.c_str(), prefix.c_str())) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+const std::string& ColumnProjection::patterns() const
+{
+    return patterns_;
+}
+
+bool ColumnProjection::match(const char *pattern, const char *name)
+{
+    while (*pattern != '\0') {
+        unsigned long first = 0;
+        unsigned long last = 0;
+        const char *range_end = NULL;
+
+        if (*pattern == '*') {
+            // try all the possible lengths of the sequence
+            for (const char *rest = name; ; ++rest) {
+                if (match(pattern + 1, rest)) {
+                    return true;
+                }
+                if (*rest == '\0') {
+                    return false;
+                }
+            }
+        } else if ((range_end = parse_range(pattern, first, last)) != NULL) {
+            if (*name != '[') {
+                return false;
+            }
+            char *index_end = NULL;
+            unsigned long index = std::strtoul(name + 1, &index_end, 10);
+            if (index_end == name + 1 || *index_end != ']'
+                    || index < first || index > last) {
+                return false;
+            }
+            pattern = range_end;
+            name = index_end + 1;
+        } else if (*name != '\0' && (*pattern == '?' || *pattern == *name)) {
+            ++pattern;
+            ++name;
+        } else {
+            return false;
+        }
+    }
+
+    return *name == '\0';
+}
+
+} } }
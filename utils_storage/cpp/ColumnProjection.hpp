@@ -0,0 +1,79 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_COLUMNPROJECTION_HPP_
+#define RTI_RECORDER_UTILS_COLUMNPROJECTION_HPP_
+
+#include <string>
+#include <vector>
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Selection of the columns of a type, as a list of patterns over the
+ * column names of the CSV type header, e.g. ".pose.position.x".
+ *
+ * Patterns support the following wildcards:
+ *
+ * - \p * matches any sequence of characters, including none.
+ * - \p ? matches any single character.
+ * - \p [first..last] matches an element index between first and last,
+ *   both included, e.g. ".m_array[0..9]".
+ *
+ * A pattern selects the columns whose name it matches, and also all the
+ * columns under a member whose name it matches: ".pose" selects
+ * ".pose.position.x".
+ *
+ * A projection without patterns selects all the columns.
+ */
+class ColumnProjection {
+public:
+    /**
+     * @brief Creates a projection that selects all the columns
+     */
+    ColumnProjection();
+
+    /**
+     * @brief Creates a projection from a comma-separated list of patterns
+     *
+     * Throws std::runtime_error if a pattern is not valid.
+     */
+    explicit ColumnProjection(const std::string& patterns);
+
+    /**
+     * @brief Returns whether this projection selects all the columns
+     */
+    bool selects_all() const;
+
+    /**
+     * @brief Returns whether the column with the specified name is selected
+     */
+    bool matches(const std::string& column_name) const;
+
+    /**
+     * @brief Returns the patterns as specified on construction
+     */
+    const std::string& patterns() const;
+
+    /**
+     * @brief Returns whether the pattern matches the whole name
+     */
+    static bool match(const char *pattern, const char *name);
+
+private:
+    std::string patterns_;
+    std::vector<std::string> pattern_list_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,337 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ColumnStatistics.hpp"
+#include "FastFormat.hpp"
+
+using namespace dds::core::xtypes;
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * Computes the minimum, maximum, mean and sum of squared differences from
+ * the mean of a non-empty array of values. Each loop keeps four independent
+ * partial results, so compilers can vectorize it without reordering the
+ * floating point operations.
+ */
+static void reduce_values(
+        const double *values,
+        size_t count,
+        double& minimum,
+        double& maximum,
+        double& mean,
+        double& squared_deviation)
+{
+    const size_t LANE_COUNT = 4;
+    double lane_minimums[LANE_COUNT];
+    double lane_maximums[LANE_COUNT];
+    double lane_sums[LANE_COUNT];
+    for (size_t lane = 0; lane < LANE_COUNT; lane++) {
+        lane_minimums[lane] = values[0];
+        lane_maximums[lane] = values[0];
+        lane_sums[lane] = 0;
+    }
+
+    size_t i = 0;
+    for (; i + LANE_COUNT <= count; i += LANE_COUNT) {
+        for (size_t lane = 0; lane < LANE_COUNT; lane++) {
+            double value = values[i + lane];
+            lane_minimums[lane] = value < lane_minimums[lane]
+                    ? value
+                    : lane_minimums[lane];
+            lane_maximums[lane] = value > lane_maximums[lane]
+                    ? value
+                    : lane_maximums[lane];
+            lane_sums[lane] += value;
+        }
+    }
+    for (; i < count; i++) {
+        lane_minimums[0] = values[i] < lane_minimums[0]
+                ? values[i]
+                : lane_minimums[0];
+        lane_maximums[0] = values[i] > lane_maximums[0]
+                ? values[i]
+                : lane_maximums[0];
+        lane_sums[0] += values[i];
+    }
+
+    minimum = lane_minimums[0];
+    maximum = lane_maximums[0];
+    double sum = lane_sums[0];
+    for (size_t lane = 1; lane < LANE_COUNT; lane++) {
+        minimum = lane_minimums[lane] < minimum ? lane_minimums[lane] : minimum;
+        maximum = lane_maximums[lane] > maximum ? lane_maximums[lane] : maximum;
+        sum += lane_sums[lane];
+    }
+    mean = sum / count;
+
+    // second pass around the mean, more accurate than the sum of squares
+    double lane_deviations[LANE_COUNT] = {};
+    i = 0;
+    for (; i + LANE_COUNT <= count; i += LANE_COUNT) {
+        for (size_t lane = 0; lane < LANE_COUNT; lane++) {
+            double deviation = values[i + lane] - mean;
+            lane_deviations[lane] += deviation * deviation;
+        }
+    }
+    for (; i < count; i++) {
+        double deviation = values[i] - mean;
+        lane_deviations[0] += deviation * deviation;
+    }
+    squared_deviation = 0;
+    for (size_t lane = 0; lane < LANE_COUNT; lane++) {
+        squared_deviation += lane_deviations[lane];
+    }
+}
+
+ColumnStatistics::ColumnStatistics(const ColumnInfo& column_info)
+    : column_reader_(column_info),
+      batch_row_count_(0),
+      column_index_(0),
+      row_count_(0)
+{
+    // metadata column
+    names_.push_back("timestamp");
+    is_numeric_.push_back(true);
+    is_unsigned_.push_back(false);
+    is_real_.push_back(false);
+    add_columns(column_info);
+
+    size_t column_count = names_.size();
+    counts_.resize(column_count, 0);
+    null_counts_.resize(column_count, 0);
+    minimums_.resize(column_count, 0);
+    maximums_.resize(column_count, 0);
+    integer_minimums_.resize(column_count, 0);
+    integer_maximums_.resize(column_count, 0);
+    unsigned_minimums_.resize(column_count, 0);
+    unsigned_maximums_.resize(column_count, 0);
+    means_.resize(column_count, 0);
+    squared_deviations_.resize(column_count, 0);
+    batch_values_.resize(column_count * BATCH_ROW_COUNT(), 0);
+    batch_counts_.resize(column_count, 0);
+}
+
+size_t ColumnStatistics::BATCH_ROW_COUNT()
+{
+    return 1024;
+}
+
+void ColumnStatistics::add_columns(const ColumnInfo& info)
+{
+    if (DataColumnReader::is_leaf(info)) {
+        names_.push_back(info.path());
+        switch (info.type_kind().underlying()) {
+        case TypeKind::BOOLEAN_TYPE:
+        case TypeKind::UINT_8_TYPE:
+        case TypeKind::INT_16_TYPE:
+        case TypeKind::UINT_16_TYPE:
+        case TypeKind::INT_32_TYPE:
+        case TypeKind::UINT_32_TYPE:
+        case TypeKind::INT_64_TYPE:
+        case TypeKind::UINT_64_TYPE:
+        case TypeKind::FLOAT_32_TYPE:
+        case TypeKind::FLOAT_64_TYPE:
+            is_numeric_.push_back(true);
+            break;
+
+        default:
+            is_numeric_.push_back(false);
+            break;
+        }
+        is_unsigned_.push_back(info.type_kind() == TypeKind::UINT_64_TYPE);
+        is_real_.push_back(
+                info.type_kind() == TypeKind::FLOAT_32_TYPE
+                || info.type_kind() == TypeKind::FLOAT_64_TYPE);
+        return;
+    }
+
+    for (auto& child : info.children()) {
+        if (!child.is_element_template()) {
+            add_columns(child);
+        }
+    }
+}
+
+void ColumnStatistics::add(DynamicData& sample, int64_t timestamp)
+{
+    column_index_ = 0;
+    stage_integer(timestamp);
+    column_reader_.read(sample, *this);
+
+    ++row_count_;
+    if (++batch_row_count_ == BATCH_ROW_COUNT()) {
+        reduce();
+    }
+}
+
+uint64_t ColumnStatistics::row_count() const
+{
+    return row_count_;
+}
+
+void ColumnStatistics::stage(double value)
+{
+    uint32_t& batch_count = batch_counts_[column_index_];
+    if (is_numeric_[column_index_]) {
+        batch_values_[column_index_ * BATCH_ROW_COUNT() + batch_count] = value;
+    }
+    ++batch_count;
+    ++column_index_;
+}
+
+bool ColumnStatistics::is_first_value(size_t column) const
+{
+    return counts_[column] == 0 && batch_counts_[column] == 0;
+}
+
+void ColumnStatistics::stage_integer(int64_t value)
+{
+    if (is_first_value(column_index_)) {
+        integer_minimums_[column_index_] = value;
+        integer_maximums_[column_index_] = value;
+    } else {
+        integer_minimums_[column_index_] =
+                std::min(integer_minimums_[column_index_], value);
+        integer_maximums_[column_index_] =
+                std::max(integer_maximums_[column_index_], value);
+    }
+    stage(static_cast<double>(value));
+}
+
+void ColumnStatistics::stage_unsigned(uint64_t value)
+{
+    if (is_first_value(column_index_)) {
+        unsigned_minimums_[column_index_] = value;
+        unsigned_maximums_[column_index_] = value;
+    } else {
+        unsigned_minimums_[column_index_] =
+                std::min(unsigned_minimums_[column_index_], value);
+        unsigned_maximums_[column_index_] =
+                std::max(unsigned_maximums_[column_index_], value);
+    }
+    stage(static_cast<double>(value));
+}
+
+void ColumnStatistics::value(
+        const ColumnInfo&,
+        const DataColumnReader::Value& value)
+{
+    if (is_real_[column_index_]) {
+        stage(value.real_value());
+    } else if (is_unsigned_[column_index_]) {
+        stage_unsigned(value.unsigned_value());
+    } else {
+        stage_integer(value.integer_value());
+    }
+}
+
+void ColumnStatistics::empty(const ColumnInfo&)
+{
+    // counted as null when the batch is reduced
+    ++column_index_;
+}
+
+void ColumnStatistics::reduce()
+{
+    for (size_t column = 0; column < names_.size(); column++) {
+        uint32_t batch_count = batch_counts_[column];
+        null_counts_[column] += batch_row_count_ - batch_count;
+        if (batch_count == 0) {
+            continue;
+        }
+        batch_counts_[column] = 0;
+        if (!is_numeric_[column]) {
+            counts_[column] += batch_count;
+            continue;
+        }
+
+        double minimum = 0;
+        double maximum = 0;
+        double mean = 0;
+        double squared_deviation = 0;
+        reduce_values(
+                &batch_values_[column * BATCH_ROW_COUNT()],
+                batch_count,
+                minimum,
+                maximum,
+                mean,
+                squared_deviation);
+
+        // merge with the previous batches (Chan et al.)
+        uint64_t count = counts_[column];
+        uint64_t total_count = count + batch_count;
+        if (count == 0) {
+            minimums_[column] = minimum;
+            maximums_[column] = maximum;
+            means_[column] = mean;
+            squared_deviations_[column] = squared_deviation;
+        } else {
+            double delta = mean - means_[column];
+            minimums_[column] = std::fmin(minimums_[column], minimum);
+            maximums_[column] = std::fmax(maximums_[column], maximum);
+            means_[column] += delta * batch_count / total_count;
+            squared_deviations_[column] += squared_deviation
+                    + delta * delta
+                            * (static_cast<double>(count) * batch_count
+                                    / total_count);
+        }
+        counts_[column] = total_count;
+    }
+    batch_row_count_ = 0;
+}
+
+void ColumnStatistics::write(std::ostream& output)
+{
+    reduce();
+
+    std::string text = "column,count,null_count,min,max,mean,stddev\n";
+    for (size_t column = 0; column < names_.size(); column++) {
+        text += names_[column];
+        text += ',';
+        append_unsigned(text, counts_[column]);
+        text += ',';
+        append_unsigned(text, null_counts_[column]);
+        if (!is_numeric_[column] || counts_[column] == 0) {
+            text += ",,,,\n";
+            continue;
+        }
+
+        text += ',';
+        if (is_real_[column]) {
+            append_real(text, minimums_[column]);
+            text += ',';
+            append_real(text, maximums_[column]);
+        } else if (is_unsigned_[column]) {
+            append_unsigned(text, unsigned_minimums_[column]);
+            text += ',';
+            append_unsigned(text, unsigned_maximums_[column]);
+        } else {
+            append_integer(text, integer_minimums_[column]);
+            text += ',';
+            append_integer(text, integer_maximums_[column]);
+        }
+        text += ',';
+        append_real(text, means_[column]);
+        text += ',';
+        append_real(
+                text,
+                std::sqrt(squared_deviations_[column] / counts_[column]));
+        text += '\n';
+    }
+    output << text;
+}
+
+} } }
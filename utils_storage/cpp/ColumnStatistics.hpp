@@ -0,0 +1,129 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_COLUMNSTATISTICS_HPP_
+#define RTI_RECORDER_UTILS_COLUMNSTATISTICS_HPP_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "DataColumnReader.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Running statistics of the leaf columns of a stream.
+ *
+ * For each column of the CSV type header, plus the timestamp column, it
+ * keeps the number of values and of nulls (columns not present in a
+ * sample). Numeric columns (booleans, integers and floating point numbers)
+ * also keep their minimum, maximum, mean and standard deviation.
+ *
+ * Values are read with a DataColumnReader and staged per column in batches
+ * of BATCH_ROW_COUNT() rows. Each full batch is reduced one column at a time
+ * over contiguous values, with independent partial results that compilers
+ * can vectorize, and merged into the running statistics. The statistics are
+ * stored as one array per statistic, indexed by column.
+ *
+ * The minimum and maximum of the integer columns, including the timestamp,
+ * are kept exactly as they're staged, since not all 64-bit integers can be
+ * represented as a double.
+ */
+class ColumnStatistics : private DataColumnReader::Visitor {
+public:
+    typedef PrintFormatCsv::ColumnInfo ColumnInfo;
+
+    /**
+     * @brief Creates the statistics of the columns of the specified tree
+     *
+     * @param[in] column_info Root of the tree. It must outlive this object.
+     */
+    explicit ColumnStatistics(const ColumnInfo& column_info);
+
+    /**
+     * @brief Adds the values of a sample received at the specified time
+     */
+    void add(dds::core::xtypes::DynamicData& sample, int64_t timestamp);
+
+    /**
+     * @brief Returns the number of samples added
+     */
+    uint64_t row_count() const;
+
+    /**
+     * @brief Writes the statistics in CSV format, one row per column:
+     *
+     *     column,count,null_count,min,max,mean,stddev
+     *
+     * The last four are empty for non-numeric columns and columns without
+     * values. The standard deviation is the population one.
+     */
+    void write(std::ostream& output);
+
+    /**
+     * @brief Returns the number of rows staged before they are reduced.
+     *
+     * Value: 1024
+     */
+    static size_t BATCH_ROW_COUNT();
+
+private:
+    void add_columns(const ColumnInfo& info);
+
+    void stage(double value);
+
+    void stage_integer(int64_t value);
+
+    void stage_unsigned(uint64_t value);
+
+    bool is_first_value(size_t column) const;
+
+    void value(
+            const ColumnInfo& info,
+            const DataColumnReader::Value& value) override;
+    void empty(const ColumnInfo& info) override;
+
+    void reduce();
+
+    DataColumnReader column_reader_;
+    // description of each column
+    std::vector<std::string> names_;
+    std::vector<char> is_numeric_;
+    std::vector<char> is_unsigned_;
+    std::vector<char> is_real_;
+    // running statistics of each column
+    std::vector<uint64_t> counts_;
+    std::vector<uint64_t> null_counts_;
+    // extremes of the floating point columns
+    std::vector<double> minimums_;
+    std::vector<double> maximums_;
+    // extremes of the signed and unsigned integer columns
+    std::vector<int64_t> integer_minimums_;
+    std::vector<int64_t> integer_maximums_;
+    std::vector<uint64_t> unsigned_minimums_;
+    std::vector<uint64_t> unsigned_maximums_;
+    std::vector<double> means_;
+    // sum of squared differences from the mean
+    std::vector<double> squared_deviations_;
+    // values of the current batch, BATCH_ROW_COUNT() per column. Only the
+    // present values of numeric columns are stored, at the beginning.
+    std::vector<double> batch_values_;
+    std::vector<uint32_t> batch_counts_;
+    uint32_t batch_row_count_;
+    size_t column_index_;
+    uint64_t row_count_;
+};
+
+} } }
+
+#endif
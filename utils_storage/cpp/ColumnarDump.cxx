@@ -0,0 +1,95 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/*
+ * Command-line tool that prints the content of a file generated with the
+ * columnar output format, either its schema or its rows in CSV format.
+ *
+ * Usage: utilsstorage_columnar_dump [--schema] <file>
+ */
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "ColumnarFormat.hpp"
+#include "FileContent.hpp"
+
+using namespace rti::recorder::utils;
+
+void print_schema(const columnar::FileReader& reader)
+{
+    std::cout << "Topic name: " << reader.metadata("topic_name") << "\n";
+    std::cout << "Type name: " << reader.metadata("type_name") << "\n";
+    uint64_t row_count = 0;
+    for (uint64_t i = 0; i < reader.chunk_count(); i++) {
+        row_count += reader.row_count(i);
+    }
+    std::cout << "Rows: " << row_count
+            << " in " << reader.chunk_count() << " chunks\n";
+    for (auto& column : reader.columns()) {
+        std::cout << column.name << ": "
+                << columnar::type_name(column.type_code) << "\n";
+    }
+}
+
+void print_rows(const columnar::FileReader& reader)
+{
+    const std::vector<columnar::ColumnDescriptor>& columns = reader.columns();
+    for (uint32_t i = 0; i < columns.size(); i++) {
+        std::cout << (i == 0 ? "" : ",") << columns[i].name;
+    }
+    std::cout << "\n";
+
+    for (uint64_t chunk = 0; chunk < reader.chunk_count(); chunk++) {
+        for (uint64_t row = 0; row < reader.row_count(chunk); row++) {
+            for (uint32_t i = 0; i < columns.size(); i++) {
+                std::cout << (i == 0 ? "" : ",")
+                        << reader.to_string(chunk, i, row);
+            }
+            std::cout << "\n";
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool schema_only = false;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--schema") == 0) {
+            schema_only = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == NULL) {
+        std::cerr << "Usage: " << argv[0] << " [--schema] <file>" << std::endl;
+        return 1;
+    }
+
+    try {
+        FileContent content(path);
+        columnar::FileReader reader(content.data(), content.size());
+        if (schema_only) {
+            print_schema(reader);
+        } else {
+            print_rows(reader);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
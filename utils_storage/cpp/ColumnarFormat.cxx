@@ -0,0 +1,652 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "ColumnarFormat.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * --- ColumnarFormatProperty -------------------------------------------------
+ */
+
+ColumnarFormatProperty::ColumnarFormatProperty() :
+    rows_per_chunk_(4096)
+{
+}
+
+ColumnarFormatProperty& ColumnarFormatProperty::rows_per_chunk(uint32_t count)
+{
+    rows_per_chunk_ = count;
+
+    return *this;
+}
+
+uint32_t ColumnarFormatProperty::rows_per_chunk() const
+{
+    return rows_per_chunk_;
+}
+
+namespace columnar {
+
+/*
+ * --- Layout helpers ---------------------------------------------------------
+ */
+
+uint32_t type_width(TypeCode code)
+{
+    switch (code) {
+    case TypeCode::BOOLEAN:
+    case TypeCode::CHAR8:
+    case TypeCode::UINT8:
+        return 1;
+
+    case TypeCode::INT16:
+    case TypeCode::UINT16:
+    case TypeCode::CHAR16:
+        return 2;
+
+    case TypeCode::INT32:
+    case TypeCode::UINT32:
+    case TypeCode::FLOAT32:
+    case TypeCode::ENUM32:
+        return 4;
+
+    case TypeCode::INT64:
+    case TypeCode::UINT64:
+    case TypeCode::FLOAT64:
+    case TypeCode::STRING:
+        return 8;
+
+    default:
+        return 0;
+    }
+}
+
+const char* type_name(TypeCode code)
+{
+    switch (code) {
+    case TypeCode::BOOLEAN: return "boolean";
+    case TypeCode::CHAR8: return "char8";
+    case TypeCode::UINT8: return "uint8";
+    case TypeCode::INT16: return "int16";
+    case TypeCode::UINT16: return "uint16";
+    case TypeCode::INT32: return "int32";
+    case TypeCode::UINT32: return "uint32";
+    case TypeCode::INT64: return "int64";
+    case TypeCode::UINT64: return "uint64";
+    case TypeCode::FLOAT32: return "float32";
+    case TypeCode::FLOAT64: return "float64";
+    case TypeCode::ENUM32: return "enum32";
+    case TypeCode::CHAR16: return "char16";
+    case TypeCode::STRING: return "string";
+    default: return "unsupported";
+    }
+}
+
+const char* MAGIC()
+{
+    static const char value[MAGIC_SIZE] = {
+        'R', 'T', 'I', 'C', 'O', 'L', '1', '\0'
+    };
+    return value;
+}
+
+uint64_t align(uint64_t offset)
+{
+    return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+/*
+ * Whether [offset, offset + length) is within [0, limit), without computing
+ * the sum, which may wrap around with the values of a corrupt file
+ */
+bool is_within(uint64_t offset, uint64_t length, uint64_t limit)
+{
+    return length <= limit && offset <= limit - length;
+}
+
+/*
+ * Helpers to serialize and deserialize the footer
+ */
+template <typename T>
+void put(std::string& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void put_string(std::string& buffer, const std::string& value)
+{
+    put<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+class FooterParser {
+public:
+    FooterParser(const char *data, uint64_t size) :
+        data_(data),
+        size_(size),
+        position_(0)
+    {
+    }
+
+    template <typename T>
+    T get()
+    {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_ + position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+    }
+
+    std::string get_string()
+    {
+        uint32_t length = get<uint32_t>();
+        require(length);
+        std::string value(data_ + position_, length);
+        position_ += length;
+        return value;
+    }
+
+private:
+    void require(uint64_t count)
+    {
+        if (!is_within(position_, count, size_)) {
+            throw std::runtime_error("columnar file footer is truncated");
+        }
+    }
+
+    const char *data_;
+    uint64_t size_;
+    uint64_t position_;
+};
+
+/*
+ * --- FileWriter -------------------------------------------------------------
+ */
+
+FileWriter::FileWriter(std::ostream& output, uint32_t rows_per_chunk) :
+    output_(output),
+    rows_per_chunk_(rows_per_chunk > 0 ? rows_per_chunk : 1),
+    row_count_(0),
+    offset_(0),
+    finished_(false)
+{
+}
+
+uint32_t FileWriter::add_column(const std::string& name, TypeCode type_code)
+{
+    ColumnDescriptor descriptor;
+    descriptor.name = name;
+    descriptor.type_code = type_code;
+    columns_.push_back(descriptor);
+
+    ColumnChunk chunk;
+    chunk.values.resize(
+            static_cast<size_t>(rows_per_chunk_) * type_width(type_code));
+    chunk.validity.resize((rows_per_chunk_ + 7) / 8);
+    chunk_columns_.push_back(std::move(chunk));
+
+    return static_cast<uint32_t>(columns_.size() - 1);
+}
+
+void FileWriter::add_metadata(const std::string& key, const std::string& value)
+{
+    metadata_.push_back(std::make_pair(key, value));
+}
+
+const std::vector<ColumnDescriptor>& FileWriter::columns() const
+{
+    return columns_;
+}
+
+void FileWriter::set_valid(uint32_t column)
+{
+    chunk_columns_[column].validity[row_count_ / 8] |=
+            static_cast<uint8_t>(1 << (row_count_ % 8));
+}
+
+void FileWriter::integer_value(uint32_t column, int64_t value)
+{
+    char *cell = chunk_columns_[column].values.data()
+            + static_cast<size_t>(row_count_)
+            * type_width(columns_[column].type_code);
+
+    switch (columns_[column].type_code) {
+    case TypeCode::BOOLEAN:
+    case TypeCode::CHAR8:
+    case TypeCode::UINT8:
+    {
+        uint8_t narrow_value = static_cast<uint8_t>(value);
+        std::memcpy(cell, &narrow_value, sizeof(narrow_value));
+    }
+        break;
+
+    case TypeCode::INT16:
+    case TypeCode::UINT16:
+    case TypeCode::CHAR16:
+    {
+        uint16_t narrow_value = static_cast<uint16_t>(value);
+        std::memcpy(cell, &narrow_value, sizeof(narrow_value));
+    }
+        break;
+
+    case TypeCode::INT32:
+    case TypeCode::UINT32:
+    case TypeCode::ENUM32:
+    {
+        uint32_t narrow_value = static_cast<uint32_t>(value);
+        std::memcpy(cell, &narrow_value, sizeof(narrow_value));
+    }
+        break;
+
+    case TypeCode::INT64:
+    case TypeCode::UINT64:
+        std::memcpy(cell, &value, sizeof(value));
+        break;
+
+    default:
+        // not an integer column
+        return;
+    }
+
+    set_valid(column);
+}
+
+void FileWriter::real_value(uint32_t column, double value)
+{
+    char *cell = chunk_columns_[column].values.data()
+            + static_cast<size_t>(row_count_)
+            * type_width(columns_[column].type_code);
+
+    switch (columns_[column].type_code) {
+    case TypeCode::FLOAT32:
+    {
+        float narrow_value = static_cast<float>(value);
+        std::memcpy(cell, &narrow_value, sizeof(narrow_value));
+    }
+        break;
+
+    case TypeCode::FLOAT64:
+        std::memcpy(cell, &value, sizeof(value));
+        break;
+
+    default:
+        // not a floating point column
+        return;
+    }
+
+    set_valid(column);
+}
+
+void FileWriter::text_value(uint32_t column, const std::string& value)
+{
+    if (columns_[column].type_code != TypeCode::STRING) {
+        return;
+    }
+
+    uint32_t location[2] = {
+        static_cast<uint32_t>(heap_.size()),
+        static_cast<uint32_t>(value.size())
+    };
+    std::memcpy(
+            chunk_columns_[column].values.data()
+                    + static_cast<size_t>(row_count_) * sizeof(location),
+            location,
+            sizeof(location));
+    heap_.append(value);
+
+    set_valid(column);
+}
+
+void FileWriter::end_row()
+{
+    if (offset_ == 0) {
+        write_header();
+    }
+
+    ++row_count_;
+    if (row_count_ == rows_per_chunk_) {
+        write_chunk();
+    }
+}
+
+void FileWriter::write_section(const char *data, uint64_t size)
+{
+    static const char padding[ALIGNMENT] = {};
+
+    output_.write(data, size);
+    offset_ += size;
+    uint64_t aligned_offset = align(offset_);
+    output_.write(padding, aligned_offset - offset_);
+    offset_ = aligned_offset;
+}
+
+void FileWriter::write_header()
+{
+    char header[ALIGNMENT] = {};
+    uint32_t fields[3] = {
+        VERSION,
+        ENDIANNESS_MARKER,
+        static_cast<uint32_t>(ALIGNMENT)
+    };
+    std::memcpy(header, MAGIC(), MAGIC_SIZE);
+    std::memcpy(header + MAGIC_SIZE, fields, sizeof(fields));
+
+    write_section(header, sizeof(header));
+}
+
+void FileWriter::write_chunk()
+{
+    if (row_count_ == 0) {
+        return;
+    }
+
+    ChunkEntry entry;
+    entry.row_count = row_count_;
+    for (uint32_t i = 0; i < columns_.size(); i++) {
+        ColumnChunk& chunk = chunk_columns_[i];
+        uint64_t values_offset = offset_;
+        write_section(
+                chunk.values.data(),
+                static_cast<uint64_t>(row_count_)
+                        * type_width(columns_[i].type_code));
+        uint64_t validity_offset = offset_;
+        write_section(
+                reinterpret_cast<const char *>(chunk.validity.data()),
+                (row_count_ + 7) / 8);
+        entry.columns.push_back(std::make_pair(values_offset, validity_offset));
+
+        // reset for next chunk
+        std::memset(chunk.values.data(), 0, chunk.values.size());
+        std::memset(chunk.validity.data(), 0, chunk.validity.size());
+    }
+    entry.heap_offset = offset_;
+    entry.heap_size = heap_.size();
+    write_section(heap_.data(), heap_.size());
+    heap_.clear();
+
+    chunks_.push_back(std::move(entry));
+    row_count_ = 0;
+}
+
+void FileWriter::flush_chunk()
+{
+    write_chunk();
+    output_.flush();
+}
+
+uint64_t FileWriter::buffer_size() const
+{
+    uint64_t size = heap_.capacity();
+    for (auto& chunk : chunk_columns_) {
+        size += chunk.values.capacity() + chunk.validity.capacity();
+    }
+
+    return size;
+}
+
+uint64_t FileWriter::size() const
+{
+    return finished_ ? offset_ + TRAILER_SIZE : offset_;
+}
+
+void FileWriter::shrink()
+{
+    if (heap_.empty()) {
+        std::string().swap(heap_);
+    } else {
+        heap_.shrink_to_fit();
+    }
+}
+
+void FileWriter::finish()
+{
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    if (offset_ == 0) {
+        write_header();
+    }
+    write_chunk();
+
+    std::string footer;
+    put<uint32_t>(footer, static_cast<uint32_t>(columns_.size()));
+    for (auto& column : columns_) {
+        put<uint32_t>(footer, static_cast<uint32_t>(column.type_code));
+        put_string(footer, column.name);
+    }
+    put<uint32_t>(footer, static_cast<uint32_t>(metadata_.size()));
+    for (auto& entry : metadata_) {
+        put_string(footer, entry.first);
+        put_string(footer, entry.second);
+    }
+    put<uint64_t>(footer, chunks_.size());
+    for (auto& chunk : chunks_) {
+        put<uint64_t>(footer, chunk.row_count);
+        put<uint64_t>(footer, chunk.heap_offset);
+        put<uint64_t>(footer, chunk.heap_size);
+        for (auto& column : chunk.columns) {
+            put<uint64_t>(footer, column.first);
+            put<uint64_t>(footer, column.second);
+        }
+    }
+
+    uint64_t footer_offset = offset_;
+    write_section(footer.data(), footer.size());
+
+    uint64_t trailer[2] = { footer_offset, footer.size() };
+    output_.write(reinterpret_cast<const char *>(trailer), sizeof(trailer));
+    output_.write(MAGIC(), MAGIC_SIZE);
+    output_.flush();
+}
+
+/*
+ * --- FileReader -------------------------------------------------------------
+ */
+
+FileReader::FileReader(const char *data, uint64_t size) :
+    data_(data),
+    size_(size)
+{
+    if (size_ < ALIGNMENT + TRAILER_SIZE
+            || std::memcmp(data_, MAGIC(), MAGIC_SIZE) != 0
+            || std::memcmp(data_ + size_ - MAGIC_SIZE, MAGIC(), MAGIC_SIZE) != 0) {
+        throw std::runtime_error("not a columnar file");
+    }
+
+    uint32_t fields[3];
+    std::memcpy(fields, data_ + MAGIC_SIZE, sizeof(fields));
+    if (fields[0] != VERSION) {
+        throw std::runtime_error("unsupported columnar file version");
+    }
+    if (fields[1] != ENDIANNESS_MARKER) {
+        throw std::runtime_error(
+                "columnar file was produced on a host with different byte order");
+    }
+
+    uint64_t trailer[2];
+    std::memcpy(trailer, data_ + size_ - TRAILER_SIZE, sizeof(trailer));
+    if (!is_within(trailer[0], trailer[1], size_ - TRAILER_SIZE)) {
+        throw std::runtime_error("invalid columnar file footer location");
+    }
+
+    FooterParser parser(data_ + trailer[0], trailer[1]);
+    uint32_t column_count = parser.get<uint32_t>();
+    for (uint32_t i = 0; i < column_count; i++) {
+        ColumnDescriptor descriptor;
+        descriptor.type_code = static_cast<TypeCode>(parser.get<uint32_t>());
+        descriptor.name = parser.get_string();
+        columns_.push_back(descriptor);
+    }
+    uint32_t metadata_count = parser.get<uint32_t>();
+    for (uint32_t i = 0; i < metadata_count; i++) {
+        std::string key = parser.get_string();
+        metadata_.push_back(std::make_pair(key, parser.get_string()));
+    }
+    uint64_t chunk_count = parser.get<uint64_t>();
+    for (uint64_t i = 0; i < chunk_count; i++) {
+        ChunkEntry entry;
+        entry.row_count = parser.get<uint64_t>();
+        entry.heap_offset = parser.get<uint64_t>();
+        entry.heap_size = parser.get<uint64_t>();
+        for (uint32_t j = 0; j < column_count; j++) {
+            uint64_t values_offset = parser.get<uint64_t>();
+            uint64_t validity_offset = parser.get<uint64_t>();
+            uint64_t width = type_width(columns_[j].type_code);
+            // the product is only computed once it's known not to overflow
+            if ((width != 0 && entry.row_count > size_ / width)
+                    || !is_within(
+                            values_offset,
+                            entry.row_count * width,
+                            size_)
+                    || !is_within(
+                            validity_offset,
+                            entry.row_count / 8 + (entry.row_count % 8 != 0),
+                            size_)) {
+                throw std::runtime_error("invalid columnar chunk location");
+            }
+            entry.columns.push_back(
+                    std::make_pair(values_offset, validity_offset));
+        }
+        if (!is_within(entry.heap_offset, entry.heap_size, size_)) {
+            throw std::runtime_error("invalid columnar string heap location");
+        }
+        chunks_.push_back(std::move(entry));
+    }
+}
+
+const std::vector<ColumnDescriptor>& FileReader::columns() const
+{
+    return columns_;
+}
+
+std::string FileReader::metadata(const std::string& key) const
+{
+    for (auto& entry : metadata_) {
+        if (entry.first == key) {
+            return entry.second;
+        }
+    }
+
+    return std::string();
+}
+
+uint64_t FileReader::chunk_count() const
+{
+    return chunks_.size();
+}
+
+uint64_t FileReader::row_count(uint64_t chunk) const
+{
+    return chunks_[chunk].row_count;
+}
+
+const char* FileReader::values(uint64_t chunk, uint32_t column) const
+{
+    return data_ + chunks_[chunk].columns[column].first;
+}
+
+bool FileReader::is_valid(uint64_t chunk, uint32_t column, uint64_t row) const
+{
+    const uint8_t *validity = reinterpret_cast<const uint8_t *>(
+            data_ + chunks_[chunk].columns[column].second);
+
+    return (validity[row / 8] & (1 << (row % 8))) != 0;
+}
+
+template <typename T>
+T cell_value(const char *values, uint64_t row)
+{
+    T value;
+    std::memcpy(&value, values + row * sizeof(T), sizeof(T));
+    return value;
+}
+
+std::string FileReader::to_string(
+        uint64_t chunk,
+        uint32_t column,
+        uint64_t row) const
+{
+    if (!is_valid(chunk, column, row)) {
+        return std::string();
+    }
+
+    const char *cells = values(chunk, column);
+    std::ostringstream stream;
+    switch (columns_[column].type_code) {
+    case TypeCode::BOOLEAN:
+        stream << (cell_value<uint8_t>(cells, row) ? "true" : "false");
+        break;
+    case TypeCode::CHAR8:
+        stream << cell_value<char>(cells, row);
+        break;
+    case TypeCode::UINT8:
+        stream << static_cast<uint32_t>(cell_value<uint8_t>(cells, row));
+        break;
+    case TypeCode::INT16:
+        stream << cell_value<int16_t>(cells, row);
+        break;
+    case TypeCode::UINT16:
+    case TypeCode::CHAR16:
+        stream << cell_value<uint16_t>(cells, row);
+        break;
+    case TypeCode::INT32:
+    case TypeCode::ENUM32:
+        stream << cell_value<int32_t>(cells, row);
+        break;
+    case TypeCode::UINT32:
+        stream << cell_value<uint32_t>(cells, row);
+        break;
+    case TypeCode::INT64:
+        stream << cell_value<int64_t>(cells, row);
+        break;
+    case TypeCode::UINT64:
+        stream << cell_value<uint64_t>(cells, row);
+        break;
+    case TypeCode::FLOAT32:
+        stream.precision(9);
+        stream << cell_value<float>(cells, row);
+        break;
+    case TypeCode::FLOAT64:
+        stream.precision(17);
+        stream << cell_value<double>(cells, row);
+        break;
+    case TypeCode::STRING:
+    {
+        uint32_t location[2];
+        std::memcpy(location, cells + row * sizeof(location), sizeof(location));
+        if (location[0] + static_cast<uint64_t>(location[1])
+                > chunks_[chunk].heap_size) {
+            throw std::runtime_error("invalid columnar string location");
+        }
+        stream.write(
+                data_ + chunks_[chunk].heap_offset + location[0],
+                location[1]);
+    }
+        break;
+    default:
+        break;
+    }
+
+    return stream.str();
+}
+
+} /* namespace columnar */
+
+} } }
@@ -0,0 +1,276 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_COLUMNARFORMAT_HPP_
+#define RTI_RECORDER_UTILS_COLUMNARFORMAT_HPP_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * This file has no dependencies on RTI Connext so it can be used to build
+ * standalone readers of the columnar files.
+ */
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Configuration elements of the columnar output format
+ */
+class ColumnarFormatProperty {
+public:
+    ColumnarFormatProperty();
+
+    /**
+     * @brief Specifies the maximum number of rows that are buffered in memory
+     * before they are written as a chunk into the output file.
+     *
+     * Default: 4096
+     */
+    ColumnarFormatProperty& rows_per_chunk(uint32_t count);
+
+    /**
+     * @brief Gets the rows_per_chunk
+     */
+    uint32_t rows_per_chunk() const;
+
+private:
+    uint32_t rows_per_chunk_;
+};
+
+namespace columnar {
+
+/**
+ * @brief Layout of a columnar file.
+ *
+ * A columnar file is a sequence of sections that all start at an offset
+ * multiple of ALIGNMENT(), so a reader can map the file into memory and
+ * access the column values directly as native arrays:
+ *
+ * - File header (ALIGNMENT() bytes): MAGIC(), format VERSION(),
+ *   ENDIANNESS_MARKER() as written by the host and ALIGNMENT().
+ * - Chunks: groups of up to rows_per_chunk rows. For each column, a chunk
+ *   contains an array of fixed-width values followed by a validity bitmap
+ *   (bit i of byte i/8 set if row i has a value). String values are stored as
+ *   pairs of uint32 (offset, length) into the chunk string heap, which
+ *   follows the last column of the chunk.
+ * - Footer: schema (column names and TypeCode), metadata entries and the
+ *   directory of chunks with the file offset of each column array.
+ * - Trailer (TRAILER_SIZE() bytes at the end of the file): footer offset and
+ *   size, followed by MAGIC().
+ *
+ * All the integers are written in the byte order of the host that produces
+ * the file.
+ */
+enum class TypeCode : uint32_t {
+    UNSUPPORTED = 0,
+    BOOLEAN = 1,
+    CHAR8 = 2,
+    UINT8 = 3,
+    INT16 = 4,
+    UINT16 = 5,
+    INT32 = 6,
+    UINT32 = 7,
+    INT64 = 8,
+    UINT64 = 9,
+    FLOAT32 = 10,
+    FLOAT64 = 11,
+    ENUM32 = 12,
+    CHAR16 = 13,
+    STRING = 14
+};
+
+/**
+ * @brief Returns the size in bytes of a value of the specified type
+ */
+uint32_t type_width(TypeCode code);
+
+/**
+ * @brief Returns the name of the specified type, e.g. "int32"
+ */
+const char* type_name(TypeCode code);
+
+/**
+ * @brief Value: "RTICOL1" followed by a null character
+ */
+const char* MAGIC();
+const uint32_t MAGIC_SIZE = 8;
+const uint32_t VERSION = 1;
+const uint32_t ENDIANNESS_MARKER = 0x01020304;
+const uint64_t ALIGNMENT = 64;
+const uint32_t TRAILER_SIZE = 24;
+
+/**
+ * @brief Returns the specified offset rounded up to ALIGNMENT
+ */
+uint64_t align(uint64_t offset);
+
+/**
+ * @brief Description of a column in a columnar file
+ */
+struct ColumnDescriptor {
+    std::string name;
+    TypeCode type_code;
+};
+
+/**
+ * @brief Writes rows into an output stream in columnar format.
+ *
+ * Columns and metadata are specified first. Then rows are built by setting
+ * the value of their columns and calling end_row(). Columns without a value
+ * in a row are null. finish() must be called to complete the file.
+ */
+class FileWriter {
+public:
+    FileWriter(std::ostream& output, uint32_t rows_per_chunk);
+
+    /**
+     * @brief Adds a column to the schema. Must be called before the first row.
+     *
+     * @return The index of the column
+     */
+    uint32_t add_column(const std::string& name, TypeCode type_code);
+
+    /**
+     * @brief Adds a key/value pair to the footer metadata
+     */
+    void add_metadata(const std::string& key, const std::string& value);
+
+    const std::vector<ColumnDescriptor>& columns() const;
+
+    void integer_value(uint32_t column, int64_t value);
+    void real_value(uint32_t column, double value);
+    void text_value(uint32_t column, const std::string& value);
+
+    /**
+     * @brief Completes the current row
+     */
+    void end_row();
+
+    /**
+     * @brief Writes the pending rows as a chunk before it's complete
+     */
+    void flush_chunk();
+
+    /**
+     * @brief Returns the bytes of the buffers of the pending chunk
+     */
+    uint64_t buffer_size() const;
+
+    /**
+     * @brief Returns the bytes written into the output so far
+     */
+    uint64_t size() const;
+
+    /**
+     * @brief Releases the unused capacity of the buffer of the text values
+     */
+    void shrink();
+
+    /**
+     * @brief Writes the pending rows, the footer and the trailer
+     */
+    void finish();
+
+private:
+    struct ColumnChunk {
+        std::vector<char> values;
+        std::vector<uint8_t> validity;
+    };
+
+    struct ChunkEntry {
+        uint64_t row_count;
+        uint64_t heap_offset;
+        uint64_t heap_size;
+        // file offset of values and validity of each column
+        std::vector<std::pair<uint64_t, uint64_t> > columns;
+    };
+
+    void write_header();
+    void write_chunk();
+    void write_section(const char *data, uint64_t size);
+    void set_valid(uint32_t column);
+
+    std::ostream& output_;
+    uint32_t rows_per_chunk_;
+    std::vector<ColumnDescriptor> columns_;
+    std::vector<std::pair<std::string, std::string> > metadata_;
+    std::vector<ColumnChunk> chunk_columns_;
+    std::string heap_;
+    uint32_t row_count_;
+    uint64_t offset_;
+    std::vector<ChunkEntry> chunks_;
+    bool finished_;
+};
+
+/**
+ * @brief Provides access to the content of a columnar file loaded or mapped
+ * into memory.
+ *
+ * The reader does not copy the column values: values() returns a pointer
+ * into the provided buffer, which must outlive the reader.
+ *
+ * Construction throws std::runtime_error if the content is not a valid
+ * columnar file.
+ */
+class FileReader {
+public:
+    FileReader(const char *data, uint64_t size);
+
+    const std::vector<ColumnDescriptor>& columns() const;
+
+    /**
+     * @brief Returns the value of the metadata entry with the specified key
+     * or an empty string if not present.
+     */
+    std::string metadata(const std::string& key) const;
+
+    uint64_t chunk_count() const;
+    uint64_t row_count(uint64_t chunk) const;
+
+    /**
+     * @brief Returns the address of the array of values of a column in
+     * a chunk
+     */
+    const char* values(uint64_t chunk, uint32_t column) const;
+
+    bool is_valid(uint64_t chunk, uint32_t column, uint64_t row) const;
+
+    /**
+     * @brief Returns the value of a row as its string representation in
+     * a text format. Returns an empty string for null values.
+     */
+    std::string to_string(uint64_t chunk, uint32_t column, uint64_t row) const;
+
+private:
+    struct ChunkEntry {
+        uint64_t row_count;
+        uint64_t heap_offset;
+        uint64_t heap_size;
+        std::vector<std::pair<uint64_t, uint64_t> > columns;
+    };
+
+    const char *data_;
+    uint64_t size_;
+    std::vector<ColumnDescriptor> columns_;
+    std::vector<std::pair<std::string, std::string> > metadata_;
+    std::vector<ChunkEntry> chunks_;
+};
+
+} /* namespace columnar */
+
+} } }
+
+#endif
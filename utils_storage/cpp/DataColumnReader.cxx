@@ -0,0 +1,289 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <limits>
+
+#include "DataColumnReader.hpp"
+
+using namespace dds::core::xtypes;
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * --- DataColumnReader::Value ------------------------------------------------
+ */
+
+DataColumnReader::Value::Value() :
+    integer_(0),
+    real_(0)
+{
+}
+
+int64_t DataColumnReader::Value::integer_value() const
+{
+    return integer_;
+}
+
+uint64_t DataColumnReader::Value::unsigned_value() const
+{
+    return static_cast<uint64_t>(integer_);
+}
+
+DataColumnReader::Value& DataColumnReader::Value::integer_value(int64_t value)
+{
+    integer_ = value;
+
+    return *this;
+}
+
+double DataColumnReader::Value::real_value() const
+{
+    return real_;
+}
+
+DataColumnReader::Value& DataColumnReader::Value::real_value(double value)
+{
+    real_ = value;
+
+    return *this;
+}
+
+const std::string& DataColumnReader::Value::text_value() const
+{
+    return text_;
+}
+
+std::string& DataColumnReader::Value::text_value()
+{
+    return text_;
+}
+
+/*
+ * --- DataColumnReader -------------------------------------------------------
+ */
+
+DataColumnReader::DataColumnReader(
+        const ColumnInfo& column_info,
+        bool reads_all_elements) :
+    column_info_(column_info),
+    reads_all_elements_(reads_all_elements),
+    is_truncated_(false)
+{
+}
+
+void DataColumnReader::read(DynamicData& sample, Visitor& visitor)
+{
+    is_truncated_ = false;
+    visitor.begin_complex(column_info_);
+    read_complex(sample, column_info_, visitor);
+    visitor.end_complex(column_info_);
+}
+
+bool DataColumnReader::is_truncated() const
+{
+    return is_truncated_;
+}
+
+bool DataColumnReader::is_leaf(const ColumnInfo& info)
+{
+    // same criteria as print_type_header to generate a column
+    return info.children().empty();
+}
+
+void DataColumnReader::skip(const ColumnInfo& info, Visitor& visitor)
+{
+    if (is_leaf(info)) {
+        visitor.empty(info);
+        return;
+    }
+
+    for (auto& child : info.children()) {
+        if (!child.is_element_template()) {
+            skip(child, visitor);
+        }
+    }
+}
+
+void DataColumnReader::read_complex(
+        DynamicData& data,
+        const ColumnInfo& info,
+        Visitor& visitor)
+{
+    ColumnInfo::iterator child = info.first_child();
+    if (info.type_kind() == TypeKind::UNION_TYPE) {
+        // discriminator column
+        value_.integer_value(data.discriminator_value());
+        visitor.value(*child, value_);
+        ++child;
+    }
+
+    for (; child != info.children().end(); ++child) {
+        // the name is only used before reading the nested members, which
+        // reuse the storage
+        member_name_.assign(child->name().c_str(), child->name().length());
+        if (child->is_optional() && !data.member_exists(member_name_)) {
+            skip(*child, visitor);
+            continue;
+        }
+        read_member(data, member_name_, *child, visitor);
+    }
+}
+
+void DataColumnReader::read_collection(
+        DynamicData& data,
+        const ColumnInfo& info,
+        Visitor& visitor)
+{
+    ColumnInfo::iterator child = info.first_child();
+    uint32_t length = std::numeric_limits<uint32_t>::max();
+    if (info.type_kind() == TypeKind::SEQUENCE_TYPE) {
+        // length column
+        length = data.member_count();
+        value_.integer_value(length);
+        visitor.value(*child, value_);
+        ++child;
+    }
+
+    // DynamicData collection elements are accessed through 1-based indexes
+    uint32_t element_count = 0;
+    for (; child != info.children().end() && !child->is_element_template();
+            ++child) {
+        if (child->element_index() >= length) {
+            skip(*child, visitor);
+        } else {
+            read_member(data, child->element_index() + 1, *child, visitor);
+        }
+        ++element_count;
+    }
+
+    // elements beyond the inline elements of an exploded sequence
+    if (child == info.children().end() || element_count >= length) {
+        return;
+    }
+    if (!reads_all_elements_) {
+        is_truncated_ = true;
+        return;
+    }
+    for (uint32_t i = element_count; i < length; i++) {
+        read_member(data, i + 1, *child, visitor);
+    }
+}
+
+template <typename Key>
+void DataColumnReader::read_member(
+        DynamicData& data,
+        const Key& key,
+        const ColumnInfo& info,
+        Visitor& visitor)
+{
+    if (is_leaf(info)) {
+        read_leaf(data, key, info, visitor);
+        return;
+    }
+
+    LoanedDynamicData loan = data.loan_value(key);
+    if (info.is_collection()) {
+        visitor.begin_collection(info);
+        read_collection(loan.get(), info, visitor);
+        visitor.end_collection(info);
+    } else {
+        visitor.begin_complex(info);
+        read_complex(loan.get(), info, visitor);
+        visitor.end_complex(info);
+    }
+}
+
+template <typename Key>
+void DataColumnReader::read_leaf(
+        const DynamicData& data,
+        const Key& key,
+        const ColumnInfo& info,
+        Visitor& visitor)
+{
+    switch (info.type_kind().underlying()) {
+
+    case TypeKind::BOOLEAN_TYPE:
+        value_.integer_value(data.value<bool>(key) ? 1 : 0);
+        break;
+
+    case TypeKind::CHAR_8_TYPE:
+        value_.integer_value(data.value<char>(key));
+        break;
+
+    case TypeKind::CHAR_16_TYPE:
+        value_.integer_value(data.value<wchar_t>(key));
+        break;
+
+    case TypeKind::UINT_8_TYPE:
+        value_.integer_value(data.value<uint8_t>(key));
+        break;
+
+    case TypeKind::INT_16_TYPE:
+        value_.integer_value(data.value<int16_t>(key));
+        break;
+
+    case TypeKind::UINT_16_TYPE:
+        value_.integer_value(data.value<uint16_t>(key));
+        break;
+
+    case TypeKind::INT_32_TYPE:
+    case TypeKind::ENUMERATION_TYPE:
+        value_.integer_value(data.value<int32_t>(key));
+        break;
+
+    case TypeKind::UINT_32_TYPE:
+        value_.integer_value(data.value<uint32_t>(key));
+        break;
+
+    case TypeKind::INT_64_TYPE:
+        value_.integer_value(data.value<int64_t>(key));
+        break;
+
+    case TypeKind::UINT_64_TYPE:
+        value_.integer_value(
+                static_cast<int64_t>(data.value<uint64_t>(key)));
+        break;
+
+    case TypeKind::FLOAT_32_TYPE:
+        value_.real_value(data.value<float>(key));
+        break;
+
+    case TypeKind::FLOAT_64_TYPE:
+        value_.real_value(data.value<double>(key));
+        break;
+
+    case TypeKind::STRING_TYPE:
+        value_.text_value() = data.value<std::string>(key);
+        break;
+
+    case TypeKind::WSTRING_TYPE:
+    {
+        // wide strings are narrowed, replacing non-ASCII characters
+        std::wstring wide_value = data.value<std::wstring>(key);
+        std::string& text = value_.text_value();
+        text.clear();
+        for (auto wide_char : wide_value) {
+            text.push_back(wide_char < 0x80 ? static_cast<char>(wide_char) : '?');
+        }
+    }
+        break;
+
+    default:
+        // long double and empty structures have no value representation
+        visitor.empty(info);
+        return;
+    }
+
+    visitor.value(info, value_);
+}
+
+} } }
@@ -0,0 +1,197 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_DATACOLUMNREADER_HPP_
+#define RTI_RECORDER_UTILS_DATACOLUMNREADER_HPP_
+
+#include <string>
+
+#include "dds/core/xtypes/DynamicData.hpp"
+
+#include "PrintFormatCsv.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Reads the leaf member values of a DynamicData sample following the
+ * layout of a ColumnInfo tree.
+ *
+ * Unlike PrintFormatCsv, which produces text through the DDS_PrintFormat
+ * callbacks, a DataColumnReader provides the typed value of each leaf column
+ * to a Visitor. The Visitor is notified once per leaf column of the tree and
+ * in the same order as the columns of the CSV type header, so implementations
+ * can simply keep a column counter. Leaf columns that are not present in a
+ * sample (unset optional members, non-selected union members, missing sequence
+ * elements) are notified through Visitor::empty. The element templates of
+ * exploded sequences have no columns, so by default the elements of a sample
+ * that don't fit in the inline element columns are not read, and
+ * is_truncated() reports it. Visitors that don't rely on the columns can
+ * read all the elements, notified through the element template.
+ *
+ * Visitors that need to preserve the nesting of the data can also be
+ * notified of the beginning and end of the complex and collection members
+ * present in the sample.
+ */
+class DataColumnReader {
+public:
+    typedef PrintFormatCsv::ColumnInfo ColumnInfo;
+
+    /**
+     * @brief Value of a leaf column.
+     *
+     * Integral types (including boolean, characters and enumerations) are
+     * provided through integer_value(), floating point types through
+     * real_value() and string types through text_value(). The type kind of
+     * the column determines which one applies.
+     */
+    class Value {
+    public:
+        Value();
+
+        int64_t integer_value() const;
+        uint64_t unsigned_value() const;
+        Value& integer_value(int64_t value);
+
+        double real_value() const;
+        Value& real_value(double value);
+
+        const std::string& text_value() const;
+        std::string& text_value();
+
+    private:
+        int64_t integer_;
+        double real_;
+        std::string text_;
+    };
+
+    /**
+     * @brief Receives the leaf column values of a sample.
+     */
+    class Visitor {
+    public:
+        virtual ~Visitor() {}
+
+        /**
+         * @brief Notifies the value of a leaf column present in the sample
+         */
+        virtual void value(const ColumnInfo& info, const Value& value) = 0;
+
+        /**
+         * @brief Notifies a leaf column not present in the sample
+         */
+        virtual void empty(const ColumnInfo& info) = 0;
+
+        /**
+         * @brief Notifies the beginning of a structure or union present in
+         * the sample, including the top-level one.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void begin_complex(const ColumnInfo&)
+        {
+        }
+
+        /**
+         * @brief Notifies the end of a structure or union
+         */
+        virtual void end_complex(const ColumnInfo&)
+        {
+        }
+
+        /**
+         * @brief Notifies the beginning of an array or sequence present in
+         * the sample.
+         *
+         * Default implementation does nothing.
+         */
+        virtual void begin_collection(const ColumnInfo&)
+        {
+        }
+
+        /**
+         * @brief Notifies the end of an array or sequence
+         */
+        virtual void end_collection(const ColumnInfo&)
+        {
+        }
+    };
+
+    /**
+     * @brief Creates a reader for the specified ColumnInfo tree.
+     *
+     * @param[in] column_info Root of the tree. It must outlive this object.
+     * @param[in] reads_all_elements Whether the elements of exploded
+     *                               sequences beyond the inline elements
+     *                               are read, through the element template.
+     */
+    explicit DataColumnReader(
+            const ColumnInfo& column_info,
+            bool reads_all_elements = false);
+
+    /**
+     * @brief Notifies the visitor with all the leaf columns of the sample
+     */
+    void read(dds::core::xtypes::DynamicData& sample, Visitor& visitor);
+
+    /**
+     * @brief Returns whether the last sample read had sequence elements
+     * that were not read, because they don't fit in the inline elements.
+     */
+    bool is_truncated() const;
+
+    /**
+     * @brief Returns whether a ColumnInfo represents a leaf column
+     */
+    static bool is_leaf(const ColumnInfo& info);
+
+    /**
+     * @brief Notifies as empty all the leaf columns under the specified info
+     */
+    static void skip(const ColumnInfo& info, Visitor& visitor);
+
+private:
+    void read_complex(
+            dds::core::xtypes::DynamicData& data,
+            const ColumnInfo& info,
+            Visitor& visitor);
+
+    void read_collection(
+            dds::core::xtypes::DynamicData& data,
+            const ColumnInfo& info,
+            Visitor& visitor);
+
+    template <typename Key>
+    void read_member(
+            dds::core::xtypes::DynamicData& data,
+            const Key& key,
+            const ColumnInfo& info,
+            Visitor& visitor);
+
+    template <typename Key>
+    void read_leaf(
+            const dds::core::xtypes::DynamicData& data,
+            const Key& key,
+            const ColumnInfo& info,
+            Visitor& visitor);
+
+    const ColumnInfo& column_info_;
+    bool reads_all_elements_;
+    bool is_truncated_;
+    // scratch value reused for all the leaf columns
+    Value value_;
+    // scratch name of the member being read, for the DynamicData accessors
+    std::string member_name_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,550 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "dds/core/xtypes/AliasType.hpp"
+#include "dds/core/xtypes/CollectionTypes.hpp"
+
+#include "Decimator.hpp"
+
+using namespace dds::core::xtypes;
+
+namespace rti { namespace recorder { namespace utils {
+
+static const DynamicType& resolve_alias(const DynamicType& type)
+{
+    const DynamicType *resolved = &type;
+    while (resolved->kind() == TypeKind::ALIAS_TYPE) {
+        resolved = &static_cast<const AliasType *>(resolved)->related_type();
+    }
+
+    return *resolved;
+}
+
+/*
+ * Parses a positive integer followed by a time unit into nanoseconds.
+ */
+static int64_t parse_period(const std::string& text)
+{
+    static const struct {
+        const char *name;
+        int64_t nanosecs;
+    } units[] = {
+        { "ns", 1 },
+        { "us", 1000 },
+        { "ms", 1000000 },
+        { "s", 1000000000 }
+    };
+
+    char *end = NULL;
+    long long count = std::strtoll(text.c_str(), &end, 10);
+    if (end != text.c_str() && count > 0) {
+        for (auto& unit : units) {
+            if (std::string(end) == unit.name) {
+                return static_cast<int64_t>(count) * unit.nanosecs;
+            }
+        }
+    }
+
+    throw std::runtime_error(
+            "invalid decimation period=" + text
+            + ": it must be a positive integer followed by ns, us, ms or s");
+}
+
+/*
+ * --- DecimatorProperty ------------------------------------------------------
+ */
+
+DecimatorProperty::DecimatorProperty()
+    : value_("NONE"),
+      kind_(DecimationKind::NONE),
+      sample_count_(1),
+      period_(0)
+{
+}
+
+DecimatorProperty::DecimatorProperty(const std::string& value)
+    : value_(value),
+      kind_(DecimationKind::NONE),
+      sample_count_(1),
+      period_(0)
+{
+    static const struct {
+        const char *name;
+        DecimationKind kind;
+    } kinds[] = {
+        { "NONE", DecimationKind::NONE },
+        { "EVERY_NTH", DecimationKind::EVERY_NTH },
+        { "FIRST", DecimationKind::FIRST },
+        { "LAST", DecimationKind::LAST },
+        { "MIN", DecimationKind::MIN },
+        { "MAX", DecimationKind::MAX },
+        { "MEAN", DecimationKind::MEAN }
+    };
+
+    std::string::size_type separator = value.find(':');
+    std::string kind_name = value.substr(0, separator);
+    std::string parameter = (separator == std::string::npos)
+            ? std::string()
+            : value.substr(separator + 1);
+
+    bool is_supported = false;
+    for (auto& kind : kinds) {
+        if (kind_name == kind.name) {
+            kind_ = kind.kind;
+            is_supported = true;
+        }
+    }
+    if (!is_supported) {
+        throw std::runtime_error("unsupported decimation kind=" + kind_name);
+    }
+
+    switch (kind_) {
+    case DecimationKind::NONE:
+        if (separator != std::string::npos) {
+            throw std::runtime_error(
+                    "decimation kind=NONE doesn't have a parameter");
+        }
+        break;
+
+    case DecimationKind::EVERY_NTH:
+    {
+        char *end = NULL;
+        unsigned long long count = std::strtoull(parameter.c_str(), &end, 10);
+        if (parameter.empty() || parameter[0] == '-' || *end != '\0'
+                || count == 0) {
+            throw std::runtime_error(
+                    "invalid decimation sample count=" + parameter
+                    + ": it must be a positive integer");
+        }
+        sample_count_ = count;
+    }
+        break;
+
+    default:
+        period_ = parse_period(parameter);
+        break;
+    }
+}
+
+DecimationKind DecimatorProperty::kind() const
+{
+    return kind_;
+}
+
+uint64_t DecimatorProperty::sample_count() const
+{
+    return sample_count_;
+}
+
+int64_t DecimatorProperty::period() const
+{
+    return period_;
+}
+
+bool DecimatorProperty::is_aggregate() const
+{
+    return kind_ == DecimationKind::MIN
+            || kind_ == DecimationKind::MAX
+            || kind_ == DecimationKind::MEAN;
+}
+
+const std::string& DecimatorProperty::value() const
+{
+    return value_;
+}
+
+/*
+ * --- Decimator --------------------------------------------------------------
+ */
+
+Decimator::Node::Node()
+    : kind(TypeKind::NO_TYPE),
+      element_count(0),
+      leaf_count(0)
+{
+}
+
+Decimator::InstanceBucket::InstanceBucket()
+    : sample_timestamp(0),
+      count(0),
+      sample_count(0)
+{
+}
+
+Decimator::Decimator(
+        const DecimatorProperty& property,
+        const DynamicType& type)
+    : property_(property),
+      current_instance_(NULL),
+      bucket_(0),
+      bucket_count_(0)
+{
+    if (property_.is_aggregate()) {
+        build_node(type, root_);
+    }
+}
+
+Decimator::InstanceBucket& Decimator::instance_bucket(
+        const dds::sub::SampleInfo& info)
+{
+    const DDS_InstanceHandle_t& handle = info->native().instance_handle;
+    instance_key_.assign(
+            reinterpret_cast<const char *>(handle.keyHash.value),
+            sizeof(handle.keyHash.value));
+    auto found = instance_indexes_.find(instance_key_);
+    if (found != instance_indexes_.end()) {
+        return instances_[found->second];
+    }
+
+    instance_indexes_[instance_key_] = instances_.size();
+    instances_.push_back(InstanceBucket());
+    instances_.back().aggregates.resize(root_.leaf_count);
+    return instances_.back();
+}
+
+bool Decimator::build_node(const DynamicType& type, Node& node)
+{
+    const DynamicType& resolved_type = resolve_alias(type);
+    switch (resolved_type.kind().underlying()) {
+    case TypeKind::UINT_8_TYPE:
+    case TypeKind::INT_16_TYPE:
+    case TypeKind::UINT_16_TYPE:
+    case TypeKind::INT_32_TYPE:
+    case TypeKind::UINT_32_TYPE:
+    case TypeKind::INT_64_TYPE:
+    case TypeKind::UINT_64_TYPE:
+    case TypeKind::FLOAT_32_TYPE:
+    case TypeKind::FLOAT_64_TYPE:
+        node.kind = resolved_type.kind();
+        node.leaf_count = 1;
+        break;
+
+    case TypeKind::STRUCTURE_TYPE:
+        node.kind = TypeKind::STRUCTURE_TYPE;
+        build_members(
+                static_cast<const StructType&>(resolved_type),
+                node);
+        break;
+
+    case TypeKind::ARRAY_TYPE:
+    {
+        auto& array_type = static_cast<const ArrayType&>(resolved_type);
+        Node element;
+        if (build_node(array_type.content_type(), element)) {
+            node.kind = TypeKind::ARRAY_TYPE;
+            node.element_count = array_type.total_element_count();
+            node.leaf_count = node.element_count * element.leaf_count;
+            node.children.push_back(std::move(element));
+        }
+    }
+        break;
+
+    default:
+        // not aggregated
+        break;
+    }
+
+    return node.leaf_count > 0;
+}
+
+void Decimator::build_members(const StructType& struct_type, Node& node)
+{
+    // inherited members come first
+    if (struct_type.has_parent()) {
+        build_members(struct_type.parent(), node);
+    }
+    for (uint32_t i = 0; i < struct_type.member_count(); i++) {
+        auto& member = struct_type.member(i);
+        if (member.is_optional()) {
+            continue;
+        }
+        Node child;
+        child.name = member.name();
+        if (build_node(member.type(), child)) {
+            node.leaf_count += child.leaf_count;
+            node.children.push_back(std::move(child));
+        }
+    }
+}
+
+void Decimator::add(
+        DynamicData& sample,
+        const dds::sub::SampleInfo& info,
+        int64_t timestamp,
+        const RowWriter& write_row)
+{
+    if (property_.kind() == DecimationKind::NONE) {
+        write_row(sample, info, timestamp);
+        return;
+    }
+
+    if (property_.kind() == DecimationKind::EVERY_NTH) {
+        InstanceBucket& instance = instance_bucket(info);
+        if (instance.sample_count % property_.sample_count() == 0) {
+            write_row(sample, info, timestamp);
+        }
+        ++instance.sample_count;
+        return;
+    }
+
+    int64_t bucket = timestamp / property_.period();
+    if (bucket_count_ > 0 && bucket > bucket_) {
+        flush(write_row);
+    }
+    if (bucket_count_ == 0) {
+        bucket_ = bucket;
+    }
+
+    InstanceBucket& instance = instance_bucket(info);
+    switch (property_.kind()) {
+    case DecimationKind::FIRST:
+        if (instance.count == 0) {
+            write_row(sample, info, timestamp);
+        }
+        break;
+
+    case DecimationKind::LAST:
+        if (instance.sample) {
+            *instance.sample = sample;
+        } else {
+            instance.sample.reset(new DynamicData(sample));
+        }
+        instance.info = info;
+        instance.sample_timestamp = timestamp;
+        break;
+
+    default:
+    {
+        // the first sample provides the row of the instance
+        if (instance.count == 0) {
+            if (instance.sample) {
+                *instance.sample = sample;
+            } else {
+                instance.sample.reset(new DynamicData(sample));
+            }
+            instance.info = info;
+        }
+        current_instance_ = &instance;
+        size_t leaf = 0;
+        visit_children(sample, root_, leaf, false);
+    }
+        break;
+    }
+    ++instance.count;
+    ++bucket_count_;
+}
+
+void Decimator::flush(const RowWriter& write_row)
+{
+    if (bucket_count_ == 0) {
+        return;
+    }
+
+    bucket_count_ = 0;
+    for (auto& instance : instances_) {
+        if (instance.count > 0) {
+            flush_instance(instance, write_row);
+        }
+    }
+}
+
+void Decimator::flush_instance(
+        InstanceBucket& instance,
+        const RowWriter& write_row)
+{
+    uint64_t sample_count = instance.count;
+    instance.count = 0;
+    switch (property_.kind()) {
+    case DecimationKind::FIRST:
+        // already written
+        break;
+
+    case DecimationKind::LAST:
+        write_row(*instance.sample, instance.info, instance.sample_timestamp);
+        break;
+
+    default:
+    {
+        if (property_.kind() == DecimationKind::MEAN) {
+            for (auto& aggregate : instance.aggregates) {
+                aggregate /= sample_count;
+            }
+        }
+        current_instance_ = &instance;
+        size_t leaf = 0;
+        visit_children(*instance.sample, root_, leaf, true);
+        write_row(
+                *instance.sample,
+                instance.info,
+                bucket_ * property_.period());
+    }
+        break;
+    }
+}
+
+const DecimatorProperty& Decimator::property() const
+{
+    return property_;
+}
+
+void Decimator::visit_children(
+        DynamicData& data,
+        const Node& node,
+        size_t& leaf,
+        bool is_store)
+{
+    if (node.kind == TypeKind::ARRAY_TYPE) {
+        for (uint32_t i = 1; i <= node.element_count; i++) {
+            visit(data, i, node.children[0], leaf, is_store);
+        }
+    } else {
+        for (auto& child : node.children) {
+            visit(data, child.name, child, leaf, is_store);
+        }
+    }
+}
+
+template <typename Key>
+void Decimator::visit(
+        DynamicData& data,
+        const Key& key,
+        const Node& node,
+        size_t& leaf,
+        bool is_store)
+{
+    if (node.kind == TypeKind::STRUCTURE_TYPE
+            || node.kind == TypeKind::ARRAY_TYPE) {
+        // changes to the loaned member are applied when it's returned
+        LoanedDynamicData loan = data.loan_value(key);
+        visit_children(loan.get(), node, leaf, is_store);
+    } else if (is_store) {
+        write_leaf(data, key, node.kind, current_instance_->aggregates[leaf]);
+        ++leaf;
+    } else {
+        accumulate(leaf, read_leaf(data, key, node.kind));
+        ++leaf;
+    }
+}
+
+void Decimator::accumulate(size_t leaf, long double value)
+{
+    long double& aggregate = current_instance_->aggregates[leaf];
+    if (current_instance_->count == 0) {
+        aggregate = value;
+        return;
+    }
+
+    switch (property_.kind()) {
+    case DecimationKind::MIN:
+        aggregate = std::min(aggregate, value);
+        break;
+
+    case DecimationKind::MAX:
+        aggregate = std::max(aggregate, value);
+        break;
+
+    default:
+        aggregate += value;
+        break;
+    }
+}
+
+template <typename Key>
+long double Decimator::read_leaf(
+        const DynamicData& data,
+        const Key& key,
+        TypeKind kind)
+{
+    switch (kind.underlying()) {
+    case TypeKind::UINT_8_TYPE:
+        return data.value<uint8_t>(key);
+
+    case TypeKind::INT_16_TYPE:
+        return data.value<int16_t>(key);
+
+    case TypeKind::UINT_16_TYPE:
+        return data.value<uint16_t>(key);
+
+    case TypeKind::INT_32_TYPE:
+        return data.value<int32_t>(key);
+
+    case TypeKind::UINT_32_TYPE:
+        return data.value<uint32_t>(key);
+
+    case TypeKind::INT_64_TYPE:
+        return data.value<int64_t>(key);
+
+    case TypeKind::UINT_64_TYPE:
+        return data.value<uint64_t>(key);
+
+    case TypeKind::FLOAT_32_TYPE:
+        return data.value<float>(key);
+
+    default:
+        return data.value<double>(key);
+    }
+}
+
+template <typename Key>
+void Decimator::write_leaf(
+        DynamicData& data,
+        const Key& key,
+        TypeKind kind,
+        long double value)
+{
+    // means of integer members are rounded to the nearest integer
+    long double integer = std::round(value);
+    switch (kind.underlying()) {
+    case TypeKind::UINT_8_TYPE:
+        data.value<uint8_t>(key, static_cast<uint8_t>(integer));
+        break;
+
+    case TypeKind::INT_16_TYPE:
+        data.value<int16_t>(key, static_cast<int16_t>(integer));
+        break;
+
+    case TypeKind::UINT_16_TYPE:
+        data.value<uint16_t>(key, static_cast<uint16_t>(integer));
+        break;
+
+    case TypeKind::INT_32_TYPE:
+        data.value<int32_t>(key, static_cast<int32_t>(integer));
+        break;
+
+    case TypeKind::UINT_32_TYPE:
+        data.value<uint32_t>(key, static_cast<uint32_t>(integer));
+        break;
+
+    case TypeKind::INT_64_TYPE:
+        data.value<int64_t>(key, static_cast<int64_t>(integer));
+        break;
+
+    case TypeKind::UINT_64_TYPE:
+        data.value<uint64_t>(key, static_cast<uint64_t>(integer));
+        break;
+
+    case TypeKind::FLOAT_32_TYPE:
+        data.value<float>(key, static_cast<float>(value));
+        break;
+
+    default:
+        data.value<double>(key, static_cast<double>(value));
+        break;
+    }
+}
+
+} } }
@@ -0,0 +1,264 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_DECIMATOR_HPP_
+#define RTI_RECORDER_UTILS_DECIMATOR_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dds/core/xtypes/DynamicData.hpp"
+#include "dds/core/xtypes/DynamicType.hpp"
+#include "dds/core/xtypes/StructType.hpp"
+#include "dds/sub/SampleInfo.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Kinds of decimation of the samples of a stream
+ */
+enum class DecimationKind {
+    // all the samples are written
+    NONE,
+    // one of every N samples of each instance, starting with the first one
+    EVERY_NTH,
+    // the first sample of each time bucket
+    FIRST,
+    // the last sample of each time bucket
+    LAST,
+    // one row per time bucket with the minimum of each numeric member
+    MIN,
+    // one row per time bucket with the maximum of each numeric member
+    MAX,
+    // one row per time bucket with the mean of each numeric member
+    MEAN
+};
+
+/**
+ * @brief Configuration of the decimation of a stream.
+ *
+ * It is specified as a string with the format <kind>[:<parameter>]:
+ *
+ * - NONE
+ * - EVERY_NTH:<count>, e.g. "EVERY_NTH:10"
+ * - FIRST, LAST, MIN, MAX or MEAN:<period>, where the period is the length
+ *   of the time buckets, an integer followed by the unit ns, us, ms or s,
+ *   e.g. "MEAN:100ms"
+ */
+class DecimatorProperty {
+public:
+    /**
+     * @brief Creates a property with DecimationKind::NONE
+     */
+    DecimatorProperty();
+
+    /**
+     * @brief Creates a property from its string representation.
+     *
+     * Throws std::runtime_error if the value is not valid.
+     */
+    explicit DecimatorProperty(const std::string& value);
+
+    /**
+     * @brief Gets the kind of decimation
+     */
+    DecimationKind kind() const;
+
+    /**
+     * @brief Gets the number of samples N of DecimationKind::EVERY_NTH
+     */
+    uint64_t sample_count() const;
+
+    /**
+     * @brief Gets the length of the time buckets in nanoseconds
+     */
+    int64_t period() const;
+
+    /**
+     * @brief Returns whether the decimation aggregates the numeric members
+     * of the samples of a bucket (MIN, MAX and MEAN)
+     */
+    bool is_aggregate() const;
+
+    /**
+     * @brief Returns the value as specified on construction
+     */
+    const std::string& value() const;
+
+private:
+    std::string value_;
+    DecimationKind kind_;
+    uint64_t sample_count_;
+    int64_t period_;
+};
+
+/**
+ * @brief Selects or aggregates the samples of a stream to reduce the number
+ * of rows written.
+ *
+ * Each instance, identified by the instance handle of the SampleInfo, is
+ * decimated on its own, so the rows of an instance only come from its
+ * samples. Types without key members have a single instance.
+ *
+ * The samples are assigned to time buckets of DecimatorProperty::period
+ * nanoseconds according to the timestamp they are added with. A bucket is
+ * complete when a sample of any instance with a timestamp of a later bucket
+ * is added, or when flush() is called, and then provides a row for each
+ * instance with samples in it, in the order the instances were first
+ * added. Samples with a timestamp of an earlier bucket are added to the
+ * current one.
+ *
+ * The aggregate kinds produce a row per bucket with the timestamp of the
+ * beginning of the bucket. The row is the first sample of the bucket where
+ * the numeric members of structures and arrays (integers and floating
+ * point numbers) are replaced by their minimum, maximum or mean. The
+ * members of sequences and unions and the optional members are not
+ * aggregated and keep the values of the first sample.
+ *
+ * Each row is provided with the information of the sample it comes from:
+ * the last sample of the bucket for LAST and the first one for the
+ * aggregate kinds.
+ */
+class Decimator {
+public:
+    /**
+     * @brief Receives a row to write with the information of its sample
+     * and its timestamp
+     */
+    typedef std::function<void(
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info,
+            int64_t timestamp)> RowWriter;
+
+    /**
+     * @brief Creates a decimator for the samples of a type
+     */
+    Decimator(
+            const DecimatorProperty& property,
+            const dds::core::xtypes::DynamicType& type);
+
+    /**
+     * @brief Adds a sample. The rows it completes, if any, are provided to
+     * the specified writer before returning.
+     */
+    void add(
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info,
+            int64_t timestamp,
+            const RowWriter& write_row);
+
+    /**
+     * @brief Provides the rows of the current bucket, if it has samples, to
+     * the specified writer. Called when no more samples are added.
+     */
+    void flush(const RowWriter& write_row);
+
+    /**
+     * @brief Gets the configuration of this decimator
+     */
+    const DecimatorProperty& property() const;
+
+private:
+    // structure or array member with numeric leaves, or a numeric leaf
+    struct Node {
+        Node();
+
+        // member name, empty for array elements
+        std::string name;
+        // STRUCTURE_TYPE, ARRAY_TYPE or the kind of a numeric leaf
+        dds::core::xtypes::TypeKind kind;
+        // number of elements of an array
+        uint32_t element_count;
+        // number of leaves under this node
+        size_t leaf_count;
+        // members of a structure, or the single element of an array
+        std::vector<Node> children;
+    };
+
+    // state of an instance in the current bucket
+    struct InstanceBucket {
+        InstanceBucket();
+
+        // minimum, maximum or sum of each leaf
+        std::vector<long double> aggregates;
+        // copy of the sample that provides the row
+        std::unique_ptr<dds::core::xtypes::DynamicData> sample;
+        dds::sub::SampleInfo info;
+        int64_t sample_timestamp;
+        // number of samples in the bucket
+        uint64_t count;
+        // samples added, for EVERY_NTH
+        uint64_t sample_count;
+    };
+
+    InstanceBucket& instance_bucket(const dds::sub::SampleInfo& info);
+
+    void flush_instance(InstanceBucket& instance, const RowWriter& write_row);
+
+    static bool build_node(
+            const dds::core::xtypes::DynamicType& type,
+            Node& node);
+
+    static void build_members(
+            const dds::core::xtypes::StructType& struct_type,
+            Node& node);
+
+    void visit_children(
+            dds::core::xtypes::DynamicData& data,
+            const Node& node,
+            size_t& leaf,
+            bool is_store);
+
+    template <typename Key>
+    void visit(
+            dds::core::xtypes::DynamicData& data,
+            const Key& key,
+            const Node& node,
+            size_t& leaf,
+            bool is_store);
+
+    template <typename Key>
+    static long double read_leaf(
+            const dds::core::xtypes::DynamicData& data,
+            const Key& key,
+            dds::core::xtypes::TypeKind kind);
+
+    template <typename Key>
+    static void write_leaf(
+            dds::core::xtypes::DynamicData& data,
+            const Key& key,
+            dds::core::xtypes::TypeKind kind,
+            long double value);
+
+    void accumulate(size_t leaf, long double value);
+
+    DecimatorProperty property_;
+    // numeric leaves of the type, for the aggregate kinds
+    Node root_;
+    // instances in the order they were first added, and their index by
+    // key hash
+    std::vector<InstanceBucket> instances_;
+    std::unordered_map<std::string, size_t> instance_indexes_;
+    std::string instance_key_;
+    // instance whose leaves are being visited
+    InstanceBucket *current_instance_;
+    // index of the current bucket and the number of samples in it
+    int64_t bucket_;
+    uint64_t bucket_count_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cstring>
+
+#include "dds/core/xtypes/StructType.hpp"
+#include "dds/core/xtypes/MemberType.hpp"
+#include "dds/core/xtypes/AliasType.hpp"
+
+#include "DeltaRowEncoder.hpp"
+#include "DataColumnReader.hpp"
+
+using namespace dds::core::xtypes;
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * Returns whether a structure, or any of its base types, has a key member
+ * with the specified name.
+ */
+static bool is_key_member(const StructType& struct_type, const std::string& name)
+{
+    for (uint32_t i = 0; i < struct_type.member_count(); i++) {
+        auto& member = struct_type.member(i);
+        if (member.name() == name) {
+            return member.is_key();
+        }
+    }
+
+    return struct_type.has_parent()
+            && is_key_member(struct_type.parent(), name);
+}
+
+DeltaRowEncoder::DeltaRowEncoder(
+        const PrintFormatCsvProperty& property,
+        const PrintFormatCsv::ColumnPlan& plan)
+    : kind_(property.delta_rows()),
+      keyframe_interval_(property.keyframe_interval()),
+      separator_(PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT())
+{
+    const DynamicType *type = &plan.type();
+    while (type->kind() == TypeKind::ALIAS_TYPE) {
+        type = &static_cast<const AliasType *>(type)->related_type();
+    }
+
+    size_t column_index = 0;
+    for (auto& child : plan.column_info().children()) {
+        add_key_columns(
+                child,
+                type->kind() == TypeKind::STRUCTURE_TYPE
+                        && is_key_member(
+                                static_cast<const StructType&>(*type),
+                                child.name().str()),
+                column_index);
+    }
+}
+
+void DeltaRowEncoder::add_key_columns(
+        const ColumnInfo& info,
+        bool is_key,
+        size_t& column_index)
+{
+    if (DataColumnReader::is_leaf(info)) {
+        if (is_key) {
+            key_columns_.push_back(column_index);
+        }
+        ++column_index;
+        return;
+    }
+
+    for (auto& child : info.children()) {
+        if (!child.is_element_template()) {
+            add_key_columns(child, is_key, column_index);
+        }
+    }
+}
+
+void DeltaRowEncoder::split(const std::string& row)
+{
+    cell_offsets_.clear();
+    size_t offset = row.find(separator_);
+    while (offset != std::string::npos) {
+        cell_offsets_.push_back(offset);
+        offset = row.find(separator_, offset + separator_.length());
+    }
+    cell_offsets_.push_back(row.length());
+}
+
+void DeltaRowEncoder::collect_table_rows(
+        std::list<PrintFormatCsv::ExplodedTable>& tables)
+{
+    table_rows_.clear();
+    for (auto& table : tables) {
+        // the row_id of each row differs from the previous sample
+        const std::string& rows = table.rows();
+        size_t line_begin = 0;
+        while (line_begin < rows.length()) {
+            size_t line_end = rows.find('\n', line_begin);
+            size_t cells_begin = rows.find(separator_, line_begin);
+            if (cells_begin > line_end) {
+                cells_begin = line_end;
+            }
+            table_rows_.append(rows, cells_begin, line_end + 1 - cells_begin);
+            line_begin = line_end + 1;
+        }
+        // rows are never empty, so an empty line ends the table
+        table_rows_ += '\n';
+    }
+}
+
+bool DeltaRowEncoder::encode(
+        std::string& row,
+        std::list<PrintFormatCsv::ExplodedTable>& tables,
+        bool& is_keyframe)
+{
+    split(row);
+    collect_table_rows(tables);
+    const size_t cell_count = cell_offsets_.size() - 1;
+
+    instance_key_.clear();
+    for (size_t column : key_columns_) {
+        if (column < cell_count) {
+            instance_key_.append(
+                    row,
+                    cell_offsets_[column],
+                    cell_offsets_[column + 1] - cell_offsets_[column]);
+        }
+    }
+    InstanceState& instance = instances_[instance_key_];
+
+    is_keyframe = (keyframe_interval_ == 0)
+            ? instance.sample_count == 0
+            : instance.sample_count % keyframe_interval_ == 0;
+    // the number of cells only changes if a separator is part of a value
+    is_keyframe = is_keyframe
+            || instance.cell_offsets.size() != cell_offsets_.size();
+    ++instance.sample_count;
+
+    if (!is_keyframe) {
+        if (row == instance.row && table_rows_ == instance.table_rows) {
+            return false;
+        }
+
+        if (kind_ == DeltaRowKind::CHANGED_CELLS) {
+            delta_row_.clear();
+            size_t key_index = 0;
+            for (size_t column = 0; column < cell_count; column++) {
+                size_t begin = cell_offsets_[column] + separator_.length();
+                size_t length = cell_offsets_[column + 1] - begin;
+                size_t previous_begin =
+                        instance.cell_offsets[column] + separator_.length();
+                bool is_key_column = key_index < key_columns_.size()
+                        && key_columns_[key_index] == column;
+                if (is_key_column) {
+                    ++key_index;
+                }
+
+                delta_row_ += separator_;
+                if (!is_key_column
+                        && length == instance.cell_offsets[column + 1]
+                                - previous_begin
+                        && std::memcmp(
+                                row.data() + begin,
+                                instance.row.data() + previous_begin,
+                                length) == 0) {
+                    // unchanged
+                    continue;
+                }
+                if (length == 0) {
+                    is_keyframe = true;
+                    break;
+                }
+                delta_row_.append(row, begin, length);
+            }
+        }
+    }
+
+    instance.row = row;
+    instance.table_rows.swap(table_rows_);
+    instance.cell_offsets.swap(cell_offsets_);
+    if (!is_keyframe && kind_ == DeltaRowKind::CHANGED_CELLS) {
+        row.swap(delta_row_);
+    }
+
+    return true;
+}
+
+} } }
@@ -0,0 +1,110 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_DELTAROWENCODER_HPP_
+#define RTI_RECORDER_UTILS_DELTAROWENCODER_HPP_
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PrintFormatCsv.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Compares the cells of each CSV row with the previous row of the
+ * same instance to suppress the redundant ones, as configured by
+ * PrintFormatCsvProperty::delta_rows.
+ *
+ * Instances are identified by the cells of the columns of the top-level key
+ * members. Types without key members (or whose key columns are not
+ * projected) have a single instance.
+ *
+ * The previous cells of each instance are cached as text, along with the
+ * rows of its exploded sequences without their row_id, so a change in
+ * an element written into a table also counts as a change. A row is a
+ * keyframe, written with all its cells, when it's the first one of its
+ * instance and then every PrintFormatCsvProperty::keyframe_interval
+ * samples. Other rows identical to the previous one are not written. With
+ * DeltaRowKind::CHANGED_CELLS, the cells that didn't change are written
+ * empty, except the key cells. Since an empty cell can't represent a value
+ * that changed to empty, such rows are written as keyframes.
+ */
+class DeltaRowEncoder {
+public:
+    typedef PrintFormatCsv::ColumnInfo ColumnInfo;
+
+    /**
+     * @brief Creates an encoder for the rows of the specified plan
+     */
+    DeltaRowEncoder(
+            const PrintFormatCsvProperty& property,
+            const PrintFormatCsv::ColumnPlan& plan);
+
+    /**
+     * @brief Encodes a row.
+     *
+     * @param[in,out] row The cells of a row, each one preceded by the
+     *                column separator. On return, the cells to write.
+     * @param[in] tables The exploded tables with the rows of the same
+     *                   sample. They're always written in full.
+     * @param[out] is_keyframe Whether the row has all its cells
+     *
+     * @return Whether the row is written
+     */
+    bool encode(
+            std::string& row,
+            std::list<PrintFormatCsv::ExplodedTable>& tables,
+            bool& is_keyframe);
+
+private:
+    // cells of the last row of an instance
+    struct InstanceState {
+        InstanceState() : sample_count(0)
+        {
+        }
+
+        std::string row;
+        // rows of the exploded tables, without their row_id
+        std::string table_rows;
+        // position of the separator of each cell, plus the row length
+        std::vector<size_t> cell_offsets;
+        uint64_t sample_count;
+    };
+
+    void add_key_columns(
+            const ColumnInfo& info,
+            bool is_key,
+            size_t& column_index);
+
+    void split(const std::string& row);
+
+    void collect_table_rows(std::list<PrintFormatCsv::ExplodedTable>& tables);
+
+    DeltaRowKind kind_;
+    uint32_t keyframe_interval_;
+    const std::string& separator_;
+    // indexes of the cells of the key members
+    std::vector<size_t> key_columns_;
+    std::unordered_map<std::string, InstanceState> instances_;
+    // scratch buffers
+    std::vector<size_t> cell_offsets_;
+    std::string instance_key_;
+    std::string table_rows_;
+    std::string delta_row_;
+};
+
+} } }
+
+#endif
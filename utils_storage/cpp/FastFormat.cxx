@@ -0,0 +1,183 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "FastFormat.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * Two-digit lookup table: converting two digits per iteration halves the
+ * number of divisions.
+ */
+static const char DIGIT_PAIRS[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+char* format_unsigned(uint64_t value, char *output)
+{
+    // digits are generated from the end of a temporary buffer
+    char digits[FAST_FORMAT_MAX_LENGTH];
+    char *begin = digits + sizeof(digits);
+
+    while (value >= 100) {
+        uint32_t pair = static_cast<uint32_t>(value % 100) * 2;
+        value /= 100;
+        *--begin = DIGIT_PAIRS[pair + 1];
+        *--begin = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+        uint32_t pair = static_cast<uint32_t>(value) * 2;
+        *--begin = DIGIT_PAIRS[pair + 1];
+        *--begin = DIGIT_PAIRS[pair];
+    } else {
+        *--begin = static_cast<char>('0' + value);
+    }
+
+    size_t length = digits + sizeof(digits) - begin;
+    std::memcpy(output, begin, length);
+
+    return output + length;
+}
+
+char* format_integer(int64_t value, char *output)
+{
+    if (value < 0) {
+        *output++ = '-';
+        // negate as unsigned to support the minimum value
+        return format_unsigned(0 - static_cast<uint64_t>(value), output);
+    }
+
+    return format_unsigned(static_cast<uint64_t>(value), output);
+}
+
+char* format_real(double value, char *output)
+{
+    // most values round-trip with 15 digits; fall back to 17 otherwise
+    int length = std::snprintf(output, FAST_FORMAT_MAX_LENGTH, "%.15g", value);
+    if (std::strtod(output, NULL) != value) {
+        length = std::snprintf(output, FAST_FORMAT_MAX_LENGTH, "%.17g", value);
+    }
+
+    return output + length;
+}
+
+char* format_real(float value, char *output)
+{
+    int length = std::snprintf(output, FAST_FORMAT_MAX_LENGTH, "%.6g", value);
+    if (std::strtof(output, NULL) != value) {
+        length = std::snprintf(output, FAST_FORMAT_MAX_LENGTH, "%.9g", value);
+    }
+
+    return output + length;
+}
+
+void append_integer(std::string& output, int64_t value)
+{
+    char buffer[FAST_FORMAT_MAX_LENGTH];
+    output.append(buffer, format_integer(value, buffer));
+}
+
+void append_unsigned(std::string& output, uint64_t value)
+{
+    char buffer[FAST_FORMAT_MAX_LENGTH];
+    output.append(buffer, format_unsigned(value, buffer));
+}
+
+void append_real(std::string& output, double value)
+{
+    char buffer[FAST_FORMAT_MAX_LENGTH];
+    output.append(buffer, format_real(value, buffer));
+}
+
+void append_real(std::string& output, float value)
+{
+    char buffer[FAST_FORMAT_MAX_LENGTH];
+    output.append(buffer, format_real(value, buffer));
+}
+
+/*
+ * Byte to two hexadecimal digits lookup table, built once
+ */
+struct HexTable {
+    HexTable()
+    {
+        static const char HEX_DIGITS[] = "0123456789abcdef";
+        for (int i = 0; i < 256; ++i) {
+            digits[2 * i] = HEX_DIGITS[i >> 4];
+            digits[2 * i + 1] = HEX_DIGITS[i & 0x0F];
+        }
+    }
+    char digits[512];
+};
+
+void append_hex(std::string& output, const uint8_t *data, size_t length)
+{
+    static const HexTable table;
+
+    // convert in place over the final size of the output
+    size_t offset = output.length();
+    output.resize(offset + 2 * length);
+    char *out = &output[0] + offset;
+    for (size_t i = 0; i < length; ++i) {
+        std::memcpy(out, &table.digits[2 * data[i]], 2);
+        out += 2;
+    }
+}
+
+void append_base64(std::string& output, const uint8_t *data, size_t length)
+{
+    static const char BASE64_DIGITS[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    size_t offset = output.length();
+    output.resize(offset + 4 * ((length + 2) / 3));
+    char *out = &output[0] + offset;
+
+    // full groups of three bytes
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t group = (static_cast<uint32_t>(data[i]) << 16)
+                | (static_cast<uint32_t>(data[i + 1]) << 8)
+                | data[i + 2];
+        out[0] = BASE64_DIGITS[(group >> 18) & 0x3F];
+        out[1] = BASE64_DIGITS[(group >> 12) & 0x3F];
+        out[2] = BASE64_DIGITS[(group >> 6) & 0x3F];
+        out[3] = BASE64_DIGITS[group & 0x3F];
+        out += 4;
+    }
+
+    // last one or two bytes
+    if (i < length) {
+        uint32_t group = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < length) {
+            group |= static_cast<uint32_t>(data[i + 1]) << 8;
+        }
+        out[0] = BASE64_DIGITS[(group >> 18) & 0x3F];
+        out[1] = BASE64_DIGITS[(group >> 12) & 0x3F];
+        out[2] = (i + 1 < length) ? BASE64_DIGITS[(group >> 6) & 0x3F] : '=';
+        out[3] = '=';
+    }
+}
+
+} } }
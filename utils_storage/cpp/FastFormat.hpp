@@ -0,0 +1,76 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_FASTFORMAT_HPP_
+#define RTI_RECORDER_UTILS_FASTFORMAT_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Text conversion of numeric values without locale handling nor
+ * intermediate stream objects.
+ *
+ * The format_ functions write into a caller-provided buffer of at least
+ * FAST_FORMAT_MAX_LENGTH characters and return a pointer past the last
+ * character written. No null terminator is written.
+ */
+const size_t FAST_FORMAT_MAX_LENGTH = 32;
+
+/**
+ * @brief Writes the decimal representation of a signed integer
+ */
+char* format_integer(int64_t value, char *output);
+
+/**
+ * @brief Writes the decimal representation of an unsigned integer
+ */
+char* format_unsigned(uint64_t value, char *output);
+
+/**
+ * @brief Writes the shortest representation of a double that converts back
+ * to the same value.
+ */
+char* format_real(double value, char *output);
+
+/**
+ * @brief Writes the shortest representation of a float that converts back
+ * to the same value.
+ */
+char* format_real(float value, char *output);
+
+/**
+ * @brief Convenience functions to append the representation of a value to
+ * a string.
+ */
+void append_integer(std::string& output, int64_t value);
+void append_unsigned(std::string& output, uint64_t value);
+void append_real(std::string& output, double value);
+void append_real(std::string& output, float value);
+
+/**
+ * @brief Appends the hexadecimal representation of a byte buffer, two
+ * lowercase digits per byte.
+ */
+void append_hex(std::string& output, const uint8_t *data, size_t length);
+
+/**
+ * @brief Appends the base64 representation of a byte buffer (RFC 4648,
+ * with padding).
+ */
+void append_base64(std::string& output, const uint8_t *data, size_t length);
+
+} } }
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "FileContent.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+FileContent::FileContent(const std::string& path) :
+    data_(NULL),
+    size_(0)
+{
+#ifndef _WIN32
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("failed to open file=" + path);
+    }
+    struct stat file_stat;
+    if (fstat(descriptor, &file_stat) != 0) {
+        close(descriptor);
+        throw std::runtime_error("failed to get size of file=" + path);
+    }
+    size_ = static_cast<uint64_t>(file_stat.st_size);
+    if (size_ > 0) {
+        void *address = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("failed to map file=" + path);
+        }
+        data_ = static_cast<const char *>(address);
+    }
+    close(descriptor);
+#else
+    std::ifstream input(path.c_str(), std::ios::in | std::ios::binary);
+    if (!input.good()) {
+        throw std::runtime_error("failed to open file=" + path);
+    }
+    buffer_.assign(
+            std::istreambuf_iterator<char>(input),
+            std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+}
+
+FileContent::~FileContent()
+{
+#ifndef _WIN32
+    if (data_ != NULL) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+}
+
+const char* FileContent::data() const
+{
+    return data_;
+}
+
+uint64_t FileContent::size() const
+{
+    return size_;
+}
+
+} } }
@@ -0,0 +1,54 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_FILECONTENT_HPP_
+#define RTI_RECORDER_UTILS_FILECONTENT_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * This file has no dependencies on RTI Connext so it can be used by the
+ * standalone tools.
+ */
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Read-only view of the content of a file. The file is mapped into
+ * memory where supported and read into a buffer otherwise.
+ *
+ * Construction throws std::runtime_error if the file cannot be read.
+ */
+class FileContent {
+public:
+    explicit FileContent(const std::string& path);
+
+    ~FileContent();
+
+    const char* data() const;
+
+    uint64_t size() const;
+
+private:
+    FileContent(const FileContent&);
+    FileContent& operator=(const FileContent&);
+
+    const char *data_;
+    uint64_t size_;
+    std::vector<char> buffer_;
+};
+
+} } }
+
+#endif
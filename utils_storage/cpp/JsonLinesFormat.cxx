@@ -0,0 +1,214 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cmath>
+
+#include "JsonLinesFormat.hpp"
+#include "FastFormat.hpp"
+
+using namespace dds::core::xtypes;
+
+namespace rti { namespace recorder { namespace utils {
+
+JsonLinesFormat::JsonLinesFormat(const ColumnInfo& column_info) :
+    // the elements of the sequences are not limited to their columns
+    column_reader_(column_info, true),
+    output_(NULL)
+{
+    build_keys(column_info);
+}
+
+void JsonLinesFormat::build_keys(const ColumnInfo& info)
+{
+    bool is_first = true;
+    for (auto& child : info.children()) {
+        KeyEntry& entry = keys_[&child];
+        if (info.type_kind() == TypeKind::SEQUENCE_TYPE && is_first) {
+            // the length is given by the number of array elements
+            entry.ignored = true;
+        } else if (info.type_kind() == TypeKind::UNION_TYPE && is_first) {
+            append_string(entry.key, "discriminator", 13);
+            entry.key += ':';
+        } else if (!info.is_collection()) {
+            append_string(entry.key, child.name().c_str(), child.name().length());
+            entry.key += ':';
+        }
+        is_first = false;
+
+        build_keys(child);
+    }
+}
+
+void JsonLinesFormat::format(
+        DynamicData& sample,
+        int64_t timestamp,
+        std::string& output)
+{
+    output_ = &output;
+    output += "{\"timestamp\":";
+    append_integer(output, timestamp);
+    output += ",\"data\":";
+    column_reader_.read(sample, *this);
+    output += "}\n";
+}
+
+void JsonLinesFormat::append_string(
+        std::string& output,
+        const char *value,
+        size_t length)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    output += '"';
+    const char *end = value + length;
+    while (value != end) {
+        // copy runs of characters that need no escaping at once
+        const char *run = value;
+        while (run != end
+                && *run != '"'
+                && *run != '\\'
+                && static_cast<unsigned char>(*run) >= 0x20) {
+            ++run;
+        }
+        output.append(value, run);
+        if (run == end) {
+            break;
+        }
+
+        switch (*run) {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        default:
+            output += "\\u00";
+            output += HEX_DIGITS[(*run >> 4) & 0x0F];
+            output += HEX_DIGITS[*run & 0x0F];
+            break;
+        }
+        value = run + 1;
+    }
+    output += '"';
+}
+
+void JsonLinesFormat::begin_entry(const ColumnInfo& info)
+{
+    // top-level object has no key
+    if (first_entry_stack_.empty()) {
+        return;
+    }
+
+    if (first_entry_stack_.back()) {
+        first_entry_stack_.back() = false;
+    } else {
+        *output_ += ',';
+    }
+    *output_ += keys_[&info].key;
+}
+
+void JsonLinesFormat::value(
+        const ColumnInfo& info,
+        const DataColumnReader::Value& value)
+{
+    if (keys_[&info].ignored) {
+        return;
+    }
+    begin_entry(info);
+
+    std::string& output = *output_;
+    switch (info.type_kind().underlying()) {
+
+    case TypeKind::BOOLEAN_TYPE:
+        output += value.integer_value() ? "true" : "false";
+        break;
+
+    case TypeKind::CHAR_8_TYPE:
+    {
+        char character = static_cast<char>(value.integer_value());
+        append_string(output, &character, 1);
+    }
+        break;
+
+    case TypeKind::UINT_64_TYPE:
+        append_unsigned(output, value.unsigned_value());
+        break;
+
+    case TypeKind::FLOAT_32_TYPE:
+    case TypeKind::FLOAT_64_TYPE:
+        if (!std::isfinite(value.real_value())) {
+            // not representable in JSON
+            output += "null";
+        } else if (info.type_kind() == TypeKind::FLOAT_32_TYPE) {
+            append_real(output, static_cast<float>(value.real_value()));
+        } else {
+            append_real(output, value.real_value());
+        }
+        break;
+
+    case TypeKind::STRING_TYPE:
+    case TypeKind::WSTRING_TYPE:
+        append_string(
+                output,
+                value.text_value().c_str(),
+                value.text_value().length());
+        break;
+
+    default:
+        // remaining integral types, including enumerations and char16
+        append_integer(output, value.integer_value());
+        break;
+    }
+}
+
+void JsonLinesFormat::empty(const ColumnInfo&)
+{
+    // members not present are omitted
+}
+
+void JsonLinesFormat::begin_complex(const ColumnInfo& info)
+{
+    begin_entry(info);
+    *output_ += '{';
+    first_entry_stack_.push_back(true);
+}
+
+void JsonLinesFormat::end_complex(const ColumnInfo&)
+{
+    *output_ += '}';
+    first_entry_stack_.pop_back();
+}
+
+void JsonLinesFormat::begin_collection(const ColumnInfo& info)
+{
+    begin_entry(info);
+    *output_ += '[';
+    first_entry_stack_.push_back(true);
+}
+
+void JsonLinesFormat::end_collection(const ColumnInfo&)
+{
+    *output_ += ']';
+    first_entry_stack_.pop_back();
+}
+
+} } }
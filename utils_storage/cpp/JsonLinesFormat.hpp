@@ -0,0 +1,106 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_JSONLINESFORMAT_HPP_
+#define RTI_RECORDER_UTILS_JSONLINESFORMAT_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataColumnReader.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Converts DynamicData samples into JSON objects, one per line.
+ *
+ * Each line has the form:
+ *
+ *     {"timestamp":<reception timestamp>,"data":{<sample members>}}
+ *
+ * Unlike the CSV format, the nesting of the sample is preserved: structures
+ * and unions become objects and collections become arrays with only the
+ * elements present in the sample, all of them regardless of the CSV inline
+ * element columns. Unset optional members and non-selected
+ * union members are omitted. The selected member of a union is preceded by
+ * a "discriminator" entry.
+ *
+ * The member keys are escaped once on construction. Values are obtained
+ * through a DataColumnReader and written with the FastFormat functions.
+ */
+class JsonLinesFormat : private DataColumnReader::Visitor {
+public:
+    typedef PrintFormatCsv::ColumnInfo ColumnInfo;
+
+    /**
+     * @brief Creates a format for the specified ColumnInfo tree
+     *
+     * @param[in] column_info Root of the tree. It must outlive this object.
+     */
+    explicit JsonLinesFormat(const ColumnInfo& column_info);
+
+    /**
+     * @brief Appends the JSON line of the sample, including the line
+     * terminator, to the output.
+     */
+    void format(
+            dds::core::xtypes::DynamicData& sample,
+            int64_t timestamp,
+            std::string& output);
+
+    /**
+     * @brief Appends a JSON string literal with the escaped value
+     */
+    static void append_string(
+            std::string& output,
+            const char *value,
+            size_t length);
+
+private:
+    /*
+     * Pre-computed JSON representation of the key of a member
+     */
+    struct KeyEntry {
+        KeyEntry() : ignored(false)
+        {
+        }
+
+        // key followed by ':', empty for collection elements
+        std::string key;
+        // whether the column has no JSON representation (sequence length)
+        bool ignored;
+    };
+
+    void build_keys(const ColumnInfo& info);
+
+    void begin_entry(const ColumnInfo& info);
+
+    void value(
+            const ColumnInfo& info,
+            const DataColumnReader::Value& value) override;
+    void empty(const ColumnInfo& info) override;
+    void begin_complex(const ColumnInfo& info) override;
+    void end_complex(const ColumnInfo& info) override;
+    void begin_collection(const ColumnInfo& info) override;
+    void end_collection(const ColumnInfo& info) override;
+
+    DataColumnReader column_reader_;
+    std::unordered_map<const ColumnInfo *, KeyEntry> keys_;
+    // for each open object or array, whether no entry has been written yet
+    std::vector<char> first_entry_stack_;
+    std::string *output_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "LatencyHistogram.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * --- LatencyHistogramSnapshot -----------------------------------------------
+ */
+
+LatencyHistogramSnapshot::LatencyHistogramSnapshot() :
+    buckets_(LatencyHistogram::BUCKET_COUNT(), 0),
+    count_(0),
+    max_(0)
+{
+}
+
+LatencyHistogramSnapshot& LatencyHistogramSnapshot::operator+=(
+        const LatencyHistogramSnapshot& other)
+{
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+
+    return *this;
+}
+
+uint64_t LatencyHistogramSnapshot::count() const
+{
+    return count_;
+}
+
+uint64_t LatencyHistogramSnapshot::max() const
+{
+    return max_;
+}
+
+uint64_t LatencyHistogramSnapshot::value_at_percentile(double percentile) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+
+    // rank of the value, from 1 to count
+    uint64_t rank = static_cast<uint64_t>(
+            std::ceil(percentile / 100.0 * static_cast<double>(count_)));
+    rank = std::min(std::max<uint64_t>(rank, 1), count_);
+    uint64_t accumulated = 0;
+    for (uint32_t i = 0; i < buckets_.size(); i++) {
+        accumulated += buckets_[i];
+        if (accumulated >= rank) {
+            return std::min(LatencyHistogram::bucket_upper_bound(i), max_);
+        }
+    }
+
+    return max_;
+}
+
+/*
+ * --- LatencyHistogram -------------------------------------------------------
+ */
+
+LatencyHistogram::LatencyHistogram() :
+    buckets_(BUCKET_COUNT()),
+    max_(0)
+{
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogramSnapshot LatencyHistogram::snapshot() const
+{
+    LatencyHistogramSnapshot value;
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        value.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+        value.count_ += value.buckets_[i];
+    }
+    value.max_ = max_.load(std::memory_order_relaxed);
+
+    return value;
+}
+
+uint32_t LatencyHistogram::BUCKET_COUNT()
+{
+    return bucket_index(MAX_VALUE()) + 1;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(uint32_t index)
+{
+    if (index < 2 * SUB_BUCKET_COUNT()) {
+        return index;
+    }
+    uint32_t shift = index / SUB_BUCKET_COUNT() - 1;
+    uint64_t mantissa = index % SUB_BUCKET_COUNT() + SUB_BUCKET_COUNT();
+
+    return ((mantissa + 1) << shift) - 1;
+}
+
+} } }
@@ -0,0 +1,164 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_LATENCYHISTOGRAM_HPP_
+#define RTI_RECORDER_UTILS_LATENCYHISTOGRAM_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Copy of the buckets of a LatencyHistogram, to query and merge them
+ */
+class LatencyHistogramSnapshot {
+public:
+    LatencyHistogramSnapshot();
+
+    /**
+     * @brief Adds the values of another histogram
+     */
+    LatencyHistogramSnapshot& operator+=(const LatencyHistogramSnapshot& other);
+
+    /**
+     * @brief Returns the number of values recorded
+     */
+    uint64_t count() const;
+
+    /**
+     * @brief Returns the largest value recorded, or 0 if there are none
+     */
+    uint64_t max() const;
+
+    /**
+     * @brief Returns the value below or equal to which the specified
+     * percentage (0 to 100) of the values are. The value is the upper bound
+     * of its bucket, so it's at most 1/SUB_BUCKET_COUNT() larger than the
+     * recorded value, and no larger than max().
+     */
+    uint64_t value_at_percentile(double percentile) const;
+
+private:
+    friend class LatencyHistogram;
+
+    std::vector<uint64_t> buckets_;
+    uint64_t count_;
+    uint64_t max_;
+};
+
+/**
+ * @brief Log-linear histogram of durations in nanoseconds, in the style of
+ * HdrHistogram.
+ *
+ * Values below 2 * SUB_BUCKET_COUNT() have a bucket each. Larger values are
+ * grouped by powers of two, each one divided into SUB_BUCKET_COUNT() linear
+ * buckets, so the relative error of a value is below 1/SUB_BUCKET_COUNT().
+ * Values above MAX_VALUE() are recorded as MAX_VALUE().
+ *
+ * The memory is fixed: BUCKET_COUNT() counters allocated on construction.
+ * Values are recorded by a single thread with relaxed atomic loads and
+ * stores, without locks, and snapshot() can be called at any time from
+ * other threads.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /**
+     * @brief Records a value, in nanoseconds
+     */
+    void record(uint64_t value)
+    {
+        if (value > MAX_VALUE()) {
+            value = MAX_VALUE();
+        }
+        std::atomic<uint64_t>& bucket = buckets_[bucket_index(value)];
+        bucket.store(
+                bucket.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Returns a copy of the current buckets
+     */
+    LatencyHistogramSnapshot snapshot() const;
+
+    /**
+     * @brief Number of linear buckets per power of two: 32, for a relative
+     * error below 3.2%
+     */
+    static uint32_t SUB_BUCKET_COUNT()
+    {
+        return 1u << SUB_BUCKET_BITS;
+    }
+
+    /**
+     * @brief Largest value recorded: 2^40 - 1 nanoseconds (about 18
+     * minutes)
+     */
+    static uint64_t MAX_VALUE()
+    {
+        return (1ull << MAX_VALUE_BITS) - 1;
+    }
+
+    /**
+     * @brief Number of buckets of a histogram
+     */
+    static uint32_t BUCKET_COUNT();
+
+    /**
+     * @brief Returns the bucket of a value no larger than MAX_VALUE()
+     */
+    static uint32_t bucket_index(uint64_t value)
+    {
+        if (value < 2 * SUB_BUCKET_COUNT()) {
+            return static_cast<uint32_t>(value);
+        }
+        uint32_t shift = most_significant_bit(value) - SUB_BUCKET_BITS;
+
+        return shift * SUB_BUCKET_COUNT()
+                + static_cast<uint32_t>(value >> shift);
+    }
+
+    /**
+     * @brief Returns the largest value of a bucket
+     */
+    static uint64_t bucket_upper_bound(uint32_t index);
+
+private:
+    static const uint32_t SUB_BUCKET_BITS = 5;
+    static const uint32_t MAX_VALUE_BITS = 40;
+
+    static uint32_t most_significant_bit(uint64_t value)
+    {
+        uint32_t bit = 0;
+        for (uint32_t width = 32; width > 0; width /= 2) {
+            if ((value >> width) != 0) {
+                value >>= width;
+                bit += width;
+            }
+        }
+        return bit;
+    }
+
+    std::vector<std::atomic<uint64_t>> buckets_;
+    std::atomic<uint64_t> max_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "MemoryBudget.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * --- MemoryBudgetProperty ---------------------------------------------------
+ */
+
+MemoryBudgetProperty::MemoryBudgetProperty() :
+    limit_bytes_(0),
+    policy_(MemoryBudgetPolicyKind::FLUSH),
+    block_timeout_ms_(1000)
+{
+}
+
+MemoryBudgetProperty& MemoryBudgetProperty::limit_bytes(uint64_t limit)
+{
+    limit_bytes_ = limit;
+    return *this;
+}
+
+uint64_t MemoryBudgetProperty::limit_bytes() const
+{
+    return limit_bytes_;
+}
+
+MemoryBudgetProperty& MemoryBudgetProperty::policy(MemoryBudgetPolicyKind kind)
+{
+    policy_ = kind;
+    return *this;
+}
+
+MemoryBudgetPolicyKind MemoryBudgetProperty::policy() const
+{
+    return policy_;
+}
+
+MemoryBudgetProperty& MemoryBudgetProperty::block_timeout_ms(uint32_t timeout)
+{
+    block_timeout_ms_ = timeout;
+    return *this;
+}
+
+uint32_t MemoryBudgetProperty::block_timeout_ms() const
+{
+    return block_timeout_ms_;
+}
+
+/*
+ * --- MemoryUsage ------------------------------------------------------------
+ */
+
+MemoryUsage::MemoryUsage() :
+    used_bytes(0),
+    peak_bytes(0),
+    unlimited_bytes(0),
+    limit_bytes(0),
+    limit_hit_count(0)
+{
+}
+
+/*
+ * --- MemoryBudget -----------------------------------------------------------
+ */
+
+MemoryBudget::MemoryBudget(const MemoryBudgetProperty& property) :
+    property_(property),
+    used_bytes_(0),
+    peak_bytes_(0),
+    unlimited_bytes_(0),
+    limit_hit_count_(0)
+{
+}
+
+std::unique_ptr<MemoryBudget::Account> MemoryBudget::add_account(
+        bool is_limited)
+{
+    std::unique_ptr<Account> account(
+            new Account(shared_from_this(), is_limited));
+    std::lock_guard<std::mutex> guard(accounts_mutex_);
+    accounts_.push_back(account.get());
+
+    return account;
+}
+
+void MemoryBudget::remove_account(Account& account)
+{
+    // waits for a reclaim in progress, which may use the account
+    std::lock_guard<std::mutex> guard(accounts_mutex_);
+    accounts_.erase(std::remove(accounts_.begin(), accounts_.end(), &account));
+}
+
+bool MemoryBudget::reclaim(Account& requester)
+{
+    std::lock_guard<std::mutex> guard(accounts_mutex_);
+    std::vector<Account *> candidates;
+    for (auto account : accounts_) {
+        if (account != &requester
+                && account->is_limited_
+                && account->reclaimer_
+                && account->bytes() > 0) {
+            candidates.push_back(account);
+        }
+    }
+    // the bytes only change while their owner is idle, which is checked by
+    // the reclaimer, so the order is approximate
+    std::sort(candidates.begin(), candidates.end(), [](Account *a, Account *b) {
+        return a->bytes() > b->bytes();
+    });
+
+    for (auto account : candidates) {
+        {
+            std::lock_guard<std::mutex> usage_guard(mutex_);
+            if (is_within_limit()) {
+                return true;
+            }
+        }
+        account->reclaimer_(*account);
+    }
+
+    std::lock_guard<std::mutex> usage_guard(mutex_);
+    return is_within_limit();
+}
+
+bool MemoryBudget::wait_available()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return available_condition_.wait_for(
+            lock,
+            std::chrono::milliseconds(property_.block_timeout_ms()),
+            [this]() { return is_within_limit(); });
+}
+
+MemoryUsage MemoryBudget::usage() const
+{
+    MemoryUsage value;
+    std::lock_guard<std::mutex> guard(mutex_);
+    value.used_bytes = used_bytes_;
+    value.peak_bytes = peak_bytes_;
+    value.unlimited_bytes = unlimited_bytes_;
+    value.limit_bytes = property_.limit_bytes();
+    value.limit_hit_count = limit_hit_count_;
+
+    return value;
+}
+
+const MemoryBudgetProperty& MemoryBudget::property() const
+{
+    return property_;
+}
+
+bool MemoryBudget::charge(
+        const Account& account,
+        uint64_t previous_bytes,
+        uint64_t bytes)
+{
+    bool is_within = true;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!account.is_limited_) {
+            unlimited_bytes_ = unlimited_bytes_ - previous_bytes + bytes;
+            return is_within_limit();
+        }
+        used_bytes_ = used_bytes_ - previous_bytes + bytes;
+        if (used_bytes_ > peak_bytes_) {
+            peak_bytes_ = used_bytes_;
+        }
+        is_within = is_within_limit();
+        if (!is_within && bytes > previous_bytes) {
+            ++limit_hit_count_;
+        }
+    }
+    if (bytes < previous_bytes) {
+        // streams blocked on the limit may proceed
+        available_condition_.notify_all();
+    }
+
+    return is_within;
+}
+
+bool MemoryBudget::is_within_limit() const
+{
+    return property_.limit_bytes() == 0
+            || used_bytes_ <= property_.limit_bytes();
+}
+
+/*
+ * --- MemoryBudget::Account --------------------------------------------------
+ */
+
+MemoryBudget::Account::Account(
+        std::shared_ptr<MemoryBudget> budget,
+        bool is_limited) :
+    budget_(std::move(budget)),
+    is_limited_(is_limited),
+    bytes_(0)
+{
+}
+
+MemoryBudget::Account::~Account()
+{
+    budget_->remove_account(*this);
+    update(0);
+}
+
+void MemoryBudget::Account::reclaimer(Reclaimer reclaim)
+{
+    std::lock_guard<std::mutex> guard(budget_->accounts_mutex_);
+    reclaimer_ = std::move(reclaim);
+}
+
+bool MemoryBudget::Account::update(uint64_t bytes)
+{
+    uint64_t previous_bytes = bytes_.exchange(bytes, std::memory_order_relaxed);
+    return budget_->charge(*this, previous_bytes, bytes);
+}
+
+uint64_t MemoryBudget::Account::bytes() const
+{
+    return bytes_.load(std::memory_order_relaxed);
+}
+
+MemoryBudget& MemoryBudget::Account::budget()
+{
+    return *budget_;
+}
+
+} } }
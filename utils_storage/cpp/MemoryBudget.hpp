@@ -0,0 +1,232 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_MEMORYBUDGET_HPP_
+#define RTI_RECORDER_UTILS_MEMORYBUDGET_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Action taken by a stream writer whose buffers exceed the
+ * MemoryBudget
+ */
+enum class MemoryBudgetPolicyKind {
+    // writes the buffered output early and releases the buffers
+    FLUSH,
+    // releases the buffers that are not in use, keeping the buffered output
+    SHRINK,
+    // releases the buffers that are not in use, then waits for the streams
+    // stored by other threads to release memory, up to a timeout
+    BLOCK
+};
+
+/**
+ * @brief Configuration elements of the MemoryBudget
+ */
+class MemoryBudgetProperty {
+public:
+    MemoryBudgetProperty();
+
+    /**
+     * @brief Specifies the maximum number of bytes of the buffers of all the
+     * streams. With a limit of 0, the usage is only reported.
+     *
+     * Default: 0
+     */
+    MemoryBudgetProperty& limit_bytes(uint64_t limit);
+
+    /**
+     * @brief Gets the limit_bytes
+     */
+    uint64_t limit_bytes() const;
+
+    /**
+     * @brief Specifies the action taken when the limit is exceeded
+     *
+     * Default: MemoryBudgetPolicyKind::FLUSH
+     */
+    MemoryBudgetProperty& policy(MemoryBudgetPolicyKind kind);
+
+    /**
+     * @brief Gets the policy
+     */
+    MemoryBudgetPolicyKind policy() const;
+
+    /**
+     * @brief Specifies the maximum time in milliseconds a stream writer
+     * waits with MemoryBudgetPolicyKind::BLOCK. Waiting only helps when the
+     * streams are stored by several threads.
+     *
+     * Default: 1000
+     */
+    MemoryBudgetProperty& block_timeout_ms(uint32_t timeout);
+
+    /**
+     * @brief Gets the block_timeout_ms
+     */
+    uint32_t block_timeout_ms() const;
+
+private:
+    uint64_t limit_bytes_;
+    MemoryBudgetPolicyKind policy_;
+    uint32_t block_timeout_ms_;
+};
+
+/**
+ * @brief Memory usage of a MemoryBudget at a point in time
+ */
+struct MemoryUsage {
+    MemoryUsage();
+
+    // bytes charged by the accounts subject to the limit
+    uint64_t used_bytes;
+    // largest value of used_bytes
+    uint64_t peak_bytes;
+    // bytes charged by the accounts that are only reported
+    uint64_t unlimited_bytes;
+    // configured limit, 0 if there is none
+    uint64_t limit_bytes;
+    // updates that grew the usage beyond the limit
+    uint64_t limit_hit_count;
+};
+
+/**
+ * @brief Limit of the memory of the buffers of all the stream writers of a
+ * UtilsStorageWriter.
+ *
+ * Each stream writer charges the size of its buffers into an Account after
+ * each call to store(). When the total exceeds the limit, the stream writer
+ * reclaims the memory of the other accounts, largest first, and then its
+ * own, applying the configured MemoryBudgetPolicyKind. The budget is
+ * cooperative: a single sample can still grow a buffer beyond the limit,
+ * and the memory is reclaimed once the sample has been stored.
+ *
+ * Operations are thread-safe.
+ */
+class MemoryBudget : public std::enable_shared_from_this<MemoryBudget> {
+public:
+    explicit MemoryBudget(const MemoryBudgetProperty& property);
+
+    /**
+     * @brief Bytes charged by a single owner, such as a stream writer. They
+     * are released when the account is deleted.
+     */
+    class Account {
+    public:
+        /**
+         * @brief Releases the memory of the owner of an account on request
+         * of another account, updating the account. Returns false if the
+         * owner is busy and the memory cannot be released.
+         */
+        typedef std::function<bool(Account&)> Reclaimer;
+
+        ~Account();
+
+        /**
+         * @brief Sets the function that releases the memory of the owner
+         * when another account exceeds the limit. It's called from the
+         * thread of the other account, and never after this account is
+         * deleted.
+         */
+        void reclaimer(Reclaimer reclaim);
+
+        /**
+         * @brief Sets the bytes used by the owner of this account
+         *
+         * @return Whether the usage of all the accounts is within the limit
+         */
+        bool update(uint64_t bytes);
+
+        /**
+         * @brief Returns the bytes charged by this account
+         */
+        uint64_t bytes() const;
+
+        /**
+         * @brief Returns the budget this account charges
+         */
+        MemoryBudget& budget();
+
+    private:
+        friend class MemoryBudget;
+        Account(std::shared_ptr<MemoryBudget> budget, bool is_limited);
+        Account(const Account&);
+        Account& operator=(const Account&);
+
+        std::shared_ptr<MemoryBudget> budget_;
+        bool is_limited_;
+        // read by the reclaim of other accounts
+        std::atomic<uint64_t> bytes_;
+        Reclaimer reclaimer_;
+    };
+
+    /**
+     * @brief Creates an account that charges this budget. The budget must
+     * be owned by a std::shared_ptr.
+     *
+     * @param[in] is_limited Whether the bytes of the account count
+     *                       towards the limit. Otherwise, they are only
+     *                       reported.
+     */
+    std::unique_ptr<Account> add_account(bool is_limited = true);
+
+    /**
+     * @brief Reclaims the memory of the other accounts with a reclaimer,
+     * largest first, until the usage is within the limit.
+     *
+     * @return Whether the usage is within the limit
+     */
+    bool reclaim(Account& requester);
+
+    /**
+     * @brief Waits until the usage is within the limit or
+     * MemoryBudgetProperty::block_timeout_ms elapses.
+     *
+     * @return Whether the usage is within the limit
+     */
+    bool wait_available();
+
+    /**
+     * @brief Returns the current usage
+     */
+    MemoryUsage usage() const;
+
+    const MemoryBudgetProperty& property() const;
+
+private:
+    bool charge(const Account& account, uint64_t previous_bytes, uint64_t bytes);
+    bool is_within_limit() const;
+    void remove_account(Account& account);
+
+    MemoryBudgetProperty property_;
+    // protects the list of accounts, held while they are reclaimed
+    std::mutex accounts_mutex_;
+    std::vector<Account *> accounts_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_condition_;
+    uint64_t used_bytes_;
+    uint64_t peak_bytes_;
+    uint64_t unlimited_bytes_;
+    uint64_t limit_hit_count_;
+};
+
+} } }
+
+#endif
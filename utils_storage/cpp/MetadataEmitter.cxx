@@ -0,0 +1,155 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include "FastFormat.hpp"
+#include "MetadataEmitter.hpp"
+
+#define NANOSECS_PER_SEC 1000000000ll
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * Emitter of a set of columns known at compile time. The conditions on
+ * COLUMNS are constant, so the code of the columns that are not selected is
+ * removed.
+ */
+template <uint32_t COLUMNS>
+class MetadataEmitterImpl : public MetadataEmitter {
+public:
+    void emit(
+            const dds::sub::SampleInfo& info,
+            std::string& output) const override
+    {
+        const DDS_SampleInfo& native_info = info->native();
+        char buffer[FAST_FORMAT_MAX_LENGTH];
+
+        if (has_column(MetadataColumnKind::SOURCE_TIMESTAMP)) {
+            int64_t timestamp =
+                    (int64_t) native_info.source_timestamp.sec
+                    * NANOSECS_PER_SEC
+                    + native_info.source_timestamp.nanosec;
+            output += PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT();
+            output.append(buffer, format_integer(timestamp, buffer));
+        }
+        if (has_column(MetadataColumnKind::SEQUENCE_NUMBER)) {
+            const DDS_SequenceNumber_t& sequence_number =
+                    native_info.original_publication_virtual_sequence_number;
+            int64_t value =
+                    ((int64_t) sequence_number.high << 32)
+                    + sequence_number.low;
+            output += PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT();
+            output.append(buffer, format_integer(value, buffer));
+        }
+        if (has_column(MetadataColumnKind::WRITER_GUID)) {
+            output += PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT();
+            append_hex(
+                    output,
+                    native_info.original_publication_virtual_guid.value,
+                    sizeof(native_info.original_publication_virtual_guid.value));
+        }
+        if (has_column(MetadataColumnKind::INSTANCE_HANDLE)) {
+            output += PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT();
+            append_hex(
+                    output,
+                    native_info.instance_handle.keyHash.value,
+                    sizeof(native_info.instance_handle.keyHash.value));
+        }
+    }
+
+private:
+    static bool has_column(MetadataColumnKind kind)
+    {
+        return (COLUMNS & static_cast<uint32_t>(kind)) != 0;
+    }
+};
+
+/*
+ * Selects the implementation of a set of columns, from COLUMNS down to 0.
+ */
+template <uint32_t COLUMNS>
+struct MetadataEmitterFactory {
+    static MetadataEmitter* create(uint32_t columns)
+    {
+        if (columns == COLUMNS) {
+            return new MetadataEmitterImpl<COLUMNS>();
+        }
+
+        return MetadataEmitterFactory<COLUMNS - 1>::create(columns);
+    }
+};
+
+template <>
+struct MetadataEmitterFactory<0> {
+    static MetadataEmitter* create(uint32_t)
+    {
+        return new MetadataEmitterImpl<0>();
+    }
+};
+
+std::unique_ptr<MetadataEmitter> MetadataEmitter::create(uint32_t columns)
+{
+    // all the combinations of the existing flags
+    const uint32_t ALL_COLUMNS =
+            static_cast<uint32_t>(MetadataColumnKind::SOURCE_TIMESTAMP)
+            | static_cast<uint32_t>(MetadataColumnKind::SEQUENCE_NUMBER)
+            | static_cast<uint32_t>(MetadataColumnKind::WRITER_GUID)
+            | static_cast<uint32_t>(MetadataColumnKind::INSTANCE_HANDLE);
+
+    return std::unique_ptr<MetadataEmitter>(
+            MetadataEmitterFactory<ALL_COLUMNS>::create(columns & ALL_COLUMNS));
+}
+
+void MetadataEmitter::append_header(uint32_t columns, std::string& header)
+{
+    for (auto kind : column_kinds()) {
+        if ((columns & static_cast<uint32_t>(kind)) != 0) {
+            header += PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT();
+            header += column_name(kind);
+        }
+    }
+}
+
+const std::vector<MetadataColumnKind>& MetadataEmitter::column_kinds()
+{
+    static const std::vector<MetadataColumnKind> value = {
+        MetadataColumnKind::SOURCE_TIMESTAMP,
+        MetadataColumnKind::SEQUENCE_NUMBER,
+        MetadataColumnKind::WRITER_GUID,
+        MetadataColumnKind::INSTANCE_HANDLE
+    };
+
+    return value;
+}
+
+const std::string& MetadataEmitter::column_name(MetadataColumnKind kind)
+{
+    static const std::string source_timestamp_name = "source_timestamp";
+    static const std::string sequence_number_name = "sequence_number";
+    static const std::string writer_guid_name = "writer_guid";
+    static const std::string instance_handle_name = "instance_handle";
+
+    switch (kind) {
+    case MetadataColumnKind::SEQUENCE_NUMBER:
+        return sequence_number_name;
+
+    case MetadataColumnKind::WRITER_GUID:
+        return writer_guid_name;
+
+    case MetadataColumnKind::INSTANCE_HANDLE:
+        return instance_handle_name;
+
+    default:
+        return source_timestamp_name;
+    }
+}
+
+} } }
@@ -0,0 +1,75 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_METADATAEMITTER_HPP_
+#define RTI_RECORDER_UTILS_METADATAEMITTER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dds/sub/SampleInfo.hpp"
+
+#include "PrintFormatCsv.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Writes the optional metadata columns of a sample, selected with
+ * PrintFormatCsvProperty::metadata_columns.
+ *
+ * The set of columns is resolved once by create() into an implementation
+ * specialized at compile time for that set, so the columns that are not
+ * selected have no cost per row. Integer values are written with the
+ * FastFormat functions.
+ */
+class MetadataEmitter {
+public:
+    virtual ~MetadataEmitter()
+    {
+    }
+
+    /**
+     * @brief Appends the selected metadata columns of a sample, each one
+     * preceded by the column separator.
+     */
+    virtual void emit(
+            const dds::sub::SampleInfo& info,
+            std::string& output) const = 0;
+
+    /**
+     * @brief Creates the emitter of a combination of MetadataColumnKind
+     * flags
+     */
+    static std::unique_ptr<MetadataEmitter> create(uint32_t columns);
+
+    /**
+     * @brief Appends the names of the selected metadata columns to a
+     * header, each one preceded by the column separator.
+     */
+    static void append_header(uint32_t columns, std::string& header);
+
+    /**
+     * @brief Returns all the metadata column kinds, in column order
+     */
+    static const std::vector<MetadataColumnKind>& column_kinds();
+
+    /**
+     * @brief Returns the name of the column of a metadata kind, e.g.
+     * "source_timestamp"
+     */
+    static const std::string& column_name(MetadataColumnKind kind);
+};
+
+} } }
+
+#endif
@@ -10,6 +10,10 @@
  * use or inability to use the software.
  */
 
+#include <limits>
+#include <new>
+#include <type_traits>
+
 #include "PrintFormatCsv.hpp"
 
 #include "dds/core/xtypes/StructType.hpp"
@@ -17,7 +21,9 @@
 #include "dds/core/xtypes/MemberType.hpp"
 #include "dds/core/xtypes/AliasType.hpp"
 
+#include "FastFormat.hpp"
 #include "Logger.hpp"
+#include "MetadataEmitter.hpp"
 
 
 using namespace dds::core::xtypes;
@@ -63,6 +69,9 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_member(name, save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         print_format.skip_cursor(name, save_context);
         print_format.push_cursor();
@@ -75,6 +84,9 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
         // for unions, we need to skip remaining fields
         print_format.skip_cursor_siblings(save_context);
         print_format.pop_cursor();
@@ -90,12 +102,16 @@ public:
 
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_member(name, save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         print_format.skip_cursor(name, save_context);
         RTIXMLSaveContext_freeform(
                 save_context,
                 "%s",
                 PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT().c_str());
+        print_format.begin_value(save_context);
     }
 
     static void print_primitive_type_ending(
@@ -105,7 +121,11 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
+        print_format.end_value(save_context);
         ++print_format.cursor();
     }
 
@@ -117,14 +137,24 @@ public:
     {
 
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_member(name, save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         print_format.skip_cursor(name, save_context);
+        if (print_format.cursor()->is_packed()) {
+            // all the elements go into a single column
+            print_format.enter_packed_context(save_context);
+            return;
+        }
 
         // sequence members require printing the length first, which
         // needs to be computed
-        PrintFormatCsv::Cursor& array_cursor = print_format.cursor();
+        const bool is_sequence =
+                (print_format.cursor()->type_kind() == TypeKind::SEQUENCE_TYPE);
         print_format.push_cursor();
-        if (array_cursor->type_kind() == TypeKind::SEQUENCE_TYPE) {
+        print_format.item_index_stack_.push_back(0);
+        if (is_sequence) {
             print_format.enter_sequence_context(name, save_context);
             ++print_format.cursor();
         }
@@ -137,21 +167,34 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
+        if (print_format.in_packed_context()) {
+            print_format.leave_packed_context(save_context);
+            print_format.next_item(save_context);
+            return;
+        }
         print_format.leave_sequence_context(name);
         // Skip as many columns as remaining elements in array
         print_format.skip_cursor_siblings(save_context);
         print_format.pop_cursor();
+        print_format.item_index_stack_.pop_back();
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
-        ++print_format.cursor();
+        // the array may be an element of a sequence
+        print_format.next_item(save_context);
     }
 
     static void print_complex_item_beginning(
             struct DDS_PrintFormat *self,
-            struct RTIXMLSaveContext *,
+            struct RTIXMLSaveContext *save_context,
             DDS_UnsignedLong,
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_item(save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         print_format.push_cursor();
     }
@@ -163,11 +206,14 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
         // for unions, we need to skip remaining fields
         print_format.skip_cursor_siblings(save_context);
         print_format.pop_cursor();
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
-        ++print_format.cursor();
+        print_format.next_item(save_context);
     }
 
     static void print_primitive_item_beginning(
@@ -177,11 +223,19 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_item(save_context)) {
+            return;
+        }
+        if (print_format.in_packed_context()) {
+            print_format.begin_packed_item(save_context);
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         RTIXMLSaveContext_freeform(
                 save_context,
                 "%s",
                 PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT().c_str());
+        print_format.begin_value(save_context);
     }
 
     static void print_primitive_item_ending(
@@ -191,24 +245,36 @@ public:
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
+        if (print_format.in_packed_context()) {
+            print_format.end_packed_item(save_context);
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
-        ++print_format.cursor();
+        print_format.end_value(save_context);
+        print_format.next_item(save_context);
     }
 
     static void print_array_item_beginning(
-            struct DDS_PrintFormat *,
+            struct DDS_PrintFormat *self,
             struct RTIXMLSaveContext *,
             DDS_UnsignedLong,
             int)
     {
+        PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        print_format.suppress_nested();
     }
 
     static void print_array_item_ending(
-            struct DDS_PrintFormat *,
-            struct RTIXMLSaveContext *,
+            struct DDS_PrintFormat *self,
+            struct RTIXMLSaveContext *save_context,
             DDS_UnsignedLong,
             int)
     {
+        PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        print_format.end_suppressed(save_context);
     }
 
     static void print_union_discriminator_beginning(
@@ -216,20 +282,26 @@ public:
             struct RTIXMLSaveContext *save_context,
             int)
     {
+        PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_nested()) {
+            return;
+        }
         RTIXMLSaveContext_freeform(
                 save_context,
                 "%s",
                 PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT().c_str());
-        PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
     }
 
     static void print_union_discriminator_ending(
             struct DDS_PrintFormat *self,
-            struct RTIXMLSaveContext *,
+            struct RTIXMLSaveContext *save_context,
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         ++print_format.cursor();
     }
@@ -237,21 +309,27 @@ public:
     static void print_unset_optional_member_beginning(
             struct DDS_PrintFormat *self,
             struct RTIXMLSaveContext *save_context,
-            const char *,
+            const char *name,
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.suppress_member(name, save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         print_format.skip_cursor(save_context);
     }
 
     static void print_unset_optional_member_ending(
             struct DDS_PrintFormat *self,
-            struct RTIXMLSaveContext *,
+            struct RTIXMLSaveContext *save_context,
             const char *,
             int)
     {
         PrintFormatCsv& print_format = PrintFormatCsv::from_native(self);
+        if (print_format.end_suppressed(save_context)) {
+            return;
+        }
         RTI_PRINT_FORMAT_CSV_LOG_CURSOR(print_format);
         ++print_format.cursor();
     }
@@ -317,7 +395,16 @@ public:
  */
 
 PrintFormatCsvProperty::PrintFormatCsvProperty() :
-    enum_as_string_(false)
+    enum_as_string_(false),
+    exploded_sequence_min_bound_(0),
+    unbounded_sequence_inline_length_(16),
+    packed_primitive_collections_(false),
+    packed_value_separator_(" "),
+    octet_encoding_(OctetEncodingKind::BASE64),
+    dictionary_encoding_(DictionaryEncodingKind::NONE),
+    delta_rows_(DeltaRowKind::NONE),
+    keyframe_interval_(100),
+    metadata_columns_(0)
 {
 
 }
@@ -348,6 +435,122 @@ PrintFormatCsvProperty& PrintFormatCsvProperty::enum_as_string(bool the_enum_as_
     return *this;
 }
 
+uint32_t PrintFormatCsvProperty::exploded_sequence_min_bound() const
+{
+    return exploded_sequence_min_bound_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::exploded_sequence_min_bound(
+        uint32_t bound)
+{
+    exploded_sequence_min_bound_ = bound;
+
+    return *this;
+}
+
+uint32_t PrintFormatCsvProperty::unbounded_sequence_inline_length() const
+{
+    return unbounded_sequence_inline_length_;
+}
+
+PrintFormatCsvProperty&
+PrintFormatCsvProperty::unbounded_sequence_inline_length(uint32_t length)
+{
+    unbounded_sequence_inline_length_ = length;
+
+    return *this;
+}
+
+bool PrintFormatCsvProperty::packed_primitive_collections() const
+{
+    return packed_primitive_collections_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::packed_primitive_collections(
+        bool packed)
+{
+    packed_primitive_collections_ = packed;
+
+    return *this;
+}
+
+const std::string& PrintFormatCsvProperty::packed_value_separator() const
+{
+    return packed_value_separator_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::packed_value_separator(
+        const std::string& separator)
+{
+    packed_value_separator_ = separator;
+
+    return *this;
+}
+
+OctetEncodingKind PrintFormatCsvProperty::octet_encoding() const
+{
+    return octet_encoding_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::octet_encoding(
+        OctetEncodingKind kind)
+{
+    octet_encoding_ = kind;
+
+    return *this;
+}
+
+DictionaryEncodingKind PrintFormatCsvProperty::dictionary_encoding() const
+{
+    return dictionary_encoding_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::dictionary_encoding(
+        DictionaryEncodingKind kind)
+{
+    dictionary_encoding_ = kind;
+
+    return *this;
+}
+
+DeltaRowKind PrintFormatCsvProperty::delta_rows() const
+{
+    return delta_rows_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::delta_rows(DeltaRowKind kind)
+{
+    delta_rows_ = kind;
+
+    return *this;
+}
+
+uint32_t PrintFormatCsvProperty::keyframe_interval() const
+{
+    return keyframe_interval_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::keyframe_interval(
+        uint32_t interval)
+{
+    keyframe_interval_ = interval;
+
+    return *this;
+}
+
+uint32_t PrintFormatCsvProperty::metadata_columns() const
+{
+    return metadata_columns_;
+}
+
+PrintFormatCsvProperty& PrintFormatCsvProperty::metadata_columns(
+        uint32_t columns)
+{
+    metadata_columns_ = columns;
+
+    return *this;
+}
+
 
 /*
  * --- PrintFormatCsv ---------------------------------------------------------
@@ -370,6 +573,12 @@ struct PrintFormatCsvPropertyDefaultInitializer {
         value.empty_member_value_representation(
                 PrintFormatCsv::EMPTY_MEMBER_VALUE_REPRESENTATION_DEFAULT());
         value.enum_as_string(true);
+        value.exploded_sequence_min_bound(0);
+        value.unbounded_sequence_inline_length(16);
+        value.packed_primitive_collections(false);
+        value.packed_value_separator(" ");
+        value.octet_encoding(OctetEncodingKind::BASE64);
+        value.dictionary_encoding(DictionaryEncodingKind::NONE);
     }
     PrintFormatCsvProperty value;
 };
@@ -404,20 +613,42 @@ PrintFormatCsv::PrintFormatCsv(
         const PrintFormatCsvProperty& property,
         const dds::core::xtypes::DynamicType& type,
         std::ofstream& output_file) :
+        PrintFormatCsv(
+                property,
+                std::make_shared<const ColumnPlan>(type, property),
+                output_file)
+{
+}
+
+PrintFormatCsv::PrintFormatCsv(
+        const PrintFormatCsvProperty& property,
+        std::shared_ptr<const ColumnPlan> plan,
+        std::ofstream& output_file,
+        bool write_header) :
         property_(property),
         format_wrapper_(this),
-        type_(type),
+        plan_(plan),
         output_file_(output_file),
-        column_info_("", type_)
+        seq_context_count_(0),
+        value_begin_(0),
+        exploded_tables_(plan->exploded_tables()),
+        row_id_(0),
+        sample_(NULL),
+        suppressed_depth_(0),
+        suppressed_begin_(0),
+        suppressed_item_(false)
 {
 
     initialize_native();
-     // Add metadata column info
-    build_column_info(column_info_, type_);
-    std::ostringstream string_stream;
-    output_file_ << "timestamp";
-    print_type_header(string_stream, column_info_);
-    output_file << std::endl;
+    // the rows of each table are kept per object
+    auto table_it = exploded_tables_.begin();
+    for (auto sequence_info : plan_->exploded_sequences()) {
+        exploded_table_map_[sequence_info] = &(*table_it);
+        ++table_it;
+    }
+    if (write_header) {
+        output_file_ << plan_->header() << std::endl;
+    }
 
 }
 
@@ -452,8 +683,11 @@ PrintFormatCsv& PrintFormatCsv::from_native(DDS_PrintFormat* native)
 void PrintFormatCsv::start_data_conversion()
 {
     cursor_stack_.clear();
-    cursor_stack_.push_back(column_info_.first_child());
-    seq_context_stack_.clear();
+    cursor_stack_.push_back(plan_->column_info().first_child());
+    // the stacks keep their storage for the next sample
+    seq_context_count_ = 0;
+    item_index_stack_.clear();
+    suppressed_depth_ = 0;
 }
 
 std::ofstream& PrintFormatCsv::output_file()
@@ -461,6 +695,36 @@ std::ofstream& PrintFormatCsv::output_file()
     return output_file_;
 }
 
+const PrintFormatCsv::ColumnInfo& PrintFormatCsv::column_info() const
+{
+    return plan_->column_info();
+}
+
+std::list<PrintFormatCsv::ExplodedTable>& PrintFormatCsv::exploded_tables()
+{
+    return exploded_tables_;
+}
+
+void PrintFormatCsv::row_id(uint64_t the_row_id)
+{
+    row_id_ = the_row_id;
+}
+
+void PrintFormatCsv::sample(DynamicData& the_sample)
+{
+    sample_ = &the_sample;
+}
+
+bool PrintFormatCsv::has_dictionary_columns() const
+{
+    return plan_->has_dictionary_columns();
+}
+
+std::string& PrintFormatCsv::dictionary_entries()
+{
+    return dictionary_entries_;
+}
+
 PrintFormatCsv::Cursor& PrintFormatCsv::cursor()
 {
     return cursor_stack_.back();
@@ -537,6 +801,11 @@ void PrintFormatCsv::skip_cursor_columns(
         RTIXMLSaveContext* save_context,
         const std::string& empty_member_value_rep)
 {
+    if (cursor->is_element_template()) {
+        // elements in the table are not part of the row
+        return;
+    }
+
     // check for next sibling
     Cursor child_cursor = cursor->first_child();
     if (child_cursor == cursor->children().end()) {
@@ -554,7 +823,7 @@ void PrintFormatCsv::skip_cursor_columns(
 }
 
 void PrintFormatCsv::skip_cursor(
-        const std::string& member_name,
+        const char *member_name,
         struct RTIXMLSaveContext *save_context)
 {
     Cursor& cursor = this->cursor();
@@ -575,7 +844,9 @@ void PrintFormatCsv::skip_cursor(
 
 void PrintFormatCsv::build_column_info(
         ColumnInfo& current_info,
-        const dds::core::xtypes::DynamicType& member_type)
+        const dds::core::xtypes::DynamicType& member_type,
+        StringPool& names,
+        const PrintFormatCsvProperty& property)
 {
     switch (current_info.type_kind().underlying()) {
 
@@ -584,12 +855,16 @@ void PrintFormatCsv::build_column_info(
         const UnionType& union_type =
                 static_cast<const UnionType&> (member_type);
         // Add discriminator column
-        current_info.add_child(ColumnInfo(
-               union_type.name() + ".disc",
-               union_type.discriminator()));
+        current_info.add_child(
+               names.intern(union_type.name() + ".disc"),
+               union_type.discriminator());
 
         // Recurse members
-        build_complex_member_column_info(current_info, union_type);
+        build_complex_member_column_info(
+                current_info,
+                union_type,
+                names,
+                property);
         }
         break;
 
@@ -602,34 +877,53 @@ void PrintFormatCsv::build_column_info(
         if (struct_type.has_parent()) {
             build_column_info(
                     current_info,
-                    struct_type.parent());
+                    struct_type.parent(),
+                    names,
+                    property);
         }
 
         // Recurse members
-        build_complex_member_column_info(current_info, struct_type);
+        build_complex_member_column_info(
+                current_info,
+                struct_type,
+                names,
+                property);
         }
         break;
 
     case TypeKind::ARRAY_TYPE:
     {
+        TypeKind element_kind = TypeKind::NO_TYPE;
+        if (property.packed_primitive_collections()
+                && is_packable(member_type, element_kind)) {
+            current_info.packed_element_kind(element_kind);
+            break;
+        }
+
         const ArrayType& array_type =
                 static_cast<const ArrayType &>(member_type);
         std::vector<uint32_t> dimension_indexes;
         dimension_indexes.resize(array_type.dimension_count());
+        std::string element_name = current_info.name().str();
+        const size_t name_length = element_name.length();
         uint32_t element_count = 0;
         while (element_count < array_type.total_element_count()) {
-            std::ostringstream element_item;
-            element_item << current_info.name();
+            element_name.resize(name_length);
             for (uint32_t j = 0; j < array_type.dimension_count(); j++) {
-                element_item << "[" << dimension_indexes[j] << "]";
+                element_name += '[';
+                append_unsigned(element_name, dimension_indexes[j]);
+                element_name += ']';
             }
             // add array item branch
-            ColumnInfo& child = current_info.add_child(ColumnInfo(
-                    element_item.str(),
-                    array_type.content_type()));
+            ColumnInfo& child = current_info.add_child(
+                    names.intern(element_name),
+                    array_type.content_type());
+            child.element_index(element_count);
             build_column_info(
                     child,
-                    array_type.content_type());
+                    array_type.content_type(),
+                    names,
+                    property);
 
             ++dimension_indexes[array_type.dimension_count() - 1];
             for (uint32_t j = array_type.dimension_count() - 1; j > 0; j--) {
@@ -646,28 +940,66 @@ void PrintFormatCsv::build_column_info(
 
     case TypeKind::SEQUENCE_TYPE:
     {
+        TypeKind element_kind = TypeKind::NO_TYPE;
+        if (property.packed_primitive_collections()
+                && is_packable(member_type, element_kind)) {
+            // the length is given by the number of elements in the cell
+            current_info.packed_element_kind(element_kind);
+            break;
+        }
+
         const SequenceType& sequence_type =
                 static_cast<const SequenceType &> (member_type);
 
         /* length column*/
-        std::ostringstream length_item;
-        length_item << current_info.name() << ".length";
-        current_info.add_child(ColumnInfo(
-                length_item.str(),
-                rti::core::xtypes::PrimitiveType<int32_t>()));
+        current_info.add_child(
+                names.intern(current_info.name().str() + ".length"),
+                rti::core::xtypes::PrimitiveType<int32_t>());
+
+        uint32_t element_column_count = sequence_type.bounds();
+        bool is_exploded = property.exploded_sequence_min_bound() > 0
+                && sequence_type.bounds()
+                        >= property.exploded_sequence_min_bound();
+        if (is_exploded) {
+            element_column_count = 0;
+        } else if (is_unbounded(sequence_type.bounds())) {
+            // the elements that don't fit are spilled into the table
+            is_exploded = true;
+            element_column_count = property.unbounded_sequence_inline_length();
+        }
 
         /* item columns */
-        for (uint32_t i = 0; i < sequence_type.bounds(); i++) {
-            std::ostringstream element_item;
-            element_item << current_info.name() << "[" << i << "]";
+        std::string element_name = current_info.name().str();
+        const size_t name_length = element_name.length();
+        for (uint32_t i = 0; i < element_column_count; i++) {
+            element_name.resize(name_length);
+            element_name += '[';
+            append_unsigned(element_name, i);
+            element_name += ']';
 
             // add array item branch
-            ColumnInfo& child = current_info.add_child(ColumnInfo(
-                    element_item.str(),
-                    sequence_type.content_type()));
+            ColumnInfo& child = current_info.add_child(
+                    names.intern(element_name),
+                    sequence_type.content_type());
+            child.element_index(i);
             build_column_info(
                     child,
+                    sequence_type.content_type(),
+                    names,
+                    property);
+        }
+
+        if (is_exploded) {
+            /* single template for the elements in the table */
+            current_info.exploded(true);
+            ColumnInfo& child = current_info.add_child(
+                    names.intern(current_info.name().str() + "[]"),
                     sequence_type.content_type());
+            build_column_info(
+                    child,
+                    sequence_type.content_type(),
+                    names,
+                    property);
         }
     }
         break;
@@ -679,71 +1011,583 @@ void PrintFormatCsv::build_column_info(
         current_info.type_kind(alias_type.related_type().kind());
         build_column_info(
                 current_info,
-                alias_type.related_type());
+                alias_type.related_type(),
+                names,
+                property);
     }
 
         break;
 
     default:
         // leaf reached
+        current_info.dictionary_encoded(
+                is_dictionary_encoded(current_info.type_kind(), property));
         break;
     }
 }
 
+bool PrintFormatCsv::is_unbounded(uint32_t bounds)
+{
+    // unbounded sequences report the maximum length as their bound
+    return bounds >= static_cast<uint32_t>(std::numeric_limits<int32_t>::max());
+}
+
+bool PrintFormatCsv::is_packable(
+        const dds::core::xtypes::DynamicType& collection_type,
+        dds::core::xtypes::TypeKind& element_kind)
+{
+    const DynamicType *content_type =
+            (collection_type.kind() == TypeKind::ARRAY_TYPE)
+            ? &static_cast<const ArrayType &>(collection_type).content_type()
+            : &static_cast<const SequenceType &>(collection_type).content_type();
+    while (content_type->kind() == TypeKind::ALIAS_TYPE) {
+        content_type =
+                &static_cast<const AliasType *>(content_type)->related_type();
+    }
+
+    switch (content_type->kind().underlying()) {
+
+    case TypeKind::BOOLEAN_TYPE:
+    case TypeKind::CHAR_8_TYPE:
+    case TypeKind::CHAR_16_TYPE:
+    case TypeKind::UINT_8_TYPE:
+    case TypeKind::INT_16_TYPE:
+    case TypeKind::UINT_16_TYPE:
+    case TypeKind::INT_32_TYPE:
+    case TypeKind::UINT_32_TYPE:
+    case TypeKind::INT_64_TYPE:
+    case TypeKind::UINT_64_TYPE:
+    case TypeKind::FLOAT_32_TYPE:
+    case TypeKind::FLOAT_64_TYPE:
+    case TypeKind::ENUMERATION_TYPE:
+        element_kind = content_type->kind();
+        return true;
+
+    default:
+        // strings, long double and constructed types
+        return false;
+    }
+}
+
 template<typename ComplexType>
 void PrintFormatCsv::build_complex_member_column_info(
         ColumnInfo& current_info,
-        const ComplexType& member_type)
+        const ComplexType& member_type,
+        StringPool& names,
+        const PrintFormatCsvProperty& property)
 {
 
     // recurse members
     for (uint32_t i = 0; i < member_type.member_count(); i++) {
         auto& complex_member = member_type.member(i);
         // complex member: branch tree
-        ColumnInfo& child = current_info.add_child(ColumnInfo(
-                complex_member.name(),
-                complex_member.type()));
+        ColumnInfo& child = current_info.add_child(
+                names.intern(complex_member.name()),
+                complex_member.type());
+        child.optional(
+                current_info.type_kind() == TypeKind::UNION_TYPE
+                || complex_member.is_optional());
         build_column_info(
                 child,
-                complex_member.type());
+                complex_member.type(),
+                names,
+                property);
 
     }
 
 }
 
 void PrintFormatCsv::print_type_header(
-        std::ostringstream& string_stream,
+        std::string& header,
+        std::string& prefix,
         const ColumnInfo& current_info)
 {
+    if (current_info.children().empty()) {
+        if (current_info.has_parent()) {
+            header += COLUMN_SEPARATOR_DEFAULT();
+            header += prefix;
+        }
+        return;
+    }
+
     for (auto& child : current_info.children()) {
-        std::ostringstream child_stream;
+        if (child.is_element_template()) {
+            // elements are part of the exploded table
+            break;
+        }
 
-        if (!current_info.has_parent()) {
-            child_stream << ",";
+        const size_t prefix_length = prefix.length();
+        if (!child.is_collection() || child.is_packed()) {
+            prefix += '.';
+            prefix += child.name();
         }
+        print_type_header(header, prefix, child);
+        prefix.resize(prefix_length);
+    }
+}
 
-        child_stream << string_stream.str();
-        if (!child.is_collection()) {
-            child_stream << "." ;
-            child_stream << child.name();
+void PrintFormatCsv::build_exploded_tables(
+        const ColumnInfo& current_info,
+        const std::string& index_header,
+        std::list<ExplodedTable>& tables,
+        std::vector<const ColumnInfo *>& sequences)
+{
+    if (!current_info.is_exploded()) {
+        for (auto& child : current_info.children()) {
+            build_exploded_tables(child, index_header, tables, sequences);
         }
+        return;
+    }
+
+    // exploded sequences within the inline elements have their own tables
+    for (auto& child : current_info.children()) {
+        if (!child.is_element_template()) {
+            build_exploded_tables(child, index_header, tables, sequences);
+        }
+    }
 
-        print_type_header(child_stream, child);
+    // the table is named after the sequence length column, minus ".length"
+    std::string name = current_info.first_child()->path();
+    name.resize(name.length() - 7);
+    std::string element_index_header = index_header + "," + name + ".index";
+
+    tables.push_back(ExplodedTable());
+    ExplodedTable& table = tables.back();
+    table.name_ = name;
+    table.header_ = "row_id" + element_index_header;
+    const ColumnInfo& element_info = current_info.children().back();
+    std::string prefix = element_info.path();
+    print_type_header(table.header_, prefix, element_info);
+    sequences.push_back(&current_info);
+
+    // nested exploded sequences
+    build_exploded_tables(
+            element_info,
+            element_index_header,
+            tables,
+            sequences);
+}
+
+bool PrintFormatCsv::apply_projection(
+        ColumnInfo& current_info,
+        std::string& prefix,
+        const ColumnProjection& projection)
+{
+    if (current_info.children_.empty()) {
+        return projection.matches(prefix);
     }
 
+    // the sequence length and the union discriminator are kept with their
+    // member
+    const bool has_leading_column =
+            current_info.type_kind() == TypeKind::SEQUENCE_TYPE
+            || current_info.type_kind() == TypeKind::UNION_TYPE;
+    bool is_selected = false;
+    ColumnInfo *child = current_info.children_.first_;
+    while (child != NULL) {
+        const size_t prefix_length = prefix.length();
+        if (!child->is_collection() || child->is_packed()) {
+            prefix += '.';
+            prefix += child->name();
+        }
+        bool is_child_selected = false;
+        if (child->is_element_template()
+                || (current_info.is_collection() && child->is_collection())) {
+            // elements kept or removed as a whole
+            is_child_selected =
+                    has_projected_columns(*child, prefix, projection);
+        } else {
+            is_child_selected = apply_projection(*child, prefix, projection);
+        }
+        prefix.resize(prefix_length);
+
+        is_selected = is_selected || is_child_selected;
+        if (is_child_selected
+                || child->is_element_template()
+                || (has_leading_column
+                        && child == current_info.children_.first_)) {
+            child = child->next_;
+        } else {
+            child = current_info.children_.erase(*child);
+        }
+    }
+
+    return is_selected;
+}
+
+bool PrintFormatCsv::has_projected_columns(
+        const ColumnInfo& current_info,
+        std::string& prefix,
+        const ColumnProjection& projection)
+{
     if (current_info.children().empty()) {
-        output_file() << string_stream.str();
+        return projection.matches(prefix);
+    }
+
+    for (auto& child : current_info.children()) {
+        const size_t prefix_length = prefix.length();
+        if (!child.is_collection() || child.is_packed()) {
+            prefix += '.';
+            prefix += child.name();
+        }
+        bool is_selected = has_projected_columns(child, prefix, projection);
+        prefix.resize(prefix_length);
+        if (is_selected) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PrintFormatCsv::has_member(const char *member_name)
+{
+    // top-level members have no parent cursor
+    const ColumnInfo& parent_info = (cursor_stack_.size() > 1)
+            ? *parent_cursor()
+            : plan_->column_info();
+    for (Cursor it = cursor(); it != parent_info.children().end(); ++it) {
+        if (it->name() == member_name) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PrintFormatCsv::suppress_member(
+        const char *member_name,
+        RTIXMLSaveContext *save_context)
+{
+    if (suppress_nested()) {
+        return true;
+    }
+    if (!plan_->is_projected() || has_member(member_name)) {
+        return false;
+    }
+
+    suppressed_depth_ = 1;
+    suppressed_begin_ = save_context->outputStringLength;
+    suppressed_item_ = false;
+    return true;
+}
+
+bool PrintFormatCsv::suppress_item(RTIXMLSaveContext *save_context)
+{
+    if (suppress_nested()) {
+        return true;
+    }
+    if (!plan_->is_projected() || in_packed_context()) {
+        return false;
+    }
+
+    // the element has columns if the cursor points to it
+    Cursor& cursor = this->cursor();
+    if (cursor != parent_cursor()->children().end()
+            && (cursor->is_element_template()
+                    || cursor->element_index() == item_index_stack_.back())) {
+        return false;
+    }
+
+    suppressed_depth_ = 1;
+    suppressed_begin_ = save_context->outputStringLength;
+    suppressed_item_ = true;
+    return true;
+}
+
+bool PrintFormatCsv::suppress_nested()
+{
+    if (suppressed_depth_ == 0) {
+        return false;
+    }
+
+    ++suppressed_depth_;
+    return true;
+}
+
+bool PrintFormatCsv::end_suppressed(RTIXMLSaveContext *save_context)
+{
+    if (suppressed_depth_ == 0) {
+        return false;
+    }
+
+    --suppressed_depth_;
+    if (suppressed_depth_ > 0) {
+        return true;
+    }
+
+    if (save_context->sout != NULL) {
+        rewind_output(save_context, suppressed_begin_);
+    }
+    if (suppressed_item_) {
+        ++item_index_stack_.back();
+        // suppressed elements precede the ones spilled into the table
+        SequenceContext *context = sequence_context();
+        if (context != NULL
+                && context->table_ != NULL
+                && context->depth_ == cursor_stack_.size()) {
+            ++context->element_count_;
+        }
+    }
+
+    return true;
+}
+
+void PrintFormatCsv::next_item(RTIXMLSaveContext *save_context)
+{
+    if (!item_index_stack_.empty() && cursor()->parent().is_collection()) {
+        // the completed member is an element
+        ++item_index_stack_.back();
+    }
+
+    SequenceContext *top_context = sequence_context();
+    if (top_context == NULL
+            || top_context->table_ == NULL
+            || top_context->depth_ != cursor_stack_.size()) {
+        ++cursor();
+        return;
+    }
+
+    SequenceContext& context = *top_context;
+    if (!context.spilling_) {
+        // inline element of an exploded sequence, the elements after the
+        // last one are spilled into the table
+        ++cursor();
+        ++context.element_count_;
+        context.spilling_ = cursor()->is_element_template();
+        context.elements_begin_ = save_context->outputStringLength;
+        return;
+    }
+
+    /*
+     * Element of an exploded sequence in the table: the cursor remains at
+     * the element template. On the actual conversion, the printed element is
+     * moved into the table. On the length computation, the elements remain
+     * in the output, so the computed length is an upper bound.
+     */
+    if (save_context->sout != NULL) {
+        std::string& rows = context.table_->rows_;
+        append_unsigned(rows, row_id_);
+        for (size_t i = 0; i < seq_context_count_; i++) {
+            const SequenceContext& outer_context = seq_context_stack_[i];
+            if (outer_context.spilling_) {
+                rows += COLUMN_SEPARATOR_DEFAULT();
+                append_unsigned(rows, outer_context.element_count_);
+            }
+        }
+        rows.append(
+                save_context->sout + context.elements_begin_,
+                save_context->sout + save_context->outputStringLength);
+        rows += '\n';
+
+        rewind_output(save_context, context.elements_begin_);
+    }
+    ++context.element_count_;
+}
+
+void PrintFormatCsv::rewind_output(
+        RTIXMLSaveContext *save_context,
+        size_t position)
+{
+    save_context->outputStringLength = position;
+    save_context->sout[position] = '\0';
+}
+
+bool PrintFormatCsv::is_dictionary_encoded(
+        const dds::core::xtypes::TypeKind& type_kind,
+        const PrintFormatCsvProperty& property)
+{
+    switch (type_kind.underlying()) {
+
+    case TypeKind::ENUMERATION_TYPE:
+        // numeric enumerations are already codes
+        return property.enum_as_string()
+                && property.dictionary_encoding() != DictionaryEncodingKind::NONE;
+
+    case TypeKind::STRING_TYPE:
+    case TypeKind::WSTRING_TYPE:
+        return property.dictionary_encoding()
+                == DictionaryEncodingKind::ENUMS_AND_STRINGS;
+
+    default:
+        return false;
+    }
+}
+
+bool PrintFormatCsv::has_dictionary_columns(const ColumnInfo& current_info)
+{
+    if (current_info.is_dictionary_encoded()) {
+        return true;
+    }
+    for (auto& child : current_info.children()) {
+        if (has_dictionary_columns(child)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PrintFormatCsv::begin_value(RTIXMLSaveContext *save_context)
+{
+    value_begin_ = save_context->outputStringLength;
+}
+
+void PrintFormatCsv::end_value(RTIXMLSaveContext *save_context)
+{
+    const ColumnInfo& info = *cursor();
+    if (!info.is_dictionary_encoded()) {
+        return;
+    }
+
+    if (save_context->sout == NULL) {
+        // a code may be longer than its value: reserve the longest code
+        RTIXMLSaveContext_freeform(save_context, "%*s", 10, "");
+        return;
+    }
+
+    ColumnDictionary& dictionary = dictionaries_[&info];
+    dictionary_key_.assign(
+            save_context->sout + value_begin_,
+            save_context->sout + save_context->outputStringLength);
+    // look up first: inserting copies the key even if it's already present
+    auto code_it = dictionary.codes_.find(dictionary_key_);
+    bool is_new = (code_it == dictionary.codes_.end());
+    if (is_new) {
+        code_it = dictionary.codes_.insert(std::make_pair(
+                dictionary_key_,
+                static_cast<uint32_t>(dictionary.codes_.size()))).first;
+    }
+    uint32_t code = code_it->second;
+    if (is_new) {
+        // new entry
+        dictionary_entries_ += info.path();
+        dictionary_entries_ += COLUMN_SEPARATOR_DEFAULT();
+        append_unsigned(dictionary_entries_, code);
+        dictionary_entries_ += COLUMN_SEPARATOR_DEFAULT();
+        dictionary_entries_ += dictionary_key_;
+        dictionary_entries_ += '\n';
+    }
+
+    rewind_output(save_context, value_begin_);
+    char code_as_str[FAST_FORMAT_MAX_LENGTH];
+    *format_unsigned(code, code_as_str) = '\0';
+    RTIXMLSaveContext_freeform(save_context, "%s", code_as_str);
+}
+
+bool PrintFormatCsv::in_packed_context() const
+{
+    return packed_context_.active_;
+}
+
+void PrintFormatCsv::enter_packed_context(RTIXMLSaveContext *save_context)
+{
+    packed_context_.active_ = true;
+    packed_context_.octets_ =
+            (cursor()->packed_element_kind() == TypeKind::UINT_8_TYPE);
+    packed_context_.element_count_ = 0;
+
+    RTIXMLSaveContext_freeform(
+            save_context,
+            "%s",
+            COLUMN_SEPARATOR_DEFAULT().c_str());
+    packed_context_.element_begin_ = save_context->outputStringLength;
+    if (packed_context_.octets_ && save_context->sout != NULL) {
+        read_packed_octets(*sample_, 0, 0);
     }
 }
 
+void PrintFormatCsv::read_packed_octets(
+        DynamicData& data,
+        size_t level,
+        size_t index_level)
+{
+    const ColumnInfo& info = *cursor_stack_[level];
+    // collection elements are accessed by their 1-based index
+    const bool is_element = info.parent().is_collection();
+    if (level + 1 == cursor_stack_.size()) {
+        if (is_element) {
+            data.get_values(
+                    item_index_stack_[index_level] + 1,
+                    packed_context_.octet_buffer_);
+        } else {
+            data.get_values(info.name().str(), packed_context_.octet_buffer_);
+        }
+        return;
+    }
+
+    if (is_element) {
+        LoanedDynamicData loan =
+                data.loan_value(item_index_stack_[index_level] + 1);
+        read_packed_octets(loan.get(), level + 1, index_level + 1);
+    } else {
+        LoanedDynamicData loan = data.loan_value(info.name().str());
+        read_packed_octets(loan.get(), level + 1, index_level);
+    }
+}
+
+void PrintFormatCsv::begin_packed_item(RTIXMLSaveContext *save_context)
+{
+    if (!packed_context_.octets_ && packed_context_.element_count_ > 0) {
+        RTIXMLSaveContext_freeform(
+                save_context,
+                "%s",
+                property_.packed_value_separator().c_str());
+    }
+}
+
+void PrintFormatCsv::end_packed_item(RTIXMLSaveContext *)
+{
+    ++packed_context_.element_count_;
+}
+
+void PrintFormatCsv::leave_packed_context(RTIXMLSaveContext *save_context)
+{
+    packed_context_.active_ = false;
+    if (!packed_context_.octets_) {
+        return;
+    }
+
+    if (save_context->sout == NULL) {
+        /*
+         * On the length computation the printed elements remain in the
+         * output. Reserve the space of the encoding in addition, so the
+         * computed length is an upper bound.
+         */
+        RTIXMLSaveContext_freeform(
+                save_context,
+                "%*s",
+                static_cast<int>(2 * packed_context_.element_count_ + 4),
+                "");
+        return;
+    }
+
+    // the printed octets are replaced by the encoding of the ones read
+    rewind_output(save_context, packed_context_.element_begin_);
+    std::string& encoded = packed_context_.encoded_octets_;
+    encoded.clear();
+    const uint8_t *octets = packed_context_.octet_buffer_.data();
+    size_t octet_count = packed_context_.octet_buffer_.size();
+    if (property_.octet_encoding() == OctetEncodingKind::HEX) {
+        append_hex(encoded, octets, octet_count);
+    } else {
+        append_base64(encoded, octets, octet_count);
+    }
+    RTIXMLSaveContext_freeform(save_context, "%s", encoded.c_str());
+}
+
 void PrintFormatCsv::enter_sequence_context(
-        const std::string& name,
+        const char *name,
         RTIXMLSaveContext* save_context)
 {
-    seq_context_stack_.push_back(SequenceContext(name));
+    if (seq_context_count_ == seq_context_stack_.size()) {
+        seq_context_stack_.push_back(SequenceContext());
+    }
+    seq_context_stack_[seq_context_count_].reset(name);
+    ++seq_context_count_;
 
     if (save_context->sout != NULL) {
-        seq_context_stack_.back().length_ptr_ =
+        sequence_context()->length_ptr_ =
                 save_context->sout
                 + save_context->outputStringLength
                 + PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT().length();
@@ -753,48 +1597,58 @@ void PrintFormatCsv::enter_sequence_context(
             "%s%s",
             PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT().c_str(),
             SEQ_LENGTH_TOKEN().c_str());
+
+    // the sequence is the parent of the current cursor (length column)
+    const ColumnInfo& sequence_info = *parent_cursor();
+    if (sequence_info.is_exploded()) {
+        SequenceContext& context = *sequence_context();
+        context.table_ = exploded_table_map_[&sequence_info];
+        context.depth_ = cursor_stack_.size();
+        // the length column is followed by the first inline element, if any
+        context.spilling_ =
+                std::next(sequence_info.first_child())->is_element_template();
+        context.elements_begin_ = save_context->outputStringLength;
+    }
 }
 
-void PrintFormatCsv::leave_sequence_context(const std::string& name)
+void PrintFormatCsv::leave_sequence_context(const char *name)
 {
-    if (seq_context_stack_.empty()
-            || seq_context_stack_.back().name_ != name) {
+    SequenceContext *context = sequence_context();
+    if (context == NULL || context->name_ != name) {
         return;
     }
-    SequenceContext& context = seq_context_stack_.back();
-    if (context.length_ptr_ != NULL) {
+    if (context->length_ptr_ != NULL) {
         /*
-         * compute sequence length: current cursor points to the last received
-         * item. The length is hence given by counting back to the beginning of
-         * the cursor, which points to item[0]
+         * compute sequence length: the position of the next element is the
+         * number of received elements, including the ones without columns
          */
-        PrintFormatCsv::CursorStack::const_reverse_iterator cursor_stack_it =
-                cursor_stack_.crbegin();
-        ++cursor_stack_it;
-        PrintFormatCsv::Cursor parent_cursor = *cursor_stack_it;
-        int32_t length = 0;
-        Cursor cursor = parent_cursor->children().begin();
-        for (++cursor; cursor != this->cursor(); ++cursor) {
-            ++length;
-        }
-
-        std::ostringstream length_stream;
-        length_stream << length;
-        std::string length_as_str = length_stream.str();
+        char length_as_str[FAST_FORMAT_MAX_LENGTH];
+        int32_t length_size = static_cast<int32_t>(
+                format_unsigned(item_index_stack_.back(), length_as_str)
+                - length_as_str);
         int32_t padding_count =
                 SEQ_LENGTH_TOKEN().length()
-                - length_as_str.length();
+                - length_size;
         for (int i = 0; i < padding_count; i++) {
-            context.length_ptr_[i] = ' ';
+            context->length_ptr_[i] = ' ';
         }
-        context.length_ptr_ += padding_count;
-        for (int i = 0; i < length_as_str.length(); i++) {
-            context.length_ptr_[i] = length_as_str.c_str()[i];
+        context->length_ptr_ += padding_count;
+        for (int i = 0; i < length_size; i++) {
+            context->length_ptr_[i] = length_as_str[i];
         }
 
     }
 
-    seq_context_stack_.pop_back();
+    --seq_context_count_;
+}
+
+PrintFormatCsv::SequenceContext* PrintFormatCsv::sequence_context()
+{
+    if (seq_context_count_ == 0) {
+        return NULL;
+    }
+
+    return &seq_context_stack_[seq_context_count_ - 1];
 }
 
 
@@ -803,18 +1657,26 @@ void PrintFormatCsv::leave_sequence_context(const std::string& name)
  * --- ColumnInfo -------------------------------------------------------------
  */
 
-PrintFormatCsv::ColumnInfo::ColumnInfo() :
-    parent_(NULL),
-    type_kind_(TypeKind::NO_TYPE)
-{
-}
+// the nodes are freed with their arena, without running their destructor
+static_assert(
+        std::is_trivially_destructible<PrintFormatCsv::ColumnInfo>::value,
+        "ColumnInfo must be trivially destructible");
 
 PrintFormatCsv::ColumnInfo::ColumnInfo(
-        const std::string& name,
-        const dds::core::xtypes::DynamicType& type) :
+        const ArenaString& name,
+        const dds::core::xtypes::DynamicType& type,
+        Arena& arena) :
+    arena_(&arena),
     parent_(NULL),
+    previous_(NULL),
+    next_(NULL),
     name_(name),
-    type_kind_(type.kind())
+    type_kind_(type.kind()),
+    optional_(false),
+    exploded_(false),
+    packed_element_kind_(TypeKind::NO_TYPE),
+    dictionary_encoded_(false),
+    element_index_(0)
 {
 }
 
@@ -825,12 +1687,17 @@ PrintFormatCsv::ColumnInfo::parent() const
 }
 
 PrintFormatCsv::ColumnInfo&
-PrintFormatCsv::ColumnInfo::add_child(ColumnInfo&& info)
+PrintFormatCsv::ColumnInfo::add_child(
+        const ArenaString& name,
+        const dds::core::xtypes::DynamicType& type)
 {
-    children_.push_back(std::move(info));
-    children_.back().parent_ = this;
+    ColumnInfo *child = new (arena_->allocate(
+            sizeof(ColumnInfo),
+            alignof(ColumnInfo))) ColumnInfo(name, type, *arena_);
+    child->parent_ = this;
+    children_.push_back(*child);
 
-    return children_.back();
+    return *child;
 }
 
 PrintFormatCsv::ColumnInfo::iterator
@@ -859,7 +1726,7 @@ PrintFormatCsv::ColumnInfo::children() const
     return children_;
 }
 
-const std::string& PrintFormatCsv::ColumnInfo::name() const
+const ArenaString& PrintFormatCsv::ColumnInfo::name() const
 {
     return name_;
 }
@@ -875,12 +1742,260 @@ bool PrintFormatCsv::ColumnInfo::is_collection() const
             || type_kind().underlying() == TypeKind::ARRAY_TYPE;
 }
 
+bool PrintFormatCsv::ColumnInfo::is_optional() const
+{
+    return optional_;
+}
+
+PrintFormatCsv::ColumnInfo& PrintFormatCsv::ColumnInfo::optional(
+        bool is_optional)
+{
+    optional_ = is_optional;
+
+    return *this;
+}
+
+bool PrintFormatCsv::ColumnInfo::is_exploded() const
+{
+    return exploded_;
+}
+
+PrintFormatCsv::ColumnInfo& PrintFormatCsv::ColumnInfo::exploded(
+        bool is_exploded)
+{
+    exploded_ = is_exploded;
+
+    return *this;
+}
+
+bool PrintFormatCsv::ColumnInfo::is_packed() const
+{
+    return packed_element_kind_ != TypeKind::NO_TYPE;
+}
+
+const TypeKind PrintFormatCsv::ColumnInfo::packed_element_kind() const
+{
+    return packed_element_kind_;
+}
+
+PrintFormatCsv::ColumnInfo& PrintFormatCsv::ColumnInfo::packed_element_kind(
+        const dds::core::xtypes::TypeKind element_kind)
+{
+    packed_element_kind_ = element_kind;
+
+    return *this;
+}
+
+bool PrintFormatCsv::ColumnInfo::is_dictionary_encoded() const
+{
+    return dictionary_encoded_;
+}
+
+PrintFormatCsv::ColumnInfo& PrintFormatCsv::ColumnInfo::dictionary_encoded(
+        bool is_encoded)
+{
+    dictionary_encoded_ = is_encoded;
+
+    return *this;
+}
+
+uint32_t PrintFormatCsv::ColumnInfo::element_index() const
+{
+    return element_index_;
+}
+
+PrintFormatCsv::ColumnInfo& PrintFormatCsv::ColumnInfo::element_index(
+        uint32_t index)
+{
+    element_index_ = index;
+
+    return *this;
+}
+
+bool PrintFormatCsv::ColumnInfo::is_element_template() const
+{
+    return has_parent()
+            && parent_->is_exploded()
+            && this == &parent_->children_.back();
+}
+
+std::string PrintFormatCsv::ColumnInfo::path() const
+{
+    // same naming rules as print_type_header: collection names are already
+    // part of their element names
+    std::vector<const ColumnInfo *> ancestors;
+    for (const ColumnInfo *info = this; info->has_parent(); info = info->parent_) {
+        if (!info->is_collection() || info->is_packed()) {
+            ancestors.push_back(info);
+        }
+    }
+
+    std::string result;
+    for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it) {
+        result += ".";
+        result += (*it)->name();
+    }
+
+    return result;
+}
+
+
+/*
+ * --- ColumnInfo::info_list --------------------------------------------------
+ */
+
+void PrintFormatCsv::ColumnInfo::info_list::push_back(ColumnInfo& info)
+{
+    info.previous_ = last_;
+    info.next_ = NULL;
+    if (last_ != NULL) {
+        last_->next_ = &info;
+    } else {
+        first_ = &info;
+    }
+    last_ = &info;
+    ++size_;
+}
+
+PrintFormatCsv::ColumnInfo *
+PrintFormatCsv::ColumnInfo::info_list::erase(ColumnInfo& info)
+{
+    if (info.previous_ != NULL) {
+        info.previous_->next_ = info.next_;
+    } else {
+        first_ = info.next_;
+    }
+    if (info.next_ != NULL) {
+        info.next_->previous_ = info.previous_;
+    } else {
+        last_ = info.previous_;
+    }
+    --size_;
+
+    return info.next_;
+}
+
+
+/*
+ * --- ExplodedTable ----------------------------------------------------------
+ */
+
+const std::string& PrintFormatCsv::ExplodedTable::name() const
+{
+    return name_;
+}
+
+const std::string& PrintFormatCsv::ExplodedTable::header() const
+{
+    return header_;
+}
+
+std::string& PrintFormatCsv::ExplodedTable::rows()
+{
+    return rows_;
+}
+
+
+/*
+ * --- ColumnPlan -------------------------------------------------------------
+ */
+
+PrintFormatCsv::ColumnPlan::ColumnPlan(
+        const dds::core::xtypes::DynamicType& type,
+        const PrintFormatCsvProperty& property,
+        const ColumnProjection& projection) :
+    type_(type),
+    column_info_(ArenaString(), type_, arena_),
+    has_dictionary_columns_(false),
+    projection_(projection)
+{
+    // the names are kept in the arena once the tree is built
+    StringPool names(arena_);
+    build_column_info(column_info_, type_, names, property);
+    if (!projection_.selects_all()) {
+        std::string prefix;
+        if (!apply_projection(column_info_, prefix, projection_)) {
+            throw dds::core::Error(
+                    "column projection=" + projection_.patterns()
+                    + " selects no column of type=" + type_.name());
+        }
+    }
+    build_exploded_tables(
+            column_info_,
+            "",
+            exploded_tables_,
+            exploded_sequences_);
+    has_dictionary_columns_ =
+            PrintFormatCsv::has_dictionary_columns(column_info_);
+
+    header_ = "timestamp";
+    MetadataEmitter::append_header(property.metadata_columns(), header_);
+    if (!exploded_tables_.empty()) {
+        // key to join the rows of the exploded tables
+        header_ += ",row_id";
+    }
+    if (property.delta_rows() == DeltaRowKind::CHANGED_CELLS) {
+        // whether the row has all its cells
+        header_ += ",keyframe";
+    }
+    std::string prefix;
+    print_type_header(header_, prefix, column_info_);
+}
+
+const dds::core::xtypes::DynamicType& PrintFormatCsv::ColumnPlan::type() const
+{
+    return type_;
+}
+
+const PrintFormatCsv::ColumnInfo&
+PrintFormatCsv::ColumnPlan::column_info() const
+{
+    return column_info_;
+}
+
+const std::string& PrintFormatCsv::ColumnPlan::header() const
+{
+    return header_;
+}
+
+const std::list<PrintFormatCsv::ExplodedTable>&
+PrintFormatCsv::ColumnPlan::exploded_tables() const
+{
+    return exploded_tables_;
+}
+
+const std::vector<const PrintFormatCsv::ColumnInfo *>&
+PrintFormatCsv::ColumnPlan::exploded_sequences() const
+{
+    return exploded_sequences_;
+}
+
+bool PrintFormatCsv::ColumnPlan::has_dictionary_columns() const
+{
+    return has_dictionary_columns_;
+}
+
+const ColumnProjection& PrintFormatCsv::ColumnPlan::projection() const
+{
+    return projection_;
+}
+
+bool PrintFormatCsv::ColumnPlan::is_projected() const
+{
+    return !projection_.selects_all();
+}
+
+uint64_t PrintFormatCsv::ColumnPlan::memory_size() const
+{
+    return arena_.reserved_size() + header_.capacity();
+}
+
 
 std::ostream& operator<<(
         std::ostream& os,
         const PrintFormatCsv::ColumnInfo& info)
 {
-    os << "name: " << info.name_
+    os << "name: " << info.name()
             << ", parent: " << info.parent_
             << ", children: " << info.children_.size();
 
@@ -13,18 +13,79 @@
 #ifndef RTI_RECORDER_UTILS_PRINTFORMATCSV_HPP_
 #define RTI_RECORDER_UTILS_PRINTFORMATCSV_HPP_
 
+#include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
 #include <stack>
+#include <unordered_map>
+#include <vector>
 
 #include "ndds/ndds_c.h"
+#include "dds/core/xtypes/DynamicData.hpp"
 #include "dds/core/xtypes/DynamicType.hpp"
 #include "dds/core/xtypes/MemberType.hpp"
 
+#include "Arena.hpp"
+#include "ColumnProjection.hpp"
 #include "PrintFormatWrapper.hpp"
 
 namespace rti { namespace recorder { namespace utils {
 
+/**
+ * @brief Representation of the octets of a packed collection
+ */
+enum class OctetEncodingKind {
+    HEX,
+    BASE64
+};
+
+/**
+ * @brief Selection of the columns whose values are replaced by integer codes
+ * of a per-column dictionary.
+ */
+enum class DictionaryEncodingKind {
+    // no columns are encoded
+    NONE,
+    // enumeration columns, when represented with their label
+    ENUMS,
+    // enumeration and string columns
+    ENUMS_AND_STRINGS
+};
+
+/**
+ * @brief Selection of the rows written by comparing each sample with the
+ * previous one of the same instance.
+ */
+enum class DeltaRowKind {
+    // all the rows are written
+    NONE,
+    // rows identical to the previous one are not written
+    CHANGED_ROWS,
+    // rows identical to the previous one are not written, and the cells of
+    // the other rows that didn't change are empty
+    CHANGED_CELLS
+};
+
+/**
+ * @brief Optional metadata columns with SampleInfo fields. They can be
+ * combined as flags and are written in this order, after the timestamp
+ * column.
+ */
+enum class MetadataColumnKind : uint32_t {
+    // source timestamp in nanoseconds
+    SOURCE_TIMESTAMP = 0x1,
+    // sequence number of the sample in its writer
+    SEQUENCE_NUMBER = 0x2,
+    // GUID of the writer of the sample, in hexadecimal
+    WRITER_GUID = 0x4,
+    // instance handle (key hash) of the sample, in hexadecimal
+    INSTANCE_HANDLE = 0x8
+};
+
 /**
  * @brief Configuration elements of the CSV output format
  *
@@ -61,10 +122,169 @@ public:
      */
     bool enum_as_string() const;
 
+    /**
+     * @brief Specifies the minimum bound of a sequence member for it to be
+     * represented with the exploded layout.
+     *
+     * Instead of one column per possible element, an exploded sequence only
+     * keeps its length column in the main table. Its elements are written
+     * into a separate child table, one row per element present, with the
+     * row_id of the sample and the element index as keys.
+     *
+     * A value of 0 disables the exploded layout.
+     *
+     * Default: 0
+     */
+    PrintFormatCsvProperty& exploded_sequence_min_bound(uint32_t bound);
+
+    /**
+     * @brief Gets the exploded_sequence_min_bound
+     */
+    uint32_t exploded_sequence_min_bound() const;
+
+    /**
+     * @brief Specifies the number of elements of an unbounded sequence that
+     * have their own columns in the main table.
+     *
+     * The remaining elements of a sample are spilled into a child table,
+     * with the same layout as the exploded sequences, so the number of
+     * columns doesn't depend on the bound of the type. Unbounded sequences
+     * that use the exploded layout have no element columns.
+     *
+     * Formats other than CSV have no child tables and drop the elements
+     * that don't fit.
+     *
+     * Default: 16
+     */
+    PrintFormatCsvProperty& unbounded_sequence_inline_length(uint32_t length);
+
+    /**
+     * @brief Gets the unbounded_sequence_inline_length
+     */
+    uint32_t unbounded_sequence_inline_length() const;
+
+    /**
+     * @brief Indicates whether arrays and sequences of primitive types and
+     * enumerations are represented as a single packed cell instead of one
+     * column per element.
+     *
+     * Octet collections are encoded as specified by octet_encoding. The
+     * elements of other collections are separated by
+     * packed_value_separator.
+     *
+     * Default: false
+     */
+    PrintFormatCsvProperty& packed_primitive_collections(bool packed);
+
+    /**
+     * @brief Gets the packed_primitive_collections
+     */
+    bool packed_primitive_collections() const;
+
+    /**
+     * @brief Specifies the separator of the elements in a packed cell. It
+     * cannot contain the column separator.
+     *
+     * Default: [space]
+     */
+    PrintFormatCsvProperty& packed_value_separator(const std::string& separator);
+
+    /**
+     * @brief Gets the packed_value_separator
+     */
+    const std::string& packed_value_separator() const;
+
+    /**
+     * @brief Selects the encoding of the packed octet collections.
+     *
+     * Default: OctetEncodingKind::BASE64
+     */
+    PrintFormatCsvProperty& octet_encoding(OctetEncodingKind kind);
+
+    /**
+     * @brief Gets the octet_encoding
+     */
+    OctetEncodingKind octet_encoding() const;
+
+    /**
+     * @brief Selects the columns whose values are replaced by an integer
+     * code.
+     *
+     * Codes are assigned per column in order of first appearance, starting
+     * at 0. The code of each new value is notified as a dictionary entry
+     * that contains the column name, the code and the value.
+     *
+     * This encoding is intended for columns with a low number of distinct
+     * values.
+     *
+     * Default: DictionaryEncodingKind::NONE
+     */
+    PrintFormatCsvProperty& dictionary_encoding(DictionaryEncodingKind kind);
+
+    /**
+     * @brief Gets the dictionary_encoding
+     */
+    DictionaryEncodingKind dictionary_encoding() const;
+
+    /**
+     * @brief Selects the rows written by comparing the cells of each row
+     * with the previous row of the same instance. Instances are identified
+     * by the columns of the key members.
+     *
+     * With DeltaRowKind::CHANGED_CELLS, a keyframe column follows the
+     * metadata columns and indicates whether the row has all its cells (1)
+     * or only the changed ones (0).
+     *
+     * Default: DeltaRowKind::NONE
+     */
+    PrintFormatCsvProperty& delta_rows(DeltaRowKind kind);
+
+    /**
+     * @brief Gets the delta_rows
+     */
+    DeltaRowKind delta_rows() const;
+
+    /**
+     * @brief Specifies the number of samples of an instance between rows
+     * that are written with all their cells, whether they changed or not.
+     *
+     * A value of 0 writes only the first row of each instance with all its
+     * cells. Only applies when delta_rows is not DeltaRowKind::NONE.
+     *
+     * Default: 100
+     */
+    PrintFormatCsvProperty& keyframe_interval(uint32_t interval);
+
+    /**
+     * @brief Gets the keyframe_interval
+     */
+    uint32_t keyframe_interval() const;
+
+    /**
+     * @brief Specifies the metadata columns written after the timestamp
+     * column, as a combination of MetadataColumnKind flags.
+     *
+     * Default: 0 (none)
+     */
+    PrintFormatCsvProperty& metadata_columns(uint32_t columns);
+
+    /**
+     * @brief Gets the metadata_columns
+     */
+    uint32_t metadata_columns() const;
 
 private:
     std::string empty_member_value_rep_;
     bool enum_as_string_;
+    uint32_t exploded_sequence_min_bound_;
+    uint32_t unbounded_sequence_inline_length_;
+    bool packed_primitive_collections_;
+    std::string packed_value_separator_;
+    OctetEncodingKind octet_encoding_;
+    DictionaryEncodingKind dictionary_encoding_;
+    DeltaRowKind delta_rows_;
+    uint32_t keyframe_interval_;
+    uint32_t metadata_columns_;
 
 };
 
@@ -100,6 +320,11 @@ class NativePrintFormatCsv;
  * - Sequences
  * - Unions
  *
+ * When the column plan has a ColumnProjection, the members and elements
+ * without columns are still notified by the DDS_PrintFormat callbacks. They
+ * are suppressed: the callbacks within them are ignored and their output is
+ * removed once they end.
+ *
  * @see DDS_PrintFormat
  */
 class PrintFormatCsv {
@@ -108,31 +333,144 @@ public:
     /**
      * @brief Definition of the information associated with a data column.
      *
+     * The nodes of a ColumnInfo tree and their names are allocated from the
+     * Arena of its ColumnPlan. The children of a node are linked through
+     * the nodes themselves, and a node is trivially destructible, so the
+     * tree is built without a heap allocation per node and it's freed with
+     * the blocks of the arena, without visiting the nodes.
      */
     class ColumnInfo {
     public:
-        typedef std::list<ColumnInfo> info_list;
-        typedef info_list::const_iterator iterator;
+        /**
+         * @brief Forward iterator over the children of a ColumnInfo
+         */
+        class iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef ColumnInfo value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const ColumnInfo *pointer;
+            typedef const ColumnInfo& reference;
+
+            iterator() : info_(NULL)
+            {
+            }
+
+            explicit iterator(const ColumnInfo *info) : info_(info)
+            {
+            }
+
+            reference operator*() const
+            {
+                return *info_;
+            }
+
+            pointer operator->() const
+            {
+                return info_;
+            }
+
+            iterator& operator++()
+            {
+                info_ = info_->next_;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator previous = *this;
+                info_ = info_->next_;
+                return previous;
+            }
+
+            bool operator==(const iterator& other) const
+            {
+                return info_ == other.info_;
+            }
+
+            bool operator!=(const iterator& other) const
+            {
+                return info_ != other.info_;
+            }
+
+        private:
+            const ColumnInfo *info_;
+        };
 
         /**
-         * @brief Default constructor required to be used with C++ collections.
+         * @brief Children of a ColumnInfo, in member order
          */
-        ColumnInfo();
+        class info_list {
+        public:
+            typedef ColumnInfo::iterator const_iterator;
+
+            info_list() : first_(NULL), last_(NULL), size_(0)
+            {
+            }
+
+            iterator begin() const
+            {
+                return iterator(first_);
+            }
+
+            iterator end() const
+            {
+                return iterator();
+            }
+
+            bool empty() const
+            {
+                return first_ == NULL;
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            const ColumnInfo& back() const
+            {
+                return *last_;
+            }
+
+        private:
+            friend class ColumnInfo;
+            friend class PrintFormatCsv;
+
+            void push_back(ColumnInfo& info);
+
+            // unlinks a child, whose memory stays in the arena, and
+            // returns the next one
+            ColumnInfo* erase(ColumnInfo& info);
+
+            ColumnInfo *first_;
+            ColumnInfo *last_;
+            size_t size_;
+        };
 
         /**
          * @brief Creates a ColumnInfo for a member
          *
-         * @param[in] name Name of the member
+         * @param[in] name Name of the member, which must remain valid while
+         *                 the info exists, such as a StringPool entry.
          * @param[in] type Type of the member
+         * @param[in] arena Arena where the children are allocated
          */
         ColumnInfo(
-                const std::string& name,
-                const dds::core::xtypes::DynamicType& type);
+                const ArenaString& name,
+                const dds::core::xtypes::DynamicType& type,
+                Arena& arena);
 
         /**
-         * @brief Adds the specified info as child of this info.
+         * @brief Adds a child info for the specified member, allocated from
+         * the arena of this info.
+         *
+         * @param[in] name Name of the member, as for the constructor.
+         * @param[in] type Type of the member
          */
-        ColumnInfo& add_child(ColumnInfo&& info);
+        ColumnInfo& add_child(
+                const ArenaString& name,
+                const dds::core::xtypes::DynamicType& type);
 
         /**
          * @brief Returns the parent of this info/
@@ -162,7 +500,7 @@ public:
         /**
          * @brief Returns the name of the member this info represents
          */
-        const std::string& name() const;
+        const ArenaString& name() const;
 
         /**
          * @brief Returns whether this info has a parent or not
@@ -175,6 +513,86 @@ public:
          */
         bool is_collection() const;
 
+        /**
+         * @brief Returns whether the member this info represents may not be
+         * present in a sample, such as an optional or union member.
+         */
+        bool is_optional() const;
+
+        /**
+         * @brief Sets whether the member this info represents is optional.
+         */
+        ColumnInfo& optional(bool is_optional);
+
+        /**
+         * @brief Returns whether the sequence member this info represents
+         * uses the exploded layout. The children of an exploded sequence
+         * are the length column, the columns of the inline elements, if
+         * any, and the template of the elements written into the table.
+         */
+        bool is_exploded() const;
+
+        /**
+         * @brief Returns whether this info is the template of the elements
+         * of an exploded sequence that are written into its table. Element
+         * templates have no columns in the main table.
+         */
+        bool is_element_template() const;
+
+        /**
+         * @brief Sets whether the sequence member this info represents uses
+         * the exploded layout.
+         */
+        ColumnInfo& exploded(bool is_exploded);
+
+        /**
+         * @brief Returns whether the collection member this info represents
+         * is packed into a single column, in which case it has no children.
+         */
+        bool is_packed() const;
+
+        /**
+         * @brief Returns the element type kind of a packed collection, or
+         * TypeKind::NO_TYPE if the collection is not packed.
+         */
+        const dds::core::xtypes::TypeKind packed_element_kind() const;
+
+        /**
+         * @brief Sets the element type kind of a packed collection
+         */
+        ColumnInfo& packed_element_kind(
+                const dds::core::xtypes::TypeKind element_kind);
+
+        /**
+         * @brief Returns whether the values of the leaf column this info
+         * represents are replaced by dictionary codes.
+         */
+        bool is_dictionary_encoded() const;
+
+        /**
+         * @brief Sets whether the values of the leaf column this info
+         * represents are replaced by dictionary codes.
+         */
+        ColumnInfo& dictionary_encoded(bool is_encoded);
+
+        /**
+         * @brief Returns the 0-based index of the collection element this
+         * info represents. Multi-dimensional arrays use the flattened index.
+         */
+        uint32_t element_index() const;
+
+        /**
+         * @brief Sets the index of the collection element this info
+         * represents.
+         */
+        ColumnInfo& element_index(uint32_t index);
+
+        /**
+         * @brief Returns the column name of this info as it appears in
+         * the type header, e.g. ".m_complex_array[1].m_long".
+         */
+        std::string path() const;
+
         /**
          * @brief String representation of a ColumnInfo
          */
@@ -183,32 +601,243 @@ public:
                 const ColumnInfo& info);
 
     private:
+        // column plans remove the children without selected columns
+        friend class PrintFormatCsv;
+        Arena *arena_;
         const ColumnInfo *parent_;
-        std::string name_;
+        // siblings, linked by the info_list of the parent
+        ColumnInfo *previous_;
+        ColumnInfo *next_;
+        ArenaString name_;
         dds::core::xtypes::TypeKind type_kind_;
+        bool optional_;
+        bool exploded_;
+        dds::core::xtypes::TypeKind packed_element_kind_;
+        bool dictionary_encoded_;
+        uint32_t element_index_;
         info_list children_;
     };
 
+    /**
+     * @brief Child table with the elements of an exploded sequence.
+     *
+     * The rows of the table are accumulated in memory while a sample is
+     * converted, and must be consumed by the owner of the PrintFormatCsv
+     * after each conversion.
+     */
+    class ExplodedTable {
+    public:
+        /**
+         * @brief Returns the name of the table, which is the column name of
+         * the sequence, e.g. ".m_struct.m_sequence"
+         */
+        const std::string& name() const;
+
+        /**
+         * @brief Returns the header row of the table, without line
+         * terminator.
+         *
+         * The first column is the row_id of the sample, followed by the
+         * index of the element in each enclosing exploded sequence and the
+         * columns of the element.
+         */
+        const std::string& header() const;
+
+        /**
+         * @brief Returns the rows generated by the last conversions, each
+         * one terminated with a new line.
+         */
+        std::string& rows();
+
+    private:
+        friend class PrintFormatCsv;
+        std::string name_;
+        std::string header_;
+        std::string rows_;
+    };
+
+    /**
+     * @brief Immutable column layout of a type: the ColumnInfo tree, the
+     * type header and the exploded tables.
+     *
+     * A plan only depends on the type, on the PrintFormatCsvProperty
+     * elements that affect the columns and on the ColumnProjection, so a
+     * single plan can be shared by all the streams of the same type.
+     *
+     * With a projection, the ColumnInfo tree is pruned on construction and
+     * only keeps the members with selected columns. The length of a
+     * sequence and the discriminator of a union are kept along with their
+     * member. The elements of a collection whose elements are collections,
+     * and the elements written into an exploded table, are kept or removed
+     * as a whole.
+     *
+     * @see ColumnPlanCache
+     */
+    class ColumnPlan {
+    public:
+        /**
+         * @brief Builds the column layout of the specified type
+         *
+         * @param[in] type Type of the samples
+         * @param[in] property Configuration elements. Only the ones that
+         *                     affect the column layout are used.
+         * @param[in] projection Columns to keep. Throws dds::core::Error if
+         *                       it doesn't select any column of the type.
+         */
+        ColumnPlan(
+                const dds::core::xtypes::DynamicType& type,
+                const PrintFormatCsvProperty& property,
+                const ColumnProjection& projection = ColumnProjection());
+
+        /**
+         * @brief Returns the type this plan was built for
+         */
+        const dds::core::xtypes::DynamicType& type() const;
+
+        /**
+         * @brief Returns the root of the ColumnInfo tree
+         */
+        const ColumnInfo& column_info() const;
+
+        /**
+         * @brief Returns the type header row, including the metadata
+         * columns, without line terminator.
+         */
+        const std::string& header() const;
+
+        /**
+         * @brief Returns the exploded tables, without rows, in type header
+         * order.
+         */
+        const std::list<ExplodedTable>& exploded_tables() const;
+
+        /**
+         * @brief Returns the exploded sequence info of each exploded table,
+         * in the same order.
+         */
+        const std::vector<const ColumnInfo *>& exploded_sequences() const;
+
+        /**
+         * @brief Returns whether any column of the type is dictionary encoded.
+         */
+        bool has_dictionary_columns() const;
+
+        /**
+         * @brief Returns the projection this plan was built with
+         */
+        const ColumnProjection& projection() const;
+
+        /**
+         * @brief Returns whether columns of the type were removed by the
+         * projection.
+         */
+        bool is_projected() const;
+
+        /**
+         * @brief Returns the bytes of the ColumnInfo tree and the type
+         * header
+         */
+        uint64_t memory_size() const;
+
+    private:
+        ColumnPlan(const ColumnPlan&);
+        ColumnPlan& operator=(const ColumnPlan&);
+
+        dds::core::xtypes::DynamicType type_;
+        // storage of the ColumnInfo tree, declared first to outlive it
+        Arena arena_;
+        ColumnInfo column_info_;
+        std::string header_;
+        std::list<ExplodedTable> exploded_tables_;
+        std::vector<const ColumnInfo *> exploded_sequences_;
+        bool has_dictionary_columns_;
+        ColumnProjection projection_;
+    };
+
     /**
      * @brief State needed for a sequence member.
+     *
+     * The contexts are kept once their sequence ends and reused by the next
+     * sequence at the same level, so the name storage is not reallocated
+     * for every sample.
      */
 private:
     class SequenceContext {
     public:
-        SequenceContext(const std::string& name)
-            : name_(name), length_ptr_(NULL)
+        SequenceContext()
+            : length_ptr_(NULL),
+              table_(NULL),
+              depth_(0),
+              spilling_(false),
+              elements_begin_(0),
+              element_count_(0)
         {
         }
 
+        void reset(const char *name)
+        {
+            name_.assign(name);
+            length_ptr_ = NULL;
+            table_ = NULL;
+            depth_ = 0;
+            spilling_ = false;
+            elements_begin_ = 0;
+            element_count_ = 0;
+        }
+
     private:
         friend class PrintFormatCsv;
         std::string name_;
         char* length_ptr_;
+        // exploded layout only
+        ExplodedTable *table_;
+        // size of the cursor stack while an element is printed
+        size_t depth_;
+        // whether the current element is written into the table
+        bool spilling_;
+        // output position where each element is printed before it's moved
+        // into the table
+        size_t elements_begin_;
+        uint32_t element_count_;
+    };
+
+    /**
+     * @brief State needed for a packed collection member.
+     */
+    class PackedContext {
+    public:
+        PackedContext()
+            : active_(false),
+              octets_(false),
+              element_begin_(0),
+              element_count_(0)
+        {
+        }
+
+    private:
+        friend class PrintFormatCsv;
+        bool active_;
+        bool octets_;
+        // output position of the first element
+        size_t element_begin_;
+        uint32_t element_count_;
+        // octets read from the sample
+        std::vector<uint8_t> octet_buffer_;
+        std::string encoded_octets_;
+    };
+
+    /**
+     * @brief Codes assigned to the values of a dictionary encoded column.
+     */
+    class ColumnDictionary {
+    private:
+        friend class PrintFormatCsv;
+        std::unordered_map<std::string, uint32_t> codes_;
     };
 
 public:
     typedef ColumnInfo::iterator Cursor;
-    typedef std::list<Cursor> CursorStack;
+    typedef std::vector<Cursor> CursorStack;
 
 
     /**
@@ -244,6 +873,24 @@ public:
             const dds::core::xtypes::DynamicType& type,
             std::ofstream& output_file);
 
+    /**
+     * @brief Constructor with a column layout that may be shared with
+     * other objects.
+     *
+     * @param[in] property Configuration elements
+     * @param[in] plan Column layout of the samples to be converted. It must
+     *                 have been built with the same property.
+     * @param[in] output_file Output file where the converted samples are written.
+     * @param[in] write_header Whether the type header is written into the
+     *                         output file. It's already there when the
+     *                         file is resumed from a checkpoint.
+     */
+    PrintFormatCsv(
+            const PrintFormatCsvProperty& property,
+            std::shared_ptr<const ColumnPlan> plan,
+            std::ofstream& output_file,
+            bool write_header = true);
+
     /*
      * @brief Returns this object's configuration property
      */
@@ -266,6 +913,61 @@ public:
      */
     std::ofstream& output_file();
 
+    /**
+     * @brief Returns the root of the ColumnInfo tree for the type associated
+     * with this object.
+     */
+    const ColumnInfo& column_info() const;
+
+    /**
+     * @brief Returns the child tables of the exploded sequences of the type,
+     * in type header order.
+     */
+    std::list<ExplodedTable>& exploded_tables();
+
+    /**
+     * @brief Sets the row identifier of the next samples to convert, which
+     * is used as key in the rows of the exploded tables.
+     */
+    void row_id(uint64_t the_row_id);
+
+    /**
+     * @brief Sets the sample of the next conversions, from which the
+     * octets of the packed collections are read. It must be the sample
+     * passed to the DynamicData formatter.
+     */
+    void sample(dds::core::xtypes::DynamicData& the_sample);
+
+    /**
+     * @brief Returns whether any column of the type is dictionary encoded.
+     */
+    bool has_dictionary_columns() const;
+
+    /**
+     * @brief Returns the dictionary entries created by the last conversions,
+     * one per line with the format: <column name>,<code>,<value>.
+     *
+     * The value is the last field, so it may contain the column separator.
+     * Entries must be consumed by the owner of the PrintFormatCsv after each
+     * conversion.
+     */
+    std::string& dictionary_entries();
+
+    /**
+     * @brief Generates the ColumnInfo tree for the specified type.
+     *
+     * @param current_info Reference to the info associated with a member
+     * @param member_type Type of the member represented by current_info.
+     * @param names Pool where the names of the created infos are interned
+     * @param property Configuration elements that affect the column layout,
+     *                 such as PrintFormatCsvProperty::exploded_sequence_min_bound
+     */
+    static void build_column_info(
+            ColumnInfo& current_info,
+            const dds::core::xtypes::DynamicType& member_type,
+            StringPool& names,
+            const PrintFormatCsvProperty& property = PROPERTY_DEFAULT());
+
 private:
     friend class NativePrintFormatCsv;
     static const std::string& SEQ_LENGTH_TOKEN();
@@ -329,20 +1031,9 @@ private:
      *                         are written.
      */
     void skip_cursor(
-            const std::string& member_name,
+            const char *member_name,
             RTIXMLSaveContext *save_context);
 
-    /**
-     * @brief Generates the ColumnInfo tree for the type associated with
-     * this object.
-     *
-     * @param current_info Reference to the info associated with a member
-     * @param member_type Type of the member represented by current_info.
-     */
-    void build_column_info(
-            ColumnInfo& current_info,
-            const dds::core::xtypes::DynamicType& member_type);
-
     /**
      * @brief Recursively traverses the complex member to build the column info,
      *
@@ -355,9 +1046,183 @@ private:
      *
      */
     template <typename ComplexType>
-    void build_complex_member_column_info(
+    static void build_complex_member_column_info(
             ColumnInfo& current_info,
-            const ComplexType& member_type);
+            const ComplexType& member_type,
+            StringPool& names,
+            const PrintFormatCsvProperty& property);
+
+    /**
+     * @brief Creates an ExplodedTable for each exploded sequence under
+     * the specified info.
+     *
+     * @param[in] current_info Element of the ColumnInfo tree
+     * @param[in] index_header Index columns of the enclosing exploded
+     *                         sequences.
+     * @param[out] tables The created tables
+     * @param[out] sequences The exploded sequence of each created table
+     */
+    static void build_exploded_tables(
+            const ColumnInfo& current_info,
+            const std::string& index_header,
+            std::list<ExplodedTable>& tables,
+            std::vector<const ColumnInfo *>& sequences);
+
+    /**
+     * @brief Removes the children of the specified info without columns
+     * selected by the projection.
+     *
+     * @param[in,out] current_info Element of the ColumnInfo tree
+     * @param[in,out] prefix Column name of current_info, as in
+     *                       print_type_header. It's restored before
+     *                       returning.
+     * @param[in] projection The selected columns
+     * @return Whether current_info has selected columns
+     */
+    static bool apply_projection(
+            ColumnInfo& current_info,
+            std::string& prefix,
+            const ColumnProjection& projection);
+
+    /**
+     * @brief Returns whether the specified info has columns selected by the
+     * projection, without removing any.
+     *
+     * @see apply_projection
+     */
+    static bool has_projected_columns(
+            const ColumnInfo& current_info,
+            std::string& prefix,
+            const ColumnProjection& projection);
+
+    /**
+     * @brief Returns whether the member with the specified name is at or
+     * after the current cursor. Members without columns are not found.
+     */
+    bool has_member(const char *member_name);
+
+    /**
+     * @brief Checks whether the member notified by a beginning callback has
+     * to be suppressed, either because it's within a suppressed member or
+     * because it has no columns. In that case, the callback has to return
+     * without further processing.
+     */
+    bool suppress_member(
+            const char *member_name,
+            RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Same as suppress_member for collection elements, which are
+     * identified by their position in the collection.
+     */
+    bool suppress_item(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Same as suppress_member for the callbacks that never start a
+     * suppression, which only need to be tracked within one.
+     */
+    bool suppress_nested();
+
+    /**
+     * @brief Checks whether the ending callback is within a suppressed
+     * member. The output of the suppressed member is removed when its own
+     * ending callback is notified. In both cases, the callback has to
+     * return without further processing.
+     */
+    bool end_suppressed(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Moves the cursor to the next element.
+     *
+     * If the current element belongs to an exploded sequence, the cursor
+     * stays in the element template and the printed element is moved from
+     * the output into a row of the sequence table.
+     */
+    void next_item(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Removes the output written from the specified position.
+     * Only applicable when the output is written, not on length computation.
+     */
+    static void rewind_output(
+            RTIXMLSaveContext *save_context,
+            size_t position);
+
+    /**
+     * @brief Returns whether a packed collection is being printed
+     */
+    bool in_packed_context() const;
+
+    /**
+     * @brief Returns whether the values of a leaf column with the
+     * specified type kind are dictionary encoded.
+     */
+    static bool is_dictionary_encoded(
+            const dds::core::xtypes::TypeKind& type_kind,
+            const PrintFormatCsvProperty& property);
+
+    /**
+     * @brief Returns whether there's a dictionary encoded column under the
+     * specified info.
+     */
+    static bool has_dictionary_columns(const ColumnInfo& current_info);
+
+    /**
+     * @brief Marks the beginning of the value of the current cursor.
+     */
+    void begin_value(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Completes the value of the current cursor. For dictionary
+     * encoded columns, the printed value is replaced by its code.
+     */
+    void end_value(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Returns whether a sequence with the specified bound is
+     * unbounded.
+     */
+    static bool is_unbounded(uint32_t bounds);
+
+    /**
+     * @brief Returns whether the specified collection type can be packed
+     * into a single column and the kind of its elements.
+     */
+    static bool is_packable(
+            const dds::core::xtypes::DynamicType& collection_type,
+            dds::core::xtypes::TypeKind& element_kind);
+
+    /**
+     * @brief Starts printing the packed collection pointed to by the
+     * current cursor. Octet collections are read from the sample at once.
+     */
+    void enter_packed_context(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Reads the octets of the packed collection pointed to by the
+     * current cursor, walking the cursor stack from the specified level.
+     */
+    void read_packed_octets(
+            dds::core::xtypes::DynamicData& data,
+            size_t level,
+            size_t index_level);
+
+    /**
+     * @brief Writes the separator before an element of a packed collection.
+     */
+    void begin_packed_item(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Completes an element of a packed collection. The printed
+     * octets are discarded when the collection is completed.
+     */
+    void end_packed_item(RTIXMLSaveContext *save_context);
+
+    /**
+     * @brief Completes the packed collection. Octet collections are
+     * written with the configured encoding.
+     */
+    void leave_packed_context(RTIXMLSaveContext *save_context);
 
     /**
      *
@@ -365,14 +1230,22 @@ private:
      *
      * The type header is a row with as many columns as possible members of
      * a data sample can have. See manual for details on the format of the
-     * type header.
+     * type header. The elements of exploded sequences are skipped.
+     *
+     * The column name prefix is extended with the name of each member on
+     * the way down and restored on the way up, so the header is generated
+     * in time linear to its length.
      *
-     * @param[in] current_info a top-level element of the ColumnInfo tree
-     * @param[out[ string_stream    The output stream where the type header
-     *                              is generated.
+     * @param[out] header The string where the column names of the leaf
+     *                    elements under current_info are appended, each one
+     *                    preceded by a separator.
+     * @param[in,out] prefix Column name of current_info. It's restored
+     *                       before returning.
+     * @param[in] current_info Element of the ColumnInfo tree
      */
-    void print_type_header(
-            std::ostringstream& string_stream,
+    static void print_type_header(
+            std::string& header,
+            std::string& prefix,
             const ColumnInfo& current_info);
 
     /**
@@ -397,7 +1270,7 @@ private:
      *                         are written.
      */
     void enter_sequence_context(
-            const std::string& name,
+            const char *name,
             RTIXMLSaveContext *save_context);
 
     /**
@@ -410,18 +1283,44 @@ private:
      *
      * @param[in] name    The sequence member name
      */
-    void leave_sequence_context(const std::string& name);
+    void leave_sequence_context(const char *name);
+
+    /**
+     * @brief Returns the innermost SequenceContext, NULL if no sequence is
+     * being printed.
+     */
+    SequenceContext* sequence_context();
 
     void initialize_native();
 
 private:
     PrintFormatWrapper<PrintFormatCsv> format_wrapper_;
     const PrintFormatCsvProperty& property_;
-    dds::core::xtypes::DynamicType type_;
+    std::shared_ptr<const ColumnPlan> plan_;
     std::ofstream& output_file_;
-    ColumnInfo column_info_;
     CursorStack cursor_stack_;
-    std::list<SequenceContext> seq_context_stack_;
+    // the first seq_context_count_ entries are in use
+    std::vector<SequenceContext> seq_context_stack_;
+    size_t seq_context_count_;
+    PackedContext packed_context_;
+    std::unordered_map<const ColumnInfo *, ColumnDictionary> dictionaries_;
+    // output position of the value being printed
+    size_t value_begin_;
+    std::string dictionary_key_;
+    std::string dictionary_entries_;
+    std::list<ExplodedTable> exploded_tables_;
+    std::map<const ColumnInfo *, ExplodedTable *> exploded_table_map_;
+    uint64_t row_id_;
+    // sample being converted
+    dds::core::xtypes::DynamicData *sample_;
+    // position of the next element in each collection being printed
+    std::vector<uint32_t> item_index_stack_;
+    // nesting level of the callbacks within a suppressed member, 0 if none
+    size_t suppressed_depth_;
+    // output position where the suppressed member begins
+    size_t suppressed_begin_;
+    // whether the suppressed member is a collection element
+    bool suppressed_item_;
 };
 
 } } }
@@ -0,0 +1,890 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "dds/core/xtypes/StructType.hpp"
+#include "dds/core/xtypes/UnionType.hpp"
+#include "dds/core/xtypes/MemberType.hpp"
+#include "dds/core/xtypes/AliasType.hpp"
+#include "dds/core/xtypes/CollectionTypes.hpp"
+#include "dds/core/xtypes/EnumType.hpp"
+
+#include "RowFilter.hpp"
+
+#define NANOSECS_PER_SEC 1000000000ll
+
+using namespace dds::core::xtypes;
+
+namespace rti { namespace recorder { namespace utils {
+
+static const DynamicType& resolve_alias(const DynamicType& type)
+{
+    const DynamicType *resolved = &type;
+    while (resolved->kind() == TypeKind::ALIAS_TYPE) {
+        resolved = &static_cast<const AliasType *>(resolved)->related_type();
+    }
+
+    return *resolved;
+}
+
+/*
+ * Looks up a member of a structure, including the members inherited from its
+ * base types.
+ */
+static bool find_struct_member(
+        const StructType& struct_type,
+        const std::string& name,
+        const DynamicType *& member_type,
+        bool& is_optional)
+{
+    for (uint32_t i = 0; i < struct_type.member_count(); i++) {
+        auto& member = struct_type.member(i);
+        if (member.name() == name) {
+            member_type = &member.type();
+            is_optional = member.is_optional();
+            return true;
+        }
+    }
+
+    return struct_type.has_parent()
+            && find_struct_member(
+                    struct_type.parent(),
+                    name,
+                    member_type,
+                    is_optional);
+}
+
+static bool equals_ignore_case(const std::string& text, const char *keyword)
+{
+    if (text.length() != std::strlen(keyword)) {
+        return false;
+    }
+    for (size_t i = 0; i < text.length(); i++) {
+        if (std::toupper(static_cast<unsigned char>(text[i])) != keyword[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RowFilter::RowFilter(
+        const DynamicType& type,
+        const std::string& expression) :
+    expression_(expression),
+    type_(&type),
+    position_(0),
+    has_lookahead_(false),
+    root_(0)
+{
+    root_ = parse_or();
+    if (peek().kind != TokenKind::END) {
+        syntax_error("unexpected '" + peek().text + "'");
+    }
+    // the type is only needed for the compilation
+    type_ = NULL;
+}
+
+const std::string& RowFilter::expression() const
+{
+    return expression_;
+}
+
+bool RowFilter::evaluate(
+        DynamicData& sample,
+        const dds::sub::SampleInfo& info) const
+{
+    return evaluate(root_, sample, info);
+}
+
+/*
+ * --- Compilation ------------------------------------------------------------
+ */
+
+void RowFilter::syntax_error(const std::string& reason) const
+{
+    throw dds::core::Error(
+            "invalid filter expression=" + expression_
+            + " at position " + std::to_string(position_)
+            + ": " + reason);
+}
+
+const RowFilter::Token& RowFilter::peek()
+{
+    if (has_lookahead_) {
+        return lookahead_;
+    }
+
+    const std::string& text = expression_;
+    while (position_ < text.length()
+            && std::isspace(static_cast<unsigned char>(text[position_]))) {
+        ++position_;
+    }
+
+    lookahead_.text.clear();
+    has_lookahead_ = true;
+    if (position_ == text.length()) {
+        lookahead_.kind = TokenKind::END;
+        return lookahead_;
+    }
+
+    const size_t begin = position_;
+    const char current = text[position_];
+    if (std::isalpha(static_cast<unsigned char>(current))
+            || current == '_'
+            || current == '@') {
+        lookahead_.kind = (current == '@')
+                ? TokenKind::INFO_FIELD
+                : TokenKind::IDENTIFIER;
+        ++position_;
+        while (position_ < text.length()
+                && (std::isalnum(static_cast<unsigned char>(text[position_]))
+                        || text[position_] == '_')) {
+            ++position_;
+        }
+    } else if (std::isdigit(static_cast<unsigned char>(current))) {
+        lookahead_.kind = TokenKind::NUMBER;
+        while (position_ < text.length()
+                && (std::isalnum(static_cast<unsigned char>(text[position_]))
+                        || text[position_] == '.'
+                        || ((text[position_] == '-' || text[position_] == '+')
+                                && (text[position_ - 1] == 'e'
+                                        || text[position_ - 1] == 'E')))) {
+            ++position_;
+        }
+    } else if (current == '\'') {
+        // quotes are escaped by doubling them
+        lookahead_.kind = TokenKind::STRING;
+        ++position_;
+        while (true) {
+            if (position_ == text.length()) {
+                syntax_error("unterminated string");
+            }
+            if (text[position_] == '\'') {
+                if (position_ + 1 < text.length()
+                        && text[position_ + 1] == '\'') {
+                    lookahead_.text += '\'';
+                    position_ += 2;
+                    continue;
+                }
+                ++position_;
+                break;
+            }
+            lookahead_.text += text[position_++];
+        }
+        return lookahead_;
+    } else {
+        lookahead_.kind = TokenKind::SYMBOL;
+        static const char *TWO_CHAR_SYMBOLS[] = { "<>", "!=", "<=", ">=" };
+        ++position_;
+        for (auto symbol : TWO_CHAR_SYMBOLS) {
+            if (text.compare(begin, 2, symbol) == 0) {
+                ++position_;
+                break;
+            }
+        }
+    }
+    lookahead_.text.assign(text, begin, position_ - begin);
+
+    return lookahead_;
+}
+
+RowFilter::Token RowFilter::next()
+{
+    Token token = peek();
+    has_lookahead_ = false;
+    return token;
+}
+
+bool RowFilter::accept_keyword(const char *keyword)
+{
+    if (peek().kind == TokenKind::IDENTIFIER
+            && equals_ignore_case(peek().text, keyword)) {
+        next();
+        return true;
+    }
+
+    return false;
+}
+
+bool RowFilter::accept_symbol(const char *symbol)
+{
+    if (peek().kind == TokenKind::SYMBOL && peek().text == symbol) {
+        next();
+        return true;
+    }
+
+    return false;
+}
+
+void RowFilter::expect_symbol(const char *symbol)
+{
+    if (!accept_symbol(symbol)) {
+        syntax_error(std::string("expected '") + symbol + "'");
+    }
+}
+
+size_t RowFilter::add_node(NodeKind kind, size_t left, size_t right)
+{
+    Node node;
+    node.kind = kind;
+    node.op = CompareOp::EQUAL;
+    node.left = left;
+    node.right = right;
+    nodes_.push_back(node);
+
+    return nodes_.size() - 1;
+}
+
+size_t RowFilter::parse_or()
+{
+    size_t node = parse_and();
+    while (accept_keyword("OR")) {
+        node = add_node(NodeKind::OR, node, parse_and());
+    }
+
+    return node;
+}
+
+size_t RowFilter::parse_and()
+{
+    size_t node = parse_term();
+    while (accept_keyword("AND")) {
+        node = add_node(NodeKind::AND, node, parse_term());
+    }
+
+    return node;
+}
+
+size_t RowFilter::parse_term()
+{
+    if (accept_keyword("NOT")) {
+        size_t operand = parse_term();
+        return add_node(NodeKind::NOT, operand, operand);
+    }
+    if (accept_symbol("(")) {
+        size_t node = parse_or();
+        expect_symbol(")");
+        return node;
+    }
+
+    return parse_predicate();
+}
+
+size_t RowFilter::parse_predicate()
+{
+    size_t left = parse_operand();
+
+    bool is_negated = accept_keyword("NOT");
+    if (accept_keyword("BETWEEN")) {
+        size_t lower = parse_operand();
+        if (!accept_keyword("AND")) {
+            syntax_error("expected AND in BETWEEN");
+        }
+        size_t upper = parse_operand();
+        size_t node = add_node(
+                NodeKind::AND,
+                add_compare(CompareOp::GREATER_EQUAL, left, lower),
+                add_compare(CompareOp::LESS_EQUAL, left, upper));
+        return is_negated ? add_node(NodeKind::NOT, node, node) : node;
+    }
+    if (accept_keyword("LIKE")) {
+        if (peek().kind != TokenKind::STRING) {
+            syntax_error("expected a string pattern in LIKE");
+        }
+        if (!is_text(left)) {
+            syntax_error("LIKE requires a string or character operand");
+        }
+        size_t node = add_node(NodeKind::LIKE, left, left);
+        nodes_[node].pattern = next().text;
+        return is_negated ? add_node(NodeKind::NOT, node, node) : node;
+    }
+    if (is_negated) {
+        syntax_error("expected BETWEEN or LIKE after NOT");
+    }
+
+    static const struct {
+        const char *symbol;
+        CompareOp op;
+    } OPERATORS[] = {
+        { "=", CompareOp::EQUAL },
+        { "<>", CompareOp::NOT_EQUAL },
+        { "!=", CompareOp::NOT_EQUAL },
+        { "<", CompareOp::LESS },
+        { "<=", CompareOp::LESS_EQUAL },
+        { ">", CompareOp::GREATER },
+        { ">=", CompareOp::GREATER_EQUAL }
+    };
+    for (auto& entry : OPERATORS) {
+        if (accept_symbol(entry.symbol)) {
+            return add_compare(entry.op, left, parse_operand());
+        }
+    }
+    syntax_error("expected a comparison operator");
+
+    return 0;
+}
+
+size_t RowFilter::parse_operand()
+{
+    operands_.push_back(Operand());
+    Operand& operand = operands_.back();
+    Token token = next();
+
+    bool is_negative = false;
+    if (token.kind == TokenKind::SYMBOL && token.text == "-") {
+        is_negative = true;
+        token = next();
+        if (token.kind != TokenKind::NUMBER) {
+            syntax_error("expected a number after '-'");
+        }
+    }
+
+    switch (token.kind) {
+
+    case TokenKind::NUMBER:
+    {
+        operand.is_literal = true;
+        const char *begin = token.text.c_str();
+        char *end = NULL;
+        errno = 0;
+        if (token.text.find_first_of(".eE") == std::string::npos
+                || token.text.compare(0, 2, "0x") == 0) {
+            const uint64_t INT64_MAGNITUDE =
+                    static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+            unsigned long long magnitude = std::strtoull(begin, &end, 0);
+            if (*end != '\0') {
+                syntax_error("invalid number " + token.text);
+            }
+            if (errno == ERANGE
+                    || (is_negative && magnitude > INT64_MAGNITUDE + 1)) {
+                syntax_error("integer " + token.text + " out of range");
+            }
+            operand.literal.kind = ValueKind::INTEGER;
+            if (is_negative) {
+                // the magnitude of the minimum is not an int64_t
+                operand.literal.integer = (magnitude == 0)
+                        ? 0
+                        : -static_cast<int64_t>(magnitude - 1) - 1;
+            } else if (magnitude > INT64_MAGNITUDE) {
+                operand.literal.kind = ValueKind::UNSIGNED;
+                operand.literal.unsigned_integer = magnitude;
+            } else {
+                operand.literal.integer = static_cast<int64_t>(magnitude);
+            }
+        } else {
+            operand.literal.kind = ValueKind::REAL;
+            operand.literal.real = std::strtod(begin, &end);
+            if (*end != '\0') {
+                syntax_error("invalid number " + token.text);
+            }
+            if (std::isinf(operand.literal.real)) {
+                syntax_error("real " + token.text + " out of range");
+            }
+            if (is_negative) {
+                operand.literal.real = -operand.literal.real;
+            }
+        }
+    }
+        break;
+
+    case TokenKind::STRING:
+        operand.is_literal = true;
+        operand.literal.kind = ValueKind::TEXT;
+        operand.literal.text = token.text;
+        break;
+
+    case TokenKind::INFO_FIELD:
+        if (token.text == "@source_timestamp") {
+            operand.info_field = InfoField::SOURCE_TIMESTAMP;
+        } else if (token.text == "@reception_timestamp") {
+            operand.info_field = InfoField::RECEPTION_TIMESTAMP;
+        } else {
+            syntax_error("unknown SampleInfo field " + token.text);
+        }
+        operand.leaf_kind = TypeKind::INT_64_TYPE;
+        break;
+
+    case TokenKind::IDENTIFIER:
+        if (equals_ignore_case(token.text, "TRUE")
+                || equals_ignore_case(token.text, "FALSE")) {
+            operand.is_literal = true;
+            operand.literal.kind = ValueKind::INTEGER;
+            operand.literal.integer =
+                    equals_ignore_case(token.text, "TRUE") ? 1 : 0;
+            break;
+        }
+        operand.steps.push_back(MemberStep());
+        operand.steps.back().name = token.text;
+        resolve_member(operand);
+        break;
+
+    default:
+        syntax_error("expected an operand");
+    }
+
+    return operands_.size() - 1;
+}
+
+void RowFilter::resolve_member(Operand& operand)
+{
+    // the first step, a member of the top-level type, is already added
+    const DynamicType *current = &resolve_alias(*type_);
+    while (true) {
+        MemberStep& step = operand.steps.back();
+        // the step is not valid once element steps are added
+        const std::string member_name = step.name;
+        const DynamicType *member_type = NULL;
+        bool is_found = false;
+        step.index = 0;
+        step.is_optional = false;
+        if (current->kind() == TypeKind::STRUCTURE_TYPE) {
+            is_found = find_struct_member(
+                    static_cast<const StructType&>(*current),
+                    step.name,
+                    member_type,
+                    step.is_optional);
+        } else if (current->kind() == TypeKind::UNION_TYPE) {
+            const UnionType& union_type =
+                    static_cast<const UnionType&>(*current);
+            for (uint32_t i = 0; i < union_type.member_count(); i++) {
+                auto& member = union_type.member(i);
+                if (member.name() == step.name) {
+                    member_type = &member.type();
+                    is_found = true;
+                    break;
+                }
+            }
+            // only the selected member is present
+            step.is_optional = true;
+        }
+        if (!is_found) {
+            syntax_error("no member with name " + step.name);
+        }
+        current = &resolve_alias(*member_type);
+
+        // collection elements
+        while (peek().kind == TokenKind::SYMBOL && peek().text == "[") {
+            uint32_t dimension_count = 1;
+            const DynamicType *content_type = NULL;
+            if (current->kind() == TypeKind::ARRAY_TYPE) {
+                const ArrayType& array_type =
+                        static_cast<const ArrayType&>(*current);
+                dimension_count = array_type.dimension_count();
+                content_type = &array_type.content_type();
+            } else if (current->kind() == TypeKind::SEQUENCE_TYPE) {
+                content_type =
+                        &static_cast<const SequenceType&>(*current).content_type();
+            } else {
+                syntax_error("member " + member_name + " is not a collection");
+            }
+
+            // multi-dimensional arrays are accessed with the flattened index
+            uint64_t index = 0;
+            for (uint32_t dimension = 0; dimension < dimension_count; dimension++) {
+                expect_symbol("[");
+                Token token = next();
+                char *end = NULL;
+                uint64_t dimension_index = std::strtoull(token.text.c_str(), &end, 10);
+                if (token.kind != TokenKind::NUMBER || *end != '\0') {
+                    syntax_error("invalid element index " + token.text);
+                }
+                expect_symbol("]");
+
+                uint64_t dimension_size = (current->kind() == TypeKind::ARRAY_TYPE)
+                        ? static_cast<const ArrayType&>(*current).dimension(dimension)
+                        : static_cast<const SequenceType&>(*current).bounds();
+                if (dimension_index >= dimension_size) {
+                    syntax_error("element index " + token.text + " out of bounds");
+                }
+                index = index * dimension_size + dimension_index;
+            }
+
+            operand.steps.push_back(MemberStep());
+            operand.steps.back().index = static_cast<uint32_t>(index) + 1;
+            // sequence elements are present up to the sequence length
+            operand.steps.back().is_optional =
+                    current->kind() == TypeKind::SEQUENCE_TYPE;
+            current = &resolve_alias(*content_type);
+        }
+
+        if (!accept_symbol(".")) {
+            break;
+        }
+        Token token = next();
+        if (token.kind != TokenKind::IDENTIFIER) {
+            syntax_error("expected a member name after '.'");
+        }
+        operand.steps.push_back(MemberStep());
+        operand.steps.back().name = token.text;
+    }
+
+    switch (current->kind().underlying()) {
+
+    case TypeKind::STRUCTURE_TYPE:
+    case TypeKind::UNION_TYPE:
+    case TypeKind::ARRAY_TYPE:
+    case TypeKind::SEQUENCE_TYPE:
+    case TypeKind::FLOAT_128_TYPE:
+        syntax_error("member " + operand.steps.front().name
+                + " does not have a primitive type");
+        break;
+
+    case TypeKind::ENUMERATION_TYPE:
+        operand.enum_type = current;
+        break;
+
+    default:
+        break;
+    }
+    operand.leaf_kind = current->kind();
+}
+
+bool RowFilter::is_text(size_t operand_index) const
+{
+    const Operand& operand = operands_[operand_index];
+    if (operand.is_literal) {
+        return operand.literal.kind == ValueKind::TEXT;
+    }
+
+    switch (operand.leaf_kind.underlying()) {
+    case TypeKind::CHAR_8_TYPE:
+    case TypeKind::STRING_TYPE:
+    case TypeKind::WSTRING_TYPE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void RowFilter::check_comparable(size_t left, size_t right)
+{
+    // enumerators are compared by value
+    for (int i = 0; i < 2; i++) {
+        const Operand& member = operands_[i == 0 ? left : right];
+        Operand& literal = operands_[i == 0 ? right : left];
+        if (member.enum_type == NULL
+                || !literal.is_literal
+                || literal.literal.kind != ValueKind::TEXT) {
+            continue;
+        }
+        const EnumType& enum_type =
+                static_cast<const EnumType&>(*member.enum_type);
+        bool is_found = false;
+        for (uint32_t j = 0; j < enum_type.member_count(); j++) {
+            if (enum_type.member(j).name() == literal.literal.text) {
+                literal.literal.kind = ValueKind::INTEGER;
+                literal.literal.integer = enum_type.member(j).ordinal();
+                is_found = true;
+                break;
+            }
+        }
+        if (!is_found) {
+            syntax_error("no enumerator with name " + literal.literal.text);
+        }
+    }
+
+    if (is_text(left) != is_text(right)) {
+        syntax_error("cannot compare a string with a number");
+    }
+}
+
+size_t RowFilter::add_compare(CompareOp op, size_t left, size_t right)
+{
+    check_comparable(left, right);
+    size_t node = add_node(NodeKind::COMPARE, left, right);
+    nodes_[node].op = op;
+
+    return node;
+}
+
+/*
+ * --- Evaluation -------------------------------------------------------------
+ */
+
+bool RowFilter::evaluate(
+        size_t node_index,
+        DynamicData& sample,
+        const dds::sub::SampleInfo& info) const
+{
+    const Node& node = nodes_[node_index];
+    switch (node.kind) {
+
+    case NodeKind::AND:
+        return evaluate(node.left, sample, info)
+                && evaluate(node.right, sample, info);
+
+    case NodeKind::OR:
+        return evaluate(node.left, sample, info)
+                || evaluate(node.right, sample, info);
+
+    case NodeKind::NOT:
+        return !evaluate(node.left, sample, info);
+
+    case NodeKind::LIKE:
+    {
+        Value value;
+        return read_operand(operands_[node.left], sample, info, value)
+                && like(node.pattern.c_str(), value.text.c_str());
+    }
+
+    default:
+        break;
+    }
+
+    Value left;
+    Value right;
+    if (!read_operand(operands_[node.left], sample, info, left)
+            || !read_operand(operands_[node.right], sample, info, right)) {
+        return false;
+    }
+    int result = compare(left, right);
+    switch (node.op) {
+    case CompareOp::EQUAL:
+        return result == 0;
+    case CompareOp::NOT_EQUAL:
+        return result != 0;
+    case CompareOp::LESS:
+        return result < 0;
+    case CompareOp::LESS_EQUAL:
+        return result <= 0;
+    case CompareOp::GREATER:
+        return result > 0;
+    default:
+        return result >= 0;
+    }
+}
+
+bool RowFilter::read_operand(
+        const Operand& operand,
+        DynamicData& sample,
+        const dds::sub::SampleInfo& info,
+        Value& value) const
+{
+    if (operand.is_literal) {
+        value = operand.literal;
+        return true;
+    }
+
+    switch (operand.info_field) {
+
+    case InfoField::SOURCE_TIMESTAMP:
+        value.kind = ValueKind::INTEGER;
+        value.integer = (int64_t) info->source_timestamp().sec()
+                * NANOSECS_PER_SEC
+                + info->source_timestamp().nanosec();
+        return true;
+
+    case InfoField::RECEPTION_TIMESTAMP:
+        value.kind = ValueKind::INTEGER;
+        value.integer = (int64_t) info->reception_timestamp().sec()
+                * NANOSECS_PER_SEC
+                + info->reception_timestamp().nanosec();
+        return true;
+
+    default:
+        return read_member(operand, 0, sample, value);
+    }
+}
+
+bool RowFilter::read_member(
+        const Operand& operand,
+        size_t step_index,
+        DynamicData& data,
+        Value& value) const
+{
+    const MemberStep& step = operand.steps[step_index];
+    const bool is_element = step.name.empty();
+    if (step.is_optional
+            && (is_element
+                    ? step.index > data.member_count()
+                    : !data.member_exists(step.name))) {
+        return false;
+    }
+
+    if (step_index + 1 == operand.steps.size()) {
+        if (is_element) {
+            read_leaf(data, step.index, operand.leaf_kind, value);
+        } else {
+            read_leaf(data, step.name, operand.leaf_kind, value);
+        }
+        return true;
+    }
+
+    LoanedDynamicData loan = is_element
+            ? data.loan_value(step.index)
+            : data.loan_value(step.name);
+    return read_member(operand, step_index + 1, loan.get(), value);
+}
+
+template <typename Key>
+void RowFilter::read_leaf(
+        const DynamicData& data,
+        const Key& key,
+        TypeKind leaf_kind,
+        Value& value)
+{
+    value.kind = ValueKind::INTEGER;
+    switch (leaf_kind.underlying()) {
+
+    case TypeKind::BOOLEAN_TYPE:
+        value.integer = data.value<bool>(key) ? 1 : 0;
+        break;
+
+    case TypeKind::CHAR_8_TYPE:
+        value.kind = ValueKind::TEXT;
+        value.text.assign(1, data.value<char>(key));
+        break;
+
+    case TypeKind::CHAR_16_TYPE:
+        value.integer = data.value<wchar_t>(key);
+        break;
+
+    case TypeKind::UINT_8_TYPE:
+        value.integer = data.value<uint8_t>(key);
+        break;
+
+    case TypeKind::INT_16_TYPE:
+        value.integer = data.value<int16_t>(key);
+        break;
+
+    case TypeKind::UINT_16_TYPE:
+        value.integer = data.value<uint16_t>(key);
+        break;
+
+    case TypeKind::INT_32_TYPE:
+    case TypeKind::ENUMERATION_TYPE:
+        value.integer = data.value<int32_t>(key);
+        break;
+
+    case TypeKind::UINT_32_TYPE:
+        value.integer = data.value<uint32_t>(key);
+        break;
+
+    case TypeKind::INT_64_TYPE:
+        value.integer = data.value<int64_t>(key);
+        break;
+
+    case TypeKind::UINT_64_TYPE:
+        value.kind = ValueKind::UNSIGNED;
+        value.unsigned_integer = data.value<uint64_t>(key);
+        break;
+
+    case TypeKind::FLOAT_32_TYPE:
+        value.kind = ValueKind::REAL;
+        value.real = data.value<float>(key);
+        break;
+
+    case TypeKind::FLOAT_64_TYPE:
+        value.kind = ValueKind::REAL;
+        value.real = data.value<double>(key);
+        break;
+
+    case TypeKind::STRING_TYPE:
+        value.kind = ValueKind::TEXT;
+        value.text = data.value<std::string>(key);
+        break;
+
+    default:
+    {
+        // wide strings are narrowed, replacing non-ASCII characters
+        std::wstring wide_value = data.value<std::wstring>(key);
+        value.kind = ValueKind::TEXT;
+        value.text.clear();
+        for (auto wide_char : wide_value) {
+            value.text.push_back(
+                    wide_char < 0x80 ? static_cast<char>(wide_char) : '?');
+        }
+    }
+        break;
+    }
+}
+
+double RowFilter::real_value(const Value& value)
+{
+    switch (value.kind) {
+    case ValueKind::REAL:
+        return value.real;
+    case ValueKind::UNSIGNED:
+        return static_cast<double>(value.unsigned_integer);
+    default:
+        return static_cast<double>(value.integer);
+    }
+}
+
+int RowFilter::compare(const Value& left, const Value& right)
+{
+    if (left.kind == ValueKind::TEXT) {
+        return left.text.compare(right.text);
+    }
+
+    if (left.kind == ValueKind::REAL || right.kind == ValueKind::REAL) {
+        double left_real = real_value(left);
+        double right_real = real_value(right);
+        return (left_real < right_real) ? -1 : (left_real > right_real ? 1 : 0);
+    }
+
+    if (left.kind == ValueKind::UNSIGNED || right.kind == ValueKind::UNSIGNED) {
+        // negative values are less than any unsigned one
+        if (left.kind == ValueKind::INTEGER && left.integer < 0) {
+            return -1;
+        }
+        if (right.kind == ValueKind::INTEGER && right.integer < 0) {
+            return 1;
+        }
+        uint64_t left_unsigned = (left.kind == ValueKind::UNSIGNED)
+                ? left.unsigned_integer
+                : static_cast<uint64_t>(left.integer);
+        uint64_t right_unsigned = (right.kind == ValueKind::UNSIGNED)
+                ? right.unsigned_integer
+                : static_cast<uint64_t>(right.integer);
+        return (left_unsigned < right_unsigned)
+                ? -1
+                : (left_unsigned > right_unsigned ? 1 : 0);
+    }
+
+    return (left.integer < right.integer)
+            ? -1
+            : (left.integer > right.integer ? 1 : 0);
+}
+
+bool RowFilter::like(const char *pattern, const char *text)
+{
+    while (*pattern != '\0') {
+        if (*pattern == '%') {
+            // try all the possible lengths of the sequence
+            for (const char *rest = text; ; ++rest) {
+                if (like(pattern + 1, rest)) {
+                    return true;
+                }
+                if (*rest == '\0') {
+                    return false;
+                }
+            }
+        }
+        if (*text == '\0' || (*pattern != '_' && *pattern != *text)) {
+            return false;
+        }
+        ++pattern;
+        ++text;
+    }
+
+    return *text == '\0';
+}
+
+} } }
@@ -0,0 +1,242 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_ROWFILTER_HPP_
+#define RTI_RECORDER_UTILS_ROWFILTER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "dds/core/xtypes/DynamicData.hpp"
+#include "dds/core/xtypes/DynamicType.hpp"
+#include "dds/sub/SampleInfo.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Predicate over the samples of a type, specified with a syntax close
+ * to the DDS content filter expressions.
+ *
+ * The grammar of an expression is:
+ *
+ *     expression := condition { OR condition }
+ *     condition  := term { AND term }
+ *     term       := NOT term | ( expression ) | predicate
+ *     predicate  := operand <op> operand
+ *                 | operand [NOT] BETWEEN operand AND operand
+ *                 | operand [NOT] LIKE 'pattern'
+ *     <op>       := = | <> | != | < | <= | > | >=
+ *
+ * An operand is one of:
+ *
+ * - A member path, e.g. \p pose.position.x, \p m_array[3] or
+ *   \p m_sequence[0].value. Multi-dimensional arrays take an index per
+ *   dimension, e.g. \p m_matrix[1][2].
+ * - A SampleInfo field: \p @source_timestamp or \p @reception_timestamp, in
+ *   nanoseconds.
+ * - A literal: an integer, a real, a string between single quotes, \p TRUE
+ *   or \p FALSE. Enumeration members are compared with the label of an
+ *   enumerator as a string literal or with its integer value.
+ *
+ * Keywords are case-insensitive. In LIKE patterns, \p % matches any sequence
+ * of characters and \p _ any single character.
+ *
+ * The expression is compiled once against the type: member paths are
+ * resolved into access steps and the types of the operands are checked, so
+ * errors are reported on construction. A predicate over a member that is not
+ * present in a sample, such as an unset optional member, a non-selected
+ * union member or a sequence element beyond its length, is false.
+ */
+class RowFilter {
+public:
+    /**
+     * @brief Compiles the expression for the specified type
+     *
+     * Throws dds::core::Error if the expression is not valid for the type.
+     */
+    RowFilter(
+            const dds::core::xtypes::DynamicType& type,
+            const std::string& expression);
+
+    /**
+     * @brief Returns whether the sample satisfies the expression
+     */
+    bool evaluate(
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info) const;
+
+    /**
+     * @brief Returns the expression this filter was compiled from
+     */
+    const std::string& expression() const;
+
+private:
+    // integers above the range of int64_t are UNSIGNED
+    enum class ValueKind {
+        INTEGER,
+        UNSIGNED,
+        REAL,
+        TEXT
+    };
+
+    struct Value {
+        Value() :
+            kind(ValueKind::INTEGER),
+            integer(0),
+            unsigned_integer(0),
+            real(0)
+        {
+        }
+
+        ValueKind kind;
+        int64_t integer;
+        uint64_t unsigned_integer;
+        double real;
+        std::string text;
+    };
+
+    /*
+     * Access to a member from its enclosing member: by name for structure
+     * and union members, by 1-based index for collection elements.
+     */
+    struct MemberStep {
+        std::string name;
+        uint32_t index;
+        // whether the member may not be present in a sample
+        bool is_optional;
+    };
+
+    enum class InfoField {
+        NONE,
+        SOURCE_TIMESTAMP,
+        RECEPTION_TIMESTAMP
+    };
+
+    struct Operand {
+        Operand() :
+            is_literal(false),
+            info_field(InfoField::NONE),
+            leaf_kind(dds::core::xtypes::TypeKind::NO_TYPE),
+            enum_type(NULL)
+        {
+        }
+
+        bool is_literal;
+        Value literal;
+        InfoField info_field;
+        std::vector<MemberStep> steps;
+        dds::core::xtypes::TypeKind leaf_kind;
+        // compilation only: the type of an enumeration member
+        const dds::core::xtypes::DynamicType *enum_type;
+    };
+
+    enum class NodeKind {
+        AND,
+        OR,
+        NOT,
+        COMPARE,
+        LIKE
+    };
+
+    enum class CompareOp {
+        EQUAL,
+        NOT_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        GREATER,
+        GREATER_EQUAL
+    };
+
+    /*
+     * Node of the expression tree. Operators refer to their child nodes and
+     * predicates to their operands, by index.
+     */
+    struct Node {
+        NodeKind kind;
+        CompareOp op;
+        size_t left;
+        size_t right;
+        std::string pattern;
+    };
+
+    enum class TokenKind {
+        END,
+        IDENTIFIER,
+        INFO_FIELD,
+        NUMBER,
+        STRING,
+        SYMBOL
+    };
+
+    struct Token {
+        TokenKind kind;
+        std::string text;
+    };
+
+    // lexer
+    const Token& peek();
+    Token next();
+    bool accept_keyword(const char *keyword);
+    bool accept_symbol(const char *symbol);
+    void expect_symbol(const char *symbol);
+    void syntax_error(const std::string& reason) const;
+
+    // parser, returning the index of the created node or operand
+    size_t parse_or();
+    size_t parse_and();
+    size_t parse_term();
+    size_t parse_predicate();
+    size_t parse_operand();
+    void resolve_member(Operand& operand);
+    size_t add_node(NodeKind kind, size_t left, size_t right);
+    size_t add_compare(CompareOp op, size_t left, size_t right);
+    void check_comparable(size_t left, size_t right);
+    bool is_text(size_t operand) const;
+
+    // evaluation
+    bool evaluate(
+            size_t node,
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info) const;
+    bool read_operand(
+            const Operand& operand,
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info,
+            Value& value) const;
+    bool read_member(
+            const Operand& operand,
+            size_t step,
+            dds::core::xtypes::DynamicData& data,
+            Value& value) const;
+    template <typename Key>
+    static void read_leaf(
+            const dds::core::xtypes::DynamicData& data,
+            const Key& key,
+            dds::core::xtypes::TypeKind leaf_kind,
+            Value& value);
+    static double real_value(const Value& value);
+    static int compare(const Value& left, const Value& right);
+    static bool like(const char *pattern, const char *text);
+
+    std::string expression_;
+    const dds::core::xtypes::DynamicType *type_;
+    size_t position_;
+    Token lookahead_;
+    bool has_lookahead_;
+    std::vector<Operand> operands_;
+    std::vector<Node> nodes_;
+    size_t root_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,750 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+/*
+ * Command-line tool that measures the throughput of the plug-in with
+ * synthetic workloads. Each workload is a type built at run time, covering
+ * flat primitives, deep nesting, large arrays, bounded sequences, unions and
+ * optional members, and batches of random samples of the type. The samples
+ * are stored through the same StreamWriter that the plug-in uses during
+ * recording, for each output format (engine) and each sink:
+ *
+ * - files: one output file per Topic
+ * - merged: the output files are consolidated into a single file (CSV only)
+ *
+ * The results are written in JSON format, with one entry per workload,
+ * engine and sink.
+ *
+ * With --check-allocations, the tool fails if the CSV engine allocates
+ * memory once the stream writer is warmed up, that is, after each distinct
+ * batch has been stored once.
+ *
+ * Usage: utilsstorage_bench [--samples <count>] [--batch <count>]
+ *         [--seed <value>] [--workload <name>]... [--engine <format>]...
+ *         [--output-dir <path>] [--output <JSON file>] [--check-allocations]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <dds/core/xtypes/CollectionTypes.hpp>
+#include <dds/core/xtypes/DynamicData.hpp>
+#include <dds/core/xtypes/PrimitiveTypes.hpp>
+#include <dds/core/xtypes/StructType.hpp>
+#include <dds/core/xtypes/UnionType.hpp>
+
+#include "PrintFormatCsv.hpp"
+#include "UtilsStorageWriter.hpp"
+
+using namespace rti::recorder::utils;
+using namespace dds::core::xtypes;
+
+/*
+ * Allocations performed by the process. Every allocation goes through the
+ * replaceable global operator new, so the counter includes the allocations
+ * of the plug-in and of RTI Connext.
+ */
+static std::atomic<uint64_t> process_allocation_count(0);
+
+void *operator new(std::size_t size)
+{
+    process_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    void *memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == NULL) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+// samples passed to each call to store()
+const size_t BATCH_SIZE_DEFAULT = 256;
+// distinct batches generated per workload, stored in turns
+const size_t DISTINCT_BATCH_COUNT = 8;
+const uint64_t SAMPLE_COUNT_DEFAULT = 100000;
+// reception period of the samples, in nanoseconds
+const int64_t SAMPLE_PERIOD = 1000000;
+const int64_t NANOSECS_PER_SEC = 1000000000ll;
+
+/*
+ * Synthetic type and the random samples stored for it
+ */
+struct Workload {
+    std::string name;
+    StructType type;
+    std::vector<std::vector<DynamicData>> batches;
+};
+
+/*
+ * Measurement of a workload with an engine and a sink
+ */
+struct BenchResult {
+    std::string workload;
+    std::string engine;
+    std::string sink;
+    size_t column_count;
+    uint64_t sample_count;
+    double seconds;
+    uint64_t byte_count;
+    uint64_t allocation_count;
+    // samples and allocations after the warm-up
+    uint64_t steady_sample_count;
+    uint64_t steady_allocation_count;
+};
+
+/*
+ * --- Workload types ---------------------------------------------------------
+ */
+
+StructType flat_type()
+{
+    StructType type("FlatPrimitives");
+    type.add_member(Member("m_short", primitive_type<int16_t>()));
+    type.add_member(Member("m_long", primitive_type<int32_t>()));
+    type.add_member(Member("m_long_long", primitive_type<int64_t>()));
+    type.add_member(Member("m_unsigned_long", primitive_type<uint32_t>()));
+    type.add_member(Member("m_float", primitive_type<float>()));
+    type.add_member(Member("m_double", primitive_type<double>()));
+    type.add_member(Member("m_boolean", primitive_type<bool>()));
+    type.add_member(Member("m_octet", primitive_type<uint8_t>()));
+    type.add_member(Member("m_string", StringType(32)));
+
+    return type;
+}
+
+StructType nested_type()
+{
+    const int DEPTH = 8;
+    StructType level("NestedLevel" + std::to_string(DEPTH));
+    level.add_member(Member("id", primitive_type<int32_t>()));
+    level.add_member(Member("value", primitive_type<double>()));
+    for (int i = DEPTH - 1; i > 0; i--) {
+        StructType parent("NestedLevel" + std::to_string(i));
+        parent.add_member(Member("id", primitive_type<int32_t>()));
+        parent.add_member(Member("value", primitive_type<double>()));
+        parent.add_member(Member("child", level));
+        level = parent;
+    }
+
+    return level;
+}
+
+StructType large_array_type()
+{
+    StructType type("LargeArrays");
+    type.add_member(Member(
+            "m_doubles",
+            ArrayType(primitive_type<double>(), 1024)));
+    type.add_member(Member(
+            "m_longs",
+            ArrayType(primitive_type<int32_t>(), 256)));
+
+    return type;
+}
+
+StructType bounded_sequence_type()
+{
+    StructType type("BoundedSequences");
+    type.add_member(Member("count", primitive_type<int32_t>()));
+    type.add_member(Member(
+            "m_doubles",
+            SequenceType(primitive_type<double>(), 128)));
+    type.add_member(Member(
+            "m_longs",
+            SequenceType(primitive_type<int32_t>(), 32)));
+
+    return type;
+}
+
+StructType union_type()
+{
+    StructType point("UnionPoint");
+    point.add_member(Member("x", primitive_type<double>()));
+    point.add_member(Member("y", primitive_type<double>()));
+
+    UnionType value("UnionValue", primitive_type<int32_t>());
+    value.add_member(UnionMember("m_long", primitive_type<int32_t>(), 0));
+    value.add_member(UnionMember("m_double", primitive_type<double>(), 1));
+    value.add_member(UnionMember("m_string", StringType(32), 2));
+    value.add_member(UnionMember("m_point", point, 3));
+
+    StructType type("Unions");
+    type.add_member(Member("id", primitive_type<int32_t>()));
+    type.add_member(Member("value", value));
+    type.add_member(Member("other_value", value));
+
+    return type;
+}
+
+StructType optional_type()
+{
+    StructType point("OptionalPoint");
+    point.add_member(Member("x", primitive_type<double>()));
+    point.add_member(Member("y", primitive_type<double>()));
+
+    StructType type("OptionalMembers");
+    type.add_member(Member("id", primitive_type<int32_t>()));
+    type.add_member(
+            Member("m_long", primitive_type<int32_t>()).optional(true));
+    type.add_member(
+            Member("m_long_long", primitive_type<int64_t>()).optional(true));
+    type.add_member(
+            Member("m_float", primitive_type<float>()).optional(true));
+    type.add_member(
+            Member("m_double", primitive_type<double>()).optional(true));
+    type.add_member(Member("m_string", StringType(32)).optional(true));
+    type.add_member(Member("m_point", point).optional(true));
+
+    return type;
+}
+
+/*
+ * --- Random samples ---------------------------------------------------------
+ */
+
+void randomize_struct(
+        DynamicData& data,
+        const StructType& type,
+        std::mt19937_64& random);
+
+std::string random_string(uint32_t bound, std::mt19937_64& random)
+{
+    static const char ALPHABET[] =
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 _";
+    std::string value(random() % (bound + 1), ' ');
+    for (auto& character : value) {
+        character = ALPHABET[random() % (sizeof(ALPHABET) - 1)];
+    }
+
+    return value;
+}
+
+template <typename T>
+std::vector<T> random_values(size_t length, std::mt19937_64& random)
+{
+    std::uniform_real_distribution<double> distribution(-1.0e6, 1.0e6);
+    std::vector<T> values(length);
+    for (auto& value : values) {
+        value = static_cast<T>(distribution(random));
+    }
+
+    return values;
+}
+
+/*
+ * Sets a random value to a member of a structure or union. The collections
+ * of the workload types have primitive elements.
+ */
+void randomize_member(
+        DynamicData& data,
+        const std::string& name,
+        const DynamicType& type,
+        std::mt19937_64& random)
+{
+    std::uniform_real_distribution<double> real(-1.0e6, 1.0e6);
+
+    switch (type.kind().underlying()) {
+    case TypeKind::BOOLEAN_TYPE:
+        data.value<bool>(name, (random() & 1) != 0);
+        break;
+
+    case TypeKind::UINT_8_TYPE:
+        data.value<uint8_t>(name, static_cast<uint8_t>(random()));
+        break;
+
+    case TypeKind::INT_16_TYPE:
+        data.value<int16_t>(name, static_cast<int16_t>(random()));
+        break;
+
+    case TypeKind::INT_32_TYPE:
+        data.value<int32_t>(name, static_cast<int32_t>(random()));
+        break;
+
+    case TypeKind::UINT_32_TYPE:
+        data.value<uint32_t>(name, static_cast<uint32_t>(random()));
+        break;
+
+    case TypeKind::INT_64_TYPE:
+        data.value<int64_t>(name, static_cast<int64_t>(random()));
+        break;
+
+    case TypeKind::FLOAT_32_TYPE:
+        data.value<float>(name, static_cast<float>(real(random)));
+        break;
+
+    case TypeKind::FLOAT_64_TYPE:
+        data.value<double>(name, real(random));
+        break;
+
+    case TypeKind::STRING_TYPE:
+        data.value<std::string>(
+                name,
+                random_string(
+                        static_cast<const StringType&>(type).bounds(),
+                        random));
+        break;
+
+    case TypeKind::STRUCTURE_TYPE:
+    {
+        LoanedDynamicData loan = data.loan_value(name);
+        randomize_struct(
+                loan.get(),
+                static_cast<const StructType&>(type),
+                random);
+    }
+        break;
+
+    case TypeKind::UNION_TYPE:
+    {
+        // selects one of the members
+        const UnionType& union_type = static_cast<const UnionType&>(type);
+        const auto& member =
+                union_type.member(random() % union_type.member_count());
+        LoanedDynamicData loan = data.loan_value(name);
+        randomize_member(loan.get(), member.name(), member.type(), random);
+    }
+        break;
+
+    case TypeKind::ARRAY_TYPE:
+    case TypeKind::SEQUENCE_TYPE:
+    {
+        const DynamicType *content_type = NULL;
+        size_t length = 0;
+        if (type.kind() == TypeKind::ARRAY_TYPE) {
+            const ArrayType& array_type = static_cast<const ArrayType&>(type);
+            content_type = &array_type.content_type();
+            length = array_type.total_element_count();
+        } else {
+            const SequenceType& sequence_type =
+                    static_cast<const SequenceType&>(type);
+            content_type = &sequence_type.content_type();
+            length = random() % (sequence_type.bounds() + 1);
+        }
+        if (content_type->kind() == TypeKind::FLOAT_64_TYPE) {
+            data.set_values(name, random_values<double>(length, random));
+        } else {
+            data.set_values(name, random_values<int32_t>(length, random));
+        }
+    }
+        break;
+
+    default:
+        throw std::runtime_error(
+                "unsupported workload member type=" + type.name());
+    }
+}
+
+void randomize_struct(
+        DynamicData& data,
+        const StructType& type,
+        std::mt19937_64& random)
+{
+    for (uint32_t i = 0; i < type.member_count(); i++) {
+        const Member& member = type.member(i);
+        // half of the optional members are left unset
+        if (member.is_optional() && (random() & 1) != 0) {
+            continue;
+        }
+        randomize_member(data, member.name(), member.type(), random);
+    }
+}
+
+std::vector<Workload> create_workloads(
+        const std::vector<std::string>& names,
+        size_t batch_size,
+        uint64_t seed)
+{
+    std::vector<Workload> workloads;
+    workloads.push_back(Workload { "flat", flat_type(), {} });
+    workloads.push_back(Workload { "nested", nested_type(), {} });
+    workloads.push_back(Workload { "large_array", large_array_type(), {} });
+    workloads.push_back(Workload {
+            "bounded_sequence",
+            bounded_sequence_type(),
+            {} });
+    workloads.push_back(Workload { "union", union_type(), {} });
+    workloads.push_back(Workload { "optional", optional_type(), {} });
+    if (!names.empty()) {
+        workloads.erase(
+                std::remove_if(
+                        workloads.begin(),
+                        workloads.end(),
+                        [&names](const Workload& workload) {
+                            return std::find(
+                                    names.begin(),
+                                    names.end(),
+                                    workload.name) == names.end();
+                        }),
+                workloads.end());
+    }
+
+    std::mt19937_64 random(seed);
+    for (auto& workload : workloads) {
+        workload.batches.resize(DISTINCT_BATCH_COUNT);
+        for (auto& batch : workload.batches) {
+            batch.reserve(batch_size);
+            for (size_t i = 0; i < batch_size; i++) {
+                batch.push_back(DynamicData(workload.type));
+                randomize_struct(batch.back(), workload.type, random);
+            }
+        }
+    }
+
+    return workloads;
+}
+
+/*
+ * --- Measurement ------------------------------------------------------------
+ */
+
+/*
+ * Number of data columns of a type, as in the CSV type header
+ */
+size_t column_count(const StructType& type)
+{
+    PrintFormatCsv::ColumnPlan plan(type, PrintFormatCsvProperty());
+    const std::string& header = plan.header();
+
+    return std::count(
+            header.begin(),
+            header.end(),
+            PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT()[0]);
+}
+
+uint64_t file_size(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(file.tellg());
+}
+
+BenchResult run(
+        Workload& workload,
+        const std::string& engine,
+        const std::string& sink,
+        const std::string& output_dir_path,
+        uint64_t sample_count)
+{
+    BenchResult result;
+    result.workload = workload.name;
+    result.engine = engine;
+    result.sink = sink;
+    result.column_count = column_count(workload.type);
+    result.sample_count = 0;
+    result.steady_sample_count = 0;
+    result.steady_allocation_count = 0;
+
+    std::string basename =
+            "bench_" + workload.name + "_" + engine + "_" + sink;
+    rti::routing::PropertySet properties;
+    properties[UtilsStorageWriter::OUTPUT_FORMAT_PROPERTY_NAME()] = engine;
+    properties[UtilsStorageWriter::OUTPUT_DIR_PROPERTY_NAME()] =
+            output_dir_path;
+    properties[UtilsStorageWriter::OUTPUT_FILE_BASENAME_PROPERTY_NAME()] =
+            basename;
+    properties[UtilsStorageWriter::OUTPUT_MERGE_PROPERTY_NAME()] =
+            (sink == "merged") ? "true" : "false";
+
+    rti::routing::StreamInfo stream_info(workload.name, workload.type.name());
+    stream_info.type_info().type_representation_kind(
+            rti::routing::TypeRepresentationKind::DYNAMIC_TYPE);
+    stream_info.type_info().type_representation(&workload.type);
+
+    std::string output_file_path;
+    {
+        UtilsStorageWriter storage_writer(properties);
+        LazyStreamWriter *stream_writer = static_cast<LazyStreamWriter *>(
+                storage_writer.create_stream_writer(
+                        stream_info,
+                        rti::routing::PropertySet()));
+        // the output file and the column plan are not measured
+        output_file_path = stream_writer->materialize().file_entry().first;
+
+        std::vector<dds::sub::SampleInfo> infos(workload.batches[0].size());
+        std::vector<DynamicData *> sample_seq;
+        std::vector<dds::sub::SampleInfo *> info_seq;
+        sample_seq.reserve(infos.size());
+        info_seq.reserve(infos.size());
+
+        auto begin = std::chrono::steady_clock::now();
+        uint64_t allocation_begin = process_allocation_count.load();
+        uint64_t steady_allocation_begin = 0;
+        uint64_t steady_sample_begin = 0;
+        size_t batch_index = 0;
+        size_t stored_batch_count = 0;
+        while (result.sample_count < sample_count) {
+            // every distinct batch is stored once before the steady state
+            if (stored_batch_count == workload.batches.size()) {
+                steady_allocation_begin = process_allocation_count.load();
+                steady_sample_begin = result.sample_count;
+            }
+            std::vector<DynamicData>& batch = workload.batches[batch_index];
+            batch_index = (batch_index + 1) % workload.batches.size();
+            sample_seq.clear();
+            info_seq.clear();
+            for (size_t i = 0;
+                    i < batch.size() && result.sample_count < sample_count;
+                    i++, result.sample_count++) {
+                int64_t timestamp =
+                        static_cast<int64_t>(result.sample_count)
+                        * SAMPLE_PERIOD;
+                DDS_SampleInfo& native_info = infos[i]->native();
+                native_info.reception_timestamp.sec = static_cast<DDS_Long>(
+                        timestamp / NANOSECS_PER_SEC);
+                native_info.reception_timestamp.nanosec =
+                        static_cast<DDS_UnsignedLong>(
+                                timestamp % NANOSECS_PER_SEC);
+                native_info.source_timestamp = native_info.reception_timestamp;
+                native_info.valid_data = DDS_BOOLEAN_TRUE;
+
+                sample_seq.push_back(&batch[i]);
+                info_seq.push_back(&infos[i]);
+            }
+            stream_writer->store(sample_seq, info_seq);
+            ++stored_batch_count;
+        }
+        result.allocation_count =
+                process_allocation_count.load() - allocation_begin;
+        if (stored_batch_count > workload.batches.size()) {
+            result.steady_allocation_count =
+                    process_allocation_count.load() - steady_allocation_begin;
+            result.steady_sample_count =
+                    result.sample_count - steady_sample_begin;
+        }
+        // the output is complete once the stream writer is finalized
+        storage_writer.delete_stream_writer(stream_writer);
+        result.seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - begin).count();
+
+        result.byte_count = file_size(output_file_path);
+    }
+
+    // the merged file is written once the storage writer is deleted
+    std::remove(output_file_path.c_str());
+    if (sink == "merged") {
+        std::remove((output_dir_path
+                + RTI_RECORDER_UTILS_PATH_SEPARATOR
+                + basename
+                + UtilsStorageWriter::CSV_FILE_EXTENSION()).c_str());
+    }
+
+    return result;
+}
+
+std::string json_string(const std::string& value)
+{
+    std::string escaped = "\"";
+    for (char character : value) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+    escaped += '"';
+
+    return escaped;
+}
+
+void write_results(
+        std::ostream& output,
+        const std::vector<BenchResult>& results,
+        size_t batch_size,
+        uint64_t seed)
+{
+    output << "{\n"
+            << "  \"batch_size\": " << batch_size << ",\n"
+            << "  \"seed\": " << seed << ",\n"
+            << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        double seconds = std::max(result.seconds, 1e-9);
+        double samples = static_cast<double>(std::max<uint64_t>(
+                result.sample_count,
+                1));
+        output << (i == 0 ? "\n" : ",\n")
+                << "    {\"workload\": " << json_string(result.workload)
+                << ", \"engine\": " << json_string(result.engine)
+                << ", \"sink\": " << json_string(result.sink)
+                << ", \"columns\": " << result.column_count
+                << ", \"samples\": " << result.sample_count
+                << ", \"seconds\": " << result.seconds
+                << ", \"bytes\": " << result.byte_count
+                << ", \"samples_per_second\": "
+                << result.sample_count / seconds
+                << ", \"bytes_per_second\": " << result.byte_count / seconds
+                << ", \"ns_per_column\": "
+                << seconds * NANOSECS_PER_SEC
+                        / (samples * std::max<size_t>(result.column_count, 1))
+                << ", \"allocations_per_sample\": "
+                << result.allocation_count / samples
+                << ", \"steady_state_allocations_per_sample\": "
+                << result.steady_allocation_count
+                        / static_cast<double>(std::max<uint64_t>(
+                                result.steady_sample_count,
+                                1))
+                << "}";
+    }
+    output << "\n  ]\n}" << std::endl;
+}
+
+/*
+ * The steady-state store() path of the CSV engine doesn't allocate memory:
+ * the buffers of the stream writer only grow while warming up.
+ */
+bool check_steady_allocations(const std::vector<BenchResult>& results)
+{
+    bool passed = true;
+    for (auto& result : results) {
+        if (result.engine != "CSV" || result.steady_allocation_count == 0) {
+            continue;
+        }
+        std::cerr << "steady-state allocations: workload="
+                << result.workload << " engine=" << result.engine
+                << " sink=" << result.sink
+                << " allocations=" << result.steady_allocation_count
+                << " samples=" << result.steady_sample_count << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+void print_usage(const char *program)
+{
+    std::cerr << "Usage: " << program
+            << " [--samples <count>] [--batch <count>] [--seed <value>]"
+            << " [--workload <name>]... [--engine <format>]..."
+            << " [--output-dir <path>] [--output <JSON file>]"
+            << " [--check-allocations]"
+            << std::endl
+            << "Workloads: flat, nested, large_array, bounded_sequence,"
+            << " union, optional" << std::endl
+            << "Engines: CSV, JSONL, COLUMNAR, CDR, STATISTICS" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t sample_count = SAMPLE_COUNT_DEFAULT;
+    size_t batch_size = BATCH_SIZE_DEFAULT;
+    uint64_t seed = 1;
+    std::vector<std::string> workload_names;
+    std::vector<std::string> engines;
+    std::string output_dir_path = ".";
+    const char *output_path = NULL;
+    bool check_allocations = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            sample_count = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_size = std::strtoul(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], NULL, 10);
+        } else if (std::strcmp(argv[i], "--workload") == 0 && i + 1 < argc) {
+            workload_names.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            engines.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output-dir") == 0 && i + 1 < argc) {
+            output_dir_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--check-allocations") == 0) {
+            check_allocations = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (batch_size == 0) {
+        batch_size = 1;
+    }
+    if (engines.empty()) {
+        engines = { "CSV", "JSONL", "COLUMNAR", "CDR", "STATISTICS" };
+    }
+
+    try {
+        std::vector<Workload> workloads =
+                create_workloads(workload_names, batch_size, seed);
+        if (workloads.empty()) {
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        std::vector<BenchResult> results;
+        for (auto& workload : workloads) {
+            for (auto& engine : engines) {
+                results.push_back(run(
+                        workload,
+                        engine,
+                        "files",
+                        output_dir_path,
+                        sample_count));
+                // only CSV files can be merged
+                if (engine == "CSV") {
+                    results.push_back(run(
+                            workload,
+                            engine,
+                            "merged",
+                            output_dir_path,
+                            sample_count));
+                }
+            }
+        }
+
+        if (output_path != NULL) {
+            std::ofstream output(output_path);
+            if (!output.good()) {
+                throw std::runtime_error(
+                        std::string("failed to open output file=")
+                        + output_path);
+            }
+            write_results(output, results, batch_size, seed);
+        } else {
+            write_results(std::cout, results, batch_size, seed);
+        }
+
+        return (check_allocations && !check_steady_allocations(results))
+                ? 1
+                : 0;
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+}
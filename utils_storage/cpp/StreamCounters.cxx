@@ -0,0 +1,584 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef RTI_WIN32
+    #include <windows.h>
+#endif
+
+#include "StreamCounters.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/*
+ * --- StreamCountersSnapshot -------------------------------------------------
+ */
+
+StreamCountersSnapshot::StreamCountersSnapshot() :
+    sample_count(0),
+    invalid_sample_count(0),
+    truncated_sample_count(0),
+    byte_count(0),
+    store_ns(0),
+    format_ns(0),
+    write_ns(0),
+    flush_count(0),
+    max_row_size(0),
+    buffer_growth_count(0),
+    buffer_bytes(0)
+{
+}
+
+StreamCountersSnapshot& StreamCountersSnapshot::operator+=(
+        const StreamCountersSnapshot& other)
+{
+    sample_count += other.sample_count;
+    invalid_sample_count += other.invalid_sample_count;
+    truncated_sample_count += other.truncated_sample_count;
+    byte_count += other.byte_count;
+    store_ns += other.store_ns;
+    format_ns += other.format_ns;
+    write_ns += other.write_ns;
+    flush_count += other.flush_count;
+    max_row_size = std::max(max_row_size, other.max_row_size);
+    buffer_growth_count += other.buffer_growth_count;
+    buffer_bytes += other.buffer_bytes;
+    store_latency += other.store_latency;
+    format_latency += other.format_latency;
+    write_latency += other.write_latency;
+
+    return *this;
+}
+
+/*
+ * --- StreamCounters ---------------------------------------------------------
+ */
+
+StreamCounters::StreamCounters() :
+    sample_count_(0),
+    invalid_sample_count_(0),
+    truncated_sample_count_(0),
+    byte_count_(0),
+    store_ns_(0),
+    format_ns_(0),
+    write_ns_(0),
+    flush_count_(0),
+    max_row_size_(0),
+    buffer_growth_count_(0),
+    buffer_bytes_(0)
+{
+}
+
+StreamCountersSnapshot StreamCounters::snapshot() const
+{
+    StreamCountersSnapshot value;
+    value.sample_count = sample_count_.load(std::memory_order_relaxed);
+    value.invalid_sample_count =
+            invalid_sample_count_.load(std::memory_order_relaxed);
+    value.truncated_sample_count =
+            truncated_sample_count_.load(std::memory_order_relaxed);
+    value.byte_count = byte_count_.load(std::memory_order_relaxed);
+    value.store_ns = store_ns_.load(std::memory_order_relaxed);
+    value.format_ns = format_ns_.load(std::memory_order_relaxed);
+    value.write_ns = write_ns_.load(std::memory_order_relaxed);
+    value.flush_count = flush_count_.load(std::memory_order_relaxed);
+    value.max_row_size = max_row_size_.load(std::memory_order_relaxed);
+    value.buffer_growth_count =
+            buffer_growth_count_.load(std::memory_order_relaxed);
+    value.buffer_bytes = buffer_bytes_.load(std::memory_order_relaxed);
+    value.store_latency = store_latency_.snapshot();
+    value.format_latency = format_latency_.snapshot();
+    value.write_latency = write_latency_.snapshot();
+
+    return value;
+}
+
+uint64_t StreamCounters::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * --- StatsReporterProperty --------------------------------------------------
+ */
+
+StatsReporterProperty::StatsReporterProperty() :
+    format_(StatsFormatKind::JSON),
+    period_ms_(10000)
+{
+}
+
+StatsReporterProperty& StatsReporterProperty::output_file_path(
+        const std::string& path)
+{
+    output_file_path_ = path;
+    return *this;
+}
+
+const std::string& StatsReporterProperty::output_file_path() const
+{
+    return output_file_path_;
+}
+
+StatsReporterProperty& StatsReporterProperty::format(StatsFormatKind kind)
+{
+    format_ = kind;
+    return *this;
+}
+
+StatsFormatKind StatsReporterProperty::format() const
+{
+    return format_;
+}
+
+StatsReporterProperty& StatsReporterProperty::period_ms(uint32_t period)
+{
+    period_ms_ = period;
+    return *this;
+}
+
+uint32_t StatsReporterProperty::period_ms() const
+{
+    return period_ms_;
+}
+
+/*
+ * --- StatsReporter ----------------------------------------------------------
+ */
+
+namespace {
+
+std::string json_string(const std::string& value)
+{
+    std::string escaped = "\"";
+    for (char character : value) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        } else if (static_cast<unsigned char>(character) < 0x20) {
+            // control characters are not expected in stream names
+            character = ' ';
+        }
+        escaped += character;
+    }
+    escaped += '"';
+
+    return escaped;
+}
+
+void write_json_latency(
+        std::ostream& output,
+        const LatencyHistogramSnapshot& latency)
+{
+    output << "{\"count\":" << latency.count()
+            << ",\"p50\":" << latency.value_at_percentile(50.0)
+            << ",\"p99\":" << latency.value_at_percentile(99.0)
+            << ",\"p999\":" << latency.value_at_percentile(99.9)
+            << ",\"max\":" << latency.max()
+            << "}";
+}
+
+void write_json_counters(
+        std::ostream& output,
+        const StreamCountersSnapshot& counters)
+{
+    output << "\"samples\":" << counters.sample_count
+            << ",\"invalid_samples\":" << counters.invalid_sample_count
+            << ",\"truncated_samples\":" << counters.truncated_sample_count
+            << ",\"bytes\":" << counters.byte_count
+            << ",\"store_ns\":" << counters.store_ns
+            << ",\"format_ns\":" << counters.format_ns
+            << ",\"write_ns\":" << counters.write_ns
+            << ",\"flushes\":" << counters.flush_count
+            << ",\"max_row_size\":" << counters.max_row_size
+            << ",\"buffer_growths\":" << counters.buffer_growth_count
+            << ",\"buffer_bytes\":" << counters.buffer_bytes;
+    output << ",\"store_latency_ns\":";
+    write_json_latency(output, counters.store_latency);
+    output << ",\"format_latency_ns\":";
+    write_json_latency(output, counters.format_latency);
+    output << ",\"write_latency_ns\":";
+    write_json_latency(output, counters.write_latency);
+}
+
+/*
+ * Description of a metric in Prometheus format and the counter it exposes
+ */
+struct PrometheusMetric {
+    const char *name;
+    const char *type;
+    const char *help;
+    uint64_t StreamCountersSnapshot::*counter;
+    // scale applied to the counter, to use the base units of Prometheus
+    double scale;
+};
+
+const PrometheusMetric PROMETHEUS_METRICS[] = {
+    { "utils_storage_samples_total", "counter",
+            "Samples received, valid or not",
+            &StreamCountersSnapshot::sample_count, 1.0 },
+    { "utils_storage_invalid_samples_total", "counter",
+            "Invalid samples skipped",
+            &StreamCountersSnapshot::invalid_sample_count, 1.0 },
+    { "utils_storage_truncated_samples_total", "counter",
+            "Samples with sequence elements that were not written",
+            &StreamCountersSnapshot::truncated_sample_count, 1.0 },
+    { "utils_storage_bytes_total", "counter",
+            "Bytes written into the output file",
+            &StreamCountersSnapshot::byte_count, 1.0 },
+    { "utils_storage_store_seconds_total", "counter",
+            "Time spent in the calls to store()",
+            &StreamCountersSnapshot::store_ns, 1e-9 },
+    { "utils_storage_format_seconds_total", "counter",
+            "Time spent formatting the samples",
+            &StreamCountersSnapshot::format_ns, 1e-9 },
+    { "utils_storage_write_seconds_total", "counter",
+            "Time spent writing the output file",
+            &StreamCountersSnapshot::write_ns, 1e-9 },
+    { "utils_storage_flushes_total", "counter",
+            "Flushes of the output file",
+            &StreamCountersSnapshot::flush_count, 1.0 },
+    { "utils_storage_max_row_size_bytes", "gauge",
+            "Size of the largest formatted row",
+            &StreamCountersSnapshot::max_row_size, 1.0 },
+    { "utils_storage_buffer_growths_total", "counter",
+            "Reallocations of the row buffer",
+            &StreamCountersSnapshot::buffer_growth_count, 1.0 },
+    { "utils_storage_buffer_bytes", "gauge",
+            "Bytes of the buffers of the stream writer",
+            &StreamCountersSnapshot::buffer_bytes, 1.0 }
+};
+
+void write_json_memory(std::ostream& output, const MemoryUsage& memory)
+{
+    output << "{\"used_bytes\":" << memory.used_bytes
+            << ",\"peak_bytes\":" << memory.peak_bytes
+            << ",\"unlimited_bytes\":" << memory.unlimited_bytes
+            << ",\"limit_bytes\":" << memory.limit_bytes
+            << ",\"limit_hits\":" << memory.limit_hit_count
+            << "}";
+}
+
+/*
+ * Description of a latency histogram exposed as a Prometheus summary
+ */
+struct PrometheusLatency {
+    const char *name;
+    const char *help;
+    LatencyHistogramSnapshot StreamCountersSnapshot::*latency;
+    // the sum of the values
+    uint64_t StreamCountersSnapshot::*sum;
+};
+
+const PrometheusLatency PROMETHEUS_LATENCIES[] = {
+    { "utils_storage_store_latency_seconds",
+            "Latency of the calls to store()",
+            &StreamCountersSnapshot::store_latency,
+            &StreamCountersSnapshot::store_ns },
+    { "utils_storage_format_latency_seconds",
+            "Format time of each sample",
+            &StreamCountersSnapshot::format_latency,
+            &StreamCountersSnapshot::format_ns },
+    { "utils_storage_write_latency_seconds",
+            "Write time of the samples of each call to store()",
+            &StreamCountersSnapshot::write_latency,
+            &StreamCountersSnapshot::write_ns }
+};
+
+const double PROMETHEUS_QUANTILES[] = { 0.5, 0.99, 0.999 };
+
+std::string prometheus_label(const std::string& value)
+{
+    std::string escaped;
+    for (char character : value) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+            escaped += character;
+        } else if (character == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += character;
+        }
+    }
+
+    return escaped;
+}
+
+}
+
+StatsReporter::StatsReporter(const StatsReporterProperty& property) :
+    property_(property),
+    stopped_(false)
+{
+    if (property_.period_ms() > 0) {
+        thread_ = std::thread(&StatsReporter::run, this);
+    }
+}
+
+StatsReporter::~StatsReporter()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopped_ = true;
+    }
+    stop_condition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    try {
+        dump();
+    } catch (const std::exception&) {
+        // nothing to report to at destruction
+    }
+}
+
+std::shared_ptr<StreamCounters> StatsReporter::add_stream(
+        const std::string& stream_name)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    // a series per stream name, even if the stream is created again
+    for (auto& stream : streams_) {
+        if (stream.first == stream_name) {
+            return stream.second;
+        }
+    }
+    std::shared_ptr<StreamCounters> counters =
+            std::make_shared<StreamCounters>();
+    streams_.push_back(std::make_pair(stream_name, counters));
+
+    return counters;
+}
+
+void StatsReporter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        stop_condition_.wait_for(
+                lock,
+                std::chrono::milliseconds(property_.period_ms()));
+        if (stopped_) {
+            break;
+        }
+        lock.unlock();
+        try {
+            dump();
+        } catch (const std::exception&) {
+            // retried on the next period
+        }
+        lock.lock();
+    }
+}
+
+std::vector<StatsReporter::StreamSnapshot> StatsReporter::snapshots()
+{
+    std::vector<StreamSnapshot> value;
+    std::lock_guard<std::mutex> guard(mutex_);
+    value.reserve(streams_.size());
+    for (auto& stream : streams_) {
+        value.push_back(std::make_pair(
+                stream.first,
+                stream.second->snapshot()));
+    }
+
+    return value;
+}
+
+void StatsReporter::memory_budget(std::shared_ptr<const MemoryBudget> budget)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    memory_budget_ = std::move(budget);
+}
+
+MemoryUsage StatsReporter::memory_usage()
+{
+    std::shared_ptr<const MemoryBudget> budget;
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        budget = memory_budget_;
+    }
+
+    return budget ? budget->usage() : MemoryUsage();
+}
+
+void StatsReporter::dump()
+{
+    std::vector<StreamSnapshot> streams = snapshots();
+    MemoryUsage memory = memory_usage();
+    StreamCountersSnapshot total;
+    for (auto& stream : streams) {
+        total += stream.second;
+    }
+
+    // readers never see a partial file
+    std::string temporary_path = property_.output_file_path() + ".tmp";
+    {
+        std::ofstream output(temporary_path);
+        if (!output.good()) {
+            throw std::runtime_error(
+                    "failed to open stats file=" + temporary_path);
+        }
+        if (property_.format() == StatsFormatKind::PROMETHEUS) {
+            write_prometheus(output, streams, memory);
+        } else {
+            write_json(output, streams, total, memory);
+        }
+        output.flush();
+        if (!output.good()) {
+            throw std::runtime_error(
+                    "failed to write stats file=" + temporary_path);
+        }
+    }
+    // replaced in place, so the file is never missing
+#ifndef RTI_WIN32
+    bool is_replaced = std::rename(
+            temporary_path.c_str(),
+            property_.output_file_path().c_str()) == 0;
+#else
+    bool is_replaced = MoveFileExA(
+            temporary_path.c_str(),
+            property_.output_file_path().c_str(),
+            MOVEFILE_REPLACE_EXISTING) != 0;
+#endif
+    if (!is_replaced) {
+        throw std::runtime_error(
+                "failed to replace stats file="
+                + property_.output_file_path());
+    }
+}
+
+std::string StatsReporter::summary()
+{
+    std::vector<StreamSnapshot> streams = snapshots();
+    StreamCountersSnapshot total;
+    for (auto& stream : streams) {
+        total += stream.second;
+    }
+
+    std::ostringstream output;
+    output << "{\"streams\":" << streams.size() << ",";
+    write_json_counters(output, total);
+    output << ",\"memory\":";
+    write_json_memory(output, memory_usage());
+    output << "}";
+
+    return output.str();
+}
+
+void StatsReporter::write_json(
+        std::ostream& output,
+        const std::vector<StreamSnapshot>& streams,
+        const StreamCountersSnapshot& total,
+        const MemoryUsage& memory)
+{
+    output << "{\"timestamp\":"
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count()
+            << ",\"streams\":[";
+    for (size_t i = 0; i < streams.size(); i++) {
+        output << (i == 0 ? "\n" : ",\n")
+                << "{\"stream\":" << json_string(streams[i].first) << ",";
+        write_json_counters(output, streams[i].second);
+        output << "}";
+    }
+    output << "],\n\"total\":{";
+    write_json_counters(output, total);
+    output << "},\n\"memory\":";
+    write_json_memory(output, memory);
+    output << "}\n";
+}
+
+void StatsReporter::write_prometheus(
+        std::ostream& output,
+        const std::vector<StreamSnapshot>& streams,
+        const MemoryUsage& memory)
+{
+    output.precision(15);
+    for (auto& metric : PROMETHEUS_METRICS) {
+        output << "# HELP " << metric.name << " " << metric.help << "\n"
+                << "# TYPE " << metric.name << " " << metric.type << "\n";
+        for (auto& stream : streams) {
+            output << metric.name
+                    << "{stream=\"" << prometheus_label(stream.first) << "\"} ";
+            if (metric.scale == 1.0) {
+                output << stream.second.*metric.counter;
+            } else {
+                output << stream.second.*metric.counter * metric.scale;
+            }
+            output << "\n";
+        }
+    }
+
+    for (auto& metric : PROMETHEUS_LATENCIES) {
+        output << "# HELP " << metric.name << " " << metric.help << "\n"
+                << "# TYPE " << metric.name << " summary\n";
+        for (auto& stream : streams) {
+            std::string label = prometheus_label(stream.first);
+            const LatencyHistogramSnapshot& latency =
+                    stream.second.*metric.latency;
+            for (double quantile : PROMETHEUS_QUANTILES) {
+                output << metric.name
+                        << "{stream=\"" << label
+                        << "\",quantile=\"" << quantile << "\"} "
+                        << latency.value_at_percentile(quantile * 100.0)
+                                * 1e-9
+                        << "\n";
+            }
+            output << metric.name << "_sum{stream=\"" << label << "\"} "
+                    << stream.second.*metric.sum * 1e-9 << "\n"
+                    << metric.name << "_count{stream=\"" << label << "\"} "
+                    << latency.count() << "\n";
+        }
+        output << "# HELP " << metric.name << "_max Largest value of "
+                << metric.name << "\n"
+                << "# TYPE " << metric.name << "_max gauge\n";
+        for (auto& stream : streams) {
+            output << metric.name << "_max{stream=\""
+                    << prometheus_label(stream.first) << "\"} "
+                    << (stream.second.*metric.latency).max() * 1e-9 << "\n";
+        }
+    }
+
+    // memory budget of all the streams
+    output << "# HELP utils_storage_memory_bytes"
+            << " Bytes of the buffers of all the streams\n"
+            << "# TYPE utils_storage_memory_bytes gauge\n"
+            << "utils_storage_memory_bytes " << memory.used_bytes << "\n"
+            << "# HELP utils_storage_memory_peak_bytes"
+            << " Largest value of utils_storage_memory_bytes\n"
+            << "# TYPE utils_storage_memory_peak_bytes gauge\n"
+            << "utils_storage_memory_peak_bytes " << memory.peak_bytes << "\n"
+            << "# HELP utils_storage_memory_unlimited_bytes"
+            << " Bytes of the column plans, not limited by the budget\n"
+            << "# TYPE utils_storage_memory_unlimited_bytes gauge\n"
+            << "utils_storage_memory_unlimited_bytes "
+            << memory.unlimited_bytes << "\n"
+            << "# HELP utils_storage_memory_limit_bytes"
+            << " Memory budget, 0 if there is none\n"
+            << "# TYPE utils_storage_memory_limit_bytes gauge\n"
+            << "utils_storage_memory_limit_bytes " << memory.limit_bytes
+            << "\n"
+            << "# HELP utils_storage_memory_limit_hits_total"
+            << " Updates that grew the usage beyond the memory budget\n"
+            << "# TYPE utils_storage_memory_limit_hits_total counter\n"
+            << "utils_storage_memory_limit_hits_total "
+            << memory.limit_hit_count << "\n";
+}
+
+} } }
@@ -0,0 +1,345 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_STREAMCOUNTERS_HPP_
+#define RTI_RECORDER_UTILS_STREAMCOUNTERS_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+#include "MemoryBudget.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Values of the counters of a stream at a point in time
+ */
+struct StreamCountersSnapshot {
+    StreamCountersSnapshot();
+
+    /**
+     * @brief Adds the counters of another stream. The max_row_size is the
+     * maximum of both.
+     */
+    StreamCountersSnapshot& operator+=(const StreamCountersSnapshot& other);
+
+    // samples received, valid or not
+    uint64_t sample_count;
+    // invalid samples (without data) skipped
+    uint64_t invalid_sample_count;
+    // samples with sequence elements that were not written
+    uint64_t truncated_sample_count;
+    // bytes written into the output file
+    uint64_t byte_count;
+    // time spent in the calls to store()
+    uint64_t store_ns;
+    // time spent converting the samples into their output format
+    uint64_t format_ns;
+    // time spent writing the output file
+    uint64_t write_ns;
+    // flushes of the output file
+    uint64_t flush_count;
+    // size of the largest formatted row
+    uint64_t max_row_size;
+    // reallocations of the buffer of the formatted rows
+    uint64_t buffer_growth_count;
+    // bytes of the buffers of the stream writer, after the last store()
+    uint64_t buffer_bytes;
+    // latency of each call to store()
+    LatencyHistogramSnapshot store_latency;
+    // format time of each sample
+    LatencyHistogramSnapshot format_latency;
+    // write time of the samples of each call to store()
+    LatencyHistogramSnapshot write_latency;
+};
+
+/**
+ * @brief Performance counters of a stream writer.
+ *
+ * The counters are only updated by the thread that stores the samples of the
+ * stream, and they can be read at any time from other threads. Each update
+ * is a relaxed load and store of the counter, without read-modify-write
+ * instructions nor synchronization, so the counters are cheap enough to be
+ * always enabled.
+ *
+ * The durations are also recorded in LatencyHistograms, to query their
+ * percentiles: the time of each call to store(), the format time of each
+ * sample and the write time of the samples of each call to store().
+ */
+class StreamCounters {
+public:
+    StreamCounters();
+
+    void add_sample()
+    {
+        increment(sample_count_, 1);
+    }
+
+    void add_invalid_sample()
+    {
+        increment(invalid_sample_count_, 1);
+    }
+
+    void add_truncated_sample()
+    {
+        increment(truncated_sample_count_, 1);
+    }
+
+    void add_bytes(uint64_t count)
+    {
+        increment(byte_count_, count);
+    }
+
+    void add_store_time(uint64_t nanosecs)
+    {
+        increment(store_ns_, nanosecs);
+        store_latency_.record(nanosecs);
+    }
+
+    void add_format_time(uint64_t nanosecs)
+    {
+        increment(format_ns_, nanosecs);
+        format_latency_.record(nanosecs);
+    }
+
+    void add_write_time(uint64_t nanosecs)
+    {
+        increment(write_ns_, nanosecs);
+        write_latency_.record(nanosecs);
+    }
+
+    void add_flush()
+    {
+        increment(flush_count_, 1);
+    }
+
+    void add_buffer_growth()
+    {
+        increment(buffer_growth_count_, 1);
+    }
+
+    void buffer_bytes(uint64_t bytes)
+    {
+        buffer_bytes_.store(bytes, std::memory_order_relaxed);
+    }
+
+    void row_size(uint64_t size)
+    {
+        if (size > max_row_size_.load(std::memory_order_relaxed)) {
+            max_row_size_.store(size, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Returns the current values of the counters
+     */
+    StreamCountersSnapshot snapshot() const;
+
+    /**
+     * @brief Returns the time of a monotonic clock in nanoseconds, to
+     * measure the durations added to the counters.
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Adds the time from its creation to its destruction as the time
+     * of a call to store()
+     */
+    class StoreScope {
+    public:
+        explicit StoreScope(StreamCounters& counters) :
+            counters_(counters),
+            begin_(now())
+        {
+        }
+
+        ~StoreScope()
+        {
+            counters_.add_store_time(now() - begin_);
+        }
+
+    private:
+        StreamCounters& counters_;
+        uint64_t begin_;
+    };
+
+private:
+    static void increment(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(
+                counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> sample_count_;
+    std::atomic<uint64_t> invalid_sample_count_;
+    std::atomic<uint64_t> truncated_sample_count_;
+    std::atomic<uint64_t> byte_count_;
+    std::atomic<uint64_t> store_ns_;
+    std::atomic<uint64_t> format_ns_;
+    std::atomic<uint64_t> write_ns_;
+    std::atomic<uint64_t> flush_count_;
+    std::atomic<uint64_t> max_row_size_;
+    std::atomic<uint64_t> buffer_growth_count_;
+    std::atomic<uint64_t> buffer_bytes_;
+    LatencyHistogram store_latency_;
+    LatencyHistogram format_latency_;
+    LatencyHistogram write_latency_;
+};
+
+/**
+ * @brief Representation of the stats file
+ */
+enum class StatsFormatKind {
+    // a JSON object with an entry per stream and the total
+    JSON,
+    // Prometheus text exposition format, with a stream label
+    PROMETHEUS
+};
+
+/**
+ * @brief Configuration elements of the StatsReporter
+ */
+class StatsReporterProperty {
+public:
+    StatsReporterProperty();
+
+    /**
+     * @brief Specifies the path of the stats file. The file is replaced on
+     * each dump, with a rename so it's never missing or partial.
+     *
+     * Default: empty (the counters are not reported)
+     */
+    StatsReporterProperty& output_file_path(const std::string& path);
+
+    /**
+     * @brief Gets the output_file_path
+     */
+    const std::string& output_file_path() const;
+
+    /**
+     * @brief Specifies the representation of the stats file
+     *
+     * Default: StatsFormatKind::JSON
+     */
+    StatsReporterProperty& format(StatsFormatKind kind);
+
+    /**
+     * @brief Gets the format
+     */
+    StatsFormatKind format() const;
+
+    /**
+     * @brief Specifies the period of the dumps in milliseconds. With a
+     * period of 0, the file is only written when the reporter is deleted.
+     *
+     * Default: 10000
+     */
+    StatsReporterProperty& period_ms(uint32_t period);
+
+    /**
+     * @brief Gets the period_ms
+     */
+    uint32_t period_ms() const;
+
+private:
+    std::string output_file_path_;
+    StatsFormatKind format_;
+    uint32_t period_ms_;
+};
+
+/**
+ * @brief Aggregates the counters of the streams and writes them periodically
+ * into a stats file, from a thread of its own.
+ *
+ * The counters of a stream are kept after its stream writer is deleted, so
+ * each dump contains all the streams created since the reporter was
+ * created. A stream created again with the same name keeps adding to its
+ * previous counters, so each stream name is reported once. A last dump is
+ * written when the reporter is deleted.
+ */
+class StatsReporter {
+public:
+    /**
+     * @brief Creates a reporter and starts its dump thread, if the period
+     * is not 0.
+     */
+    explicit StatsReporter(const StatsReporterProperty& property);
+
+    /**
+     * @brief Stops the dump thread and writes the final dump
+     */
+    ~StatsReporter();
+
+    /**
+     * @brief Returns the counters to be updated by the writer of a stream.
+     * They're the ones of the previous stream with the same name, if any.
+     */
+    std::shared_ptr<StreamCounters> add_stream(const std::string& stream_name);
+
+    /**
+     * @brief Sets the MemoryBudget whose usage is reported along with the
+     * counters
+     */
+    void memory_budget(std::shared_ptr<const MemoryBudget> budget);
+
+    /**
+     * @brief Writes the current counters into the stats file. Throws
+     * std::runtime_error if the file cannot be written.
+     */
+    void dump();
+
+    /**
+     * @brief Returns the total of the counters of all the streams, as a
+     * single-line JSON object
+     */
+    std::string summary();
+
+private:
+    typedef std::pair<std::string, StreamCountersSnapshot> StreamSnapshot;
+
+    void run();
+    std::vector<StreamSnapshot> snapshots();
+    MemoryUsage memory_usage();
+    void write_json(
+            std::ostream& output,
+            const std::vector<StreamSnapshot>& streams,
+            const StreamCountersSnapshot& total,
+            const MemoryUsage& memory);
+    void write_prometheus(
+            std::ostream& output,
+            const std::vector<StreamSnapshot>& streams,
+            const MemoryUsage& memory);
+
+    StatsReporterProperty property_;
+    // counters by stream name, in creation order
+    std::vector<std::pair<std::string, std::shared_ptr<StreamCounters>>>
+            streams_;
+    std::shared_ptr<const MemoryBudget> memory_budget_;
+    std::mutex mutex_;
+    std::condition_variable stop_condition_;
+    bool stopped_;
+    std::thread thread_;
+};
+
+} } }
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#include "Tracer.hpp"
+
+namespace rti { namespace recorder { namespace utils {
+
+Tracer::ThreadBuffer::ThreadBuffer(uint32_t capacity, uint32_t thread_id) :
+    events(capacity),
+    count(0),
+    thread_id(thread_id)
+{
+}
+
+Tracer::Tracer() :
+    enabled_(false),
+    events_per_thread_(EVENTS_PER_THREAD_DEFAULT()),
+    origin_(now())
+{
+}
+
+Tracer& Tracer::instance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+uint32_t Tracer::EVENTS_PER_THREAD_DEFAULT()
+{
+    return 65536;
+}
+
+void Tracer::enable(uint32_t events_per_thread)
+{
+    events_per_thread_.store(
+            events_per_thread > 0 ? events_per_thread : 1,
+            std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t Tracer::detail_id(const std::string& detail)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (size_t i = 0; i < details_.size(); i++) {
+        if (details_[i] == detail) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    details_.push_back(detail);
+
+    return static_cast<uint32_t>(details_.size() - 1);
+}
+
+Tracer::ThreadBuffer& Tracer::thread_buffer()
+{
+    // created on the first event of each thread
+    static thread_local ThreadBuffer *buffer = NULL;
+    if (buffer == NULL) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        buffers_.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer(
+                events_per_thread_.load(std::memory_order_relaxed),
+                static_cast<uint32_t>(buffers_.size() + 1))));
+        buffer = buffers_.back().get();
+    }
+
+    return *buffer;
+}
+
+void Tracer::record(
+        const char *name,
+        uint64_t begin,
+        uint64_t end,
+        uint32_t detail)
+{
+    ThreadBuffer& buffer = thread_buffer();
+    uint64_t count = buffer.count.load(std::memory_order_relaxed);
+    Event& event = buffer.events[count % buffer.events.size()];
+    event.name = name;
+    event.begin = begin;
+    event.duration = end - begin;
+    event.detail = detail;
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+namespace {
+
+void write_json_string(std::ostream& output, const std::string& value)
+{
+    output << '"';
+    for (char character : value) {
+        if (character == '"' || character == '\\') {
+            output << '\\' << character;
+        } else if (static_cast<unsigned char>(character) < 0x20) {
+            output << ' ';
+        } else {
+            output << character;
+        }
+    }
+    output << '"';
+}
+
+}
+
+void Tracer::write(const std::string& output_file_path)
+{
+    std::ofstream output(output_file_path);
+    if (!output.good()) {
+        throw std::runtime_error(
+                "failed to open trace file=" + output_file_path);
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+            << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+            << "\"args\":{\"name\":\"utils_storage\"}}";
+    char timestamps[64];
+    for (auto& buffer : buffers_) {
+        output << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                << "\"tid\":" << buffer->thread_id
+                << ",\"args\":{\"name\":\"thread " << buffer->thread_id
+                << "\"}}";
+
+        // the oldest events were overwritten if the buffer is full
+        uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->events.size();
+        uint64_t first = count > capacity ? count - capacity : 0;
+        for (uint64_t i = first; i < count; i++) {
+            const Event& event = buffer->events[i % capacity];
+            // microseconds with nanosecond precision
+            std::snprintf(
+                    timestamps,
+                    sizeof(timestamps),
+                    "\"ts\":%.3f,\"dur\":%.3f",
+                    (event.begin - origin_) / 1000.0,
+                    event.duration / 1000.0);
+            output << ",\n{\"name\":\"" << event.name
+                    << "\",\"cat\":\"utils_storage\",\"ph\":\"X\","
+                    << timestamps
+                    << ",\"pid\":1,\"tid\":" << buffer->thread_id;
+            if (event.detail < details_.size()) {
+                output << ",\"args\":{\"stream\":";
+                write_json_string(output, details_[event.detail]);
+                output << "}";
+            }
+            output << "}";
+        }
+    }
+    output << "\n]}\n";
+
+    output.flush();
+    if (!output.good()) {
+        throw std::runtime_error(
+                "failed to write trace file=" + output_file_path);
+    }
+}
+
+} } }
@@ -0,0 +1,172 @@
+/*
+ * (c) 2019 Copyright, Real-Time Innovations, Inc.  All rights reserved.
+ *
+ * RTI grants Licensee a license to use, modify, compile, and create derivative
+ * works of the Software.  Licensee has the right to distribute object form
+ * only for use with RTI products.  The Software is provided "as is", with no
+ * warranty of any type, including any warranty for fitness for any purpose.
+ * RTI is under no obligation to maintain or support the Software.  RTI shall
+ * not be liable for any incidental or consequential damages arising out of the
+ * use or inability to use the software.
+ */
+
+#ifndef RTI_RECORDER_UTILS_TRACER_HPP_
+#define RTI_RECORDER_UTILS_TRACER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rti { namespace recorder { namespace utils {
+
+/**
+ * @brief Records the duration of the stages of the plug-in (stream
+ * creation, store, merge...) to write them as a Chrome trace file, which
+ * can be opened with chrome://tracing or Perfetto.
+ *
+ * Tracing is disabled by default. Once enabled, each thread records its
+ * events into a ring buffer of its own, without locks, so the oldest
+ * events of a thread are overwritten when its buffer is full. The events
+ * are written when write() is called, typically at shutdown.
+ *
+ * The tracer is a process-wide instance, as the Logger.
+ */
+class Tracer {
+public:
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    static Tracer& instance();
+
+    /**
+     * @brief Starts recording events, with buffers of the specified number
+     * of events per thread. The buffers that already exist keep their
+     * size.
+     */
+    void enable(uint32_t events_per_thread);
+
+    /**
+     * @brief Stops recording events. The recorded events are kept.
+     */
+    void disable();
+
+    bool is_enabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the identifier of a detail string, e.g. a stream name,
+     * to attach it to events. The string is kept until the tracer is
+     * destroyed.
+     */
+    uint32_t detail_id(const std::string& detail);
+
+    /**
+     * @brief Records a complete event of the calling thread
+     *
+     * @param[in] name Name of the event. It must be a string literal.
+     * @param[in] begin Time the event started, from now()
+     * @param[in] end Time the event ended, from now()
+     * @param[in] detail Identifier returned by detail_id(), or
+     *                   NO_DETAIL()
+     */
+    void record(
+            const char *name,
+            uint64_t begin,
+            uint64_t end,
+            uint32_t detail);
+
+    /**
+     * @brief Writes the events recorded by all the threads in Chrome trace
+     * JSON format. Throws std::runtime_error if the file cannot be written.
+     *
+     * The threads must not record events while the file is written.
+     */
+    void write(const std::string& output_file_path);
+
+    /**
+     * @brief Time of a monotonic clock in nanoseconds
+     */
+    static uint64_t now();
+
+    static uint32_t NO_DETAIL()
+    {
+        return UINT32_MAX;
+    }
+
+    /**
+     * @brief Default number of events of the buffer of each thread
+     *
+     * Value: 65536
+     */
+    static uint32_t EVENTS_PER_THREAD_DEFAULT();
+
+private:
+    struct Event {
+        const char *name;
+        uint64_t begin;
+        uint64_t duration;
+        uint32_t detail;
+    };
+
+    /*
+     * Ring buffer of the events of a thread. Only the thread writes it.
+     */
+    struct ThreadBuffer {
+        explicit ThreadBuffer(uint32_t capacity, uint32_t thread_id);
+
+        std::vector<Event> events;
+        // events recorded since the buffer was created
+        std::atomic<uint64_t> count;
+        uint32_t thread_id;
+    };
+
+    Tracer();
+
+    ThreadBuffer& thread_buffer();
+
+    std::atomic<bool> enabled_;
+    std::atomic<uint32_t> events_per_thread_;
+    // origin of the event timestamps
+    uint64_t origin_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    std::vector<std::string> details_;
+};
+
+/**
+ * @brief Records an event of the tracer from its creation to its
+ * destruction, if tracing is enabled
+ */
+class TraceScope {
+public:
+    TraceScope(const char *name, uint32_t detail = Tracer::NO_DETAIL()) :
+        name_(name),
+        detail_(detail),
+        begin_(Tracer::instance().is_enabled() ? Tracer::now() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (begin_ != 0) {
+            Tracer::instance().record(name_, begin_, Tracer::now(), detail_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char *name_;
+    uint32_t detail_;
+    uint64_t begin_;
+};
+
+} } }
+
+#endif
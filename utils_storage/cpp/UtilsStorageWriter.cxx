@@ -11,10 +11,13 @@
  */
 
 #include <algorithm>
+#include <cstring>
 
+#include <rti/core/xtypes/DynamicDataFuncs.hpp>
 #include <rti/util/StreamFlagSaver.hpp>
 #include "UtilsStorageWriter.hpp"
 #include "PrintFormatCsv.hpp"
+#include "FastFormat.hpp"
 #include "Logger.hpp"
 
 #define NANOSECS_PER_SEC 1000000000ll
@@ -25,9 +28,193 @@
 
 namespace rti { namespace recorder { namespace utils {
 
+const std::string& output_format_name(OutputFormatKind kind)
+{
+    static const std::string csv_name = "CSV";
+    static const std::string columnar_name = "COLUMNAR";
+    static const std::string json_lines_name = "JSONL";
+    static const std::string cdr_name = "CDR";
+    static const std::string statistics_name = "STATISTICS";
+
+    switch (kind) {
+    case OutputFormatKind::COLUMNAR_FORMAT:
+        return columnar_name;
+
+    case OutputFormatKind::JSON_LINES_FORMAT:
+        return json_lines_name;
+
+    case OutputFormatKind::CDR_FORMAT:
+        return cdr_name;
+
+    case OutputFormatKind::STATISTICS_FORMAT:
+        return statistics_name;
+
+    default:
+        return csv_name;
+    }
+}
+
+const std::vector<OutputFormatKind>& output_format_kinds()
+{
+    static const std::vector<OutputFormatKind> value = {
+        OutputFormatKind::CSV_FORMAT,
+        OutputFormatKind::COLUMNAR_FORMAT,
+        OutputFormatKind::JSON_LINES_FORMAT,
+        OutputFormatKind::CDR_FORMAT,
+        OutputFormatKind::STATISTICS_FORMAT
+    };
+
+    return value;
+}
+
+const std::string& octet_encoding_name(OctetEncodingKind kind)
+{
+    static const std::string hex_name = "HEX";
+    static const std::string base64_name = "BASE64";
+
+    return (kind == OctetEncodingKind::HEX) ? hex_name : base64_name;
+}
+
+const std::vector<OctetEncodingKind>& octet_encoding_kinds()
+{
+    static const std::vector<OctetEncodingKind> value = {
+        OctetEncodingKind::HEX,
+        OctetEncodingKind::BASE64
+    };
+
+    return value;
+}
+
+const std::string& stats_format_name(StatsFormatKind kind)
+{
+    static const std::string json_name = "JSON";
+    static const std::string prometheus_name = "PROMETHEUS";
+
+    switch (kind) {
+    case StatsFormatKind::PROMETHEUS:
+        return prometheus_name;
+
+    default:
+        return json_name;
+    }
+}
+
+const std::vector<StatsFormatKind>& stats_format_kinds()
+{
+    static const std::vector<StatsFormatKind> value = {
+        StatsFormatKind::JSON,
+        StatsFormatKind::PROMETHEUS
+    };
+
+    return value;
+}
+
+const std::string& memory_budget_policy_name(MemoryBudgetPolicyKind kind)
+{
+    static const std::string flush_name = "FLUSH";
+    static const std::string shrink_name = "SHRINK";
+    static const std::string block_name = "BLOCK";
+
+    switch (kind) {
+    case MemoryBudgetPolicyKind::SHRINK:
+        return shrink_name;
+
+    case MemoryBudgetPolicyKind::BLOCK:
+        return block_name;
+
+    default:
+        return flush_name;
+    }
+}
+
+const std::vector<MemoryBudgetPolicyKind>& memory_budget_policy_kinds()
+{
+    static const std::vector<MemoryBudgetPolicyKind> value = {
+        MemoryBudgetPolicyKind::FLUSH,
+        MemoryBudgetPolicyKind::SHRINK,
+        MemoryBudgetPolicyKind::BLOCK
+    };
+
+    return value;
+}
+
+const std::string& dictionary_encoding_name(DictionaryEncodingKind kind)
+{
+    static const std::string none_name = "NONE";
+    static const std::string enums_name = "ENUMS";
+    static const std::string enums_and_strings_name = "ENUMS_AND_STRINGS";
+
+    switch (kind) {
+    case DictionaryEncodingKind::ENUMS:
+        return enums_name;
+
+    case DictionaryEncodingKind::ENUMS_AND_STRINGS:
+        return enums_and_strings_name;
+
+    default:
+        return none_name;
+    }
+}
+
+const std::vector<DictionaryEncodingKind>& dictionary_encoding_kinds()
+{
+    static const std::vector<DictionaryEncodingKind> value = {
+        DictionaryEncodingKind::NONE,
+        DictionaryEncodingKind::ENUMS,
+        DictionaryEncodingKind::ENUMS_AND_STRINGS
+    };
+
+    return value;
+}
+
+const std::string& delta_rows_name(DeltaRowKind kind)
+{
+    static const std::string none_name = "NONE";
+    static const std::string changed_rows_name = "CHANGED_ROWS";
+    static const std::string changed_cells_name = "CHANGED_CELLS";
+
+    switch (kind) {
+    case DeltaRowKind::CHANGED_ROWS:
+        return changed_rows_name;
+
+    case DeltaRowKind::CHANGED_CELLS:
+        return changed_cells_name;
+
+    default:
+        return none_name;
+    }
+}
+
+const std::vector<DeltaRowKind>& delta_row_kinds()
+{
+    static const std::vector<DeltaRowKind> value = {
+        DeltaRowKind::NONE,
+        DeltaRowKind::CHANGED_ROWS,
+        DeltaRowKind::CHANGED_CELLS
+    };
+
+    return value;
+}
+
+std::string metadata_columns_name(uint32_t columns)
+{
+    std::string value;
+    for (auto kind : MetadataEmitter::column_kinds()) {
+        if ((columns & static_cast<uint32_t>(kind)) != 0) {
+            if (!value.empty()) {
+                value += ",";
+            }
+            value += MetadataEmitter::column_name(kind);
+        }
+    }
+
+    return value;
+}
+
 UtilsStorageProperty::UtilsStorageProperty()
     : output_dir_path_("."),
       merge_output_files_(false),
+      write_empty_streams_(false),
       output_format_kind_(OutputFormatKind::CSV_FORMAT)
 {
 }
@@ -61,6 +248,13 @@ UtilsStorageProperty& UtilsStorageProperty::merge_output_files(bool merge)
     return *this;
 }
 
+UtilsStorageProperty& UtilsStorageProperty::write_empty_streams(bool write)
+{
+    write_empty_streams_ = write;
+
+    return *this;
+}
+
 std::string UtilsStorageProperty::output_dir_path() const
 {
     return output_dir_path_;
@@ -81,6 +275,11 @@ bool UtilsStorageProperty::merge_output_files() const
     return merge_output_files_;
 }
 
+bool UtilsStorageProperty::write_empty_streams() const
+{
+    return write_empty_streams_;
+}
+
 std::ostream& operator<<(
         std::ostream& os,
         const UtilsStorageProperty& property)
@@ -101,12 +300,24 @@ std::ostream& operator<<(
             << property.output_file_basename()
             << "\n";
 
+    os << "\t" <<
+            UtilsStorageWriter::OUTPUT_FORMAT_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << output_format_name(property.output_format_kind())
+            << "\n";
+
     os << "\t" <<
             UtilsStorageWriter::OUTPUT_MERGE_PROPERTY_NAME().substr(namespace_length)
             << "="
             << std::boolalpha << property.merge_output_files()
             << "\n";
 
+    os << "\t" <<
+            UtilsStorageWriter::OUTPUT_EMPTY_STREAMS_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << std::boolalpha << property.write_empty_streams()
+            << "\n";
+
     os << "\t" <<
             UtilsStorageWriter::LOGGING_VERBOSITY_PROPERTY_NAME().substr(namespace_length)
             << "="
@@ -132,7 +343,127 @@ std::ostream& operator<<(
     os << "\t" <<
             UtilsStorageWriter::CSV_ENUM_AS_STRING_PROPERTY_NAME().substr(namespace_length)
             << "="
-            << std::boolalpha << property.enum_as_string();
+            << std::boolalpha << property.enum_as_string()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_EXPLODED_SEQUENCE_MIN_BOUND_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.exploded_sequence_min_bound()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::UNBOUNDED_SEQUENCE_INLINE_LENGTH_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.unbounded_sequence_inline_length()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_PACKED_PRIMITIVE_COLLECTIONS_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << std::boolalpha << property.packed_primitive_collections()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_PACKED_VALUE_SEPARATOR_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.packed_value_separator()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_OCTET_ENCODING_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << octet_encoding_name(property.octet_encoding())
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_DICTIONARY_ENCODING_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << dictionary_encoding_name(property.dictionary_encoding())
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_DELTA_ROWS_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << delta_rows_name(property.delta_rows())
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_KEYFRAME_INTERVAL_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.keyframe_interval()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::CSV_METADATA_COLUMNS_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << metadata_columns_name(property.metadata_columns());
+
+    return os;
+}
+
+std::ostream& operator<<(
+        std::ostream& os,
+        const ColumnarFormatProperty& property)
+{
+    size_t namespace_length =
+            UtilsStorageWriter::PROPERTY_NAMESPACE().length() + 1;
+    os << "\t" <<
+            UtilsStorageWriter::COLUMNAR_ROWS_PER_CHUNK_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.rows_per_chunk();
+
+    return os;
+}
+
+std::ostream& operator<<(
+        std::ostream& os,
+        const StatsReporterProperty& property)
+{
+    size_t namespace_length =
+            UtilsStorageWriter::PROPERTY_NAMESPACE().length() + 1;
+    os << "\t" <<
+            UtilsStorageWriter::STATS_OUTPUT_FILE_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.output_file_path()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::STATS_FORMAT_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << stats_format_name(property.format())
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::STATS_PERIOD_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.period_ms();
+
+    return os;
+}
+
+std::ostream& operator<<(
+        std::ostream& os,
+        const MemoryBudgetProperty& property)
+{
+    size_t namespace_length =
+            UtilsStorageWriter::PROPERTY_NAMESPACE().length() + 1;
+    os << "\t" <<
+            UtilsStorageWriter::MEMORY_BUDGET_LIMIT_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.limit_bytes()
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::MEMORY_BUDGET_POLICY_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << memory_budget_policy_name(property.policy())
+            << "\n";
+
+    os << "\t" <<
+            UtilsStorageWriter::MEMORY_BUDGET_BLOCK_TIMEOUT_PROPERTY_NAME().substr(namespace_length)
+            << "="
+            << property.block_timeout_ms();
 
     return os;
 }
@@ -210,6 +541,13 @@ const std::string& UtilsStorageWriter::OUTPUT_MERGE_PROPERTY_NAME()
     return value;
 }
 
+const std::string& UtilsStorageWriter::OUTPUT_EMPTY_STREAMS_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".write_empty_streams";
+    return value;
+}
+
 const std::string& UtilsStorageWriter::LOGGING_VERBOSITY_PROPERTY_NAME()
 {
     static const std::string value = PROPERTY_NAMESPACE()
@@ -231,67 +569,276 @@ const std::string& UtilsStorageWriter::CSV_ENUM_AS_STRING_PROPERTY_NAME()
     return value;
 }
 
-
-const std::string& UtilsStorageWriter::CSV_FILE_EXTENSION()
+const std::string& UtilsStorageWriter::CSV_EXPLODED_SEQUENCE_MIN_BOUND_PROPERTY_NAME()
 {
-    static const std::string value = ".csv";
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.exploded_sequence_min_bound";
     return value;
 }
 
-const std::string& UtilsStorageWriter::OUTPUT_FILE_BASENAME_DEFAULT()
+const std::string& UtilsStorageWriter::UNBOUNDED_SEQUENCE_INLINE_LENGTH_PROPERTY_NAME()
 {
-    static const std::string value = "csv_converted";
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".unbounded_sequence_inline_length";
     return value;
 }
 
+const std::string& UtilsStorageWriter::CSV_PACKED_PRIMITIVE_COLLECTIONS_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.packed_primitive_collections";
+    return value;
+}
 
-char UtilsStorageWriter::FILE_NAME_REPLACEMENT_CHAR()
+const std::string& UtilsStorageWriter::CSV_PACKED_VALUE_SEPARATOR_PROPERTY_NAME()
 {
-    static char value = '#';
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.packed_value_separator";
+    return value;
+}
 
+const std::string& UtilsStorageWriter::CSV_OCTET_ENCODING_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.octet_encoding";
     return value;
 }
 
+const std::string& UtilsStorageWriter::CSV_DICTIONARY_ENCODING_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.dictionary_encoding";
+    return value;
+}
 
-/*
- * @brief Helper for the static initialization of the constant default
- * values for a UtilsStorageProperty.
- *
- * Instead of declaring a constructor that takes all the parameters, this
- * patterns allows to set each member individually through a setter within
- * the constructor of this initializer class. Then an object of this class
- * can be statically initialized and guarantee atomic construction as per the
- * C++ conditions.
- */
-struct UtilsStoragePropertDefaultInitializer {
+const std::string& UtilsStorageWriter::CSV_DELTA_ROWS_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.delta_rows";
+    return value;
+}
 
-    UtilsStoragePropertDefaultInitializer()
-    {
-        value.merge_output_files(true);
-        value.output_dir_path(".");
-        value.output_file_basename(UtilsStorageWriter::OUTPUT_FILE_BASENAME_DEFAULT());
-        value.output_format_kind(OutputFormatKind::CSV_FORMAT);
-    }
-    UtilsStorageProperty value;
-};
+const std::string& UtilsStorageWriter::CSV_KEYFRAME_INTERVAL_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.keyframe_interval";
+    return value;
+}
 
-const UtilsStorageProperty& UtilsStorageWriter::PROPERTY_DEFAULT()
+const std::string& UtilsStorageWriter::CSV_METADATA_COLUMNS_PROPERTY_NAME()
 {
-    static UtilsStoragePropertDefaultInitializer property;
-    return property.value;
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".csv.metadata_columns";
+    return value;
 }
 
 
-/*
- * In the xml configuration, under the property tag for the storage plugin, a
- * collection of name/value pairs can be passed. In this case, this example
- * chooses to define a property to name the filename to use.
- */
-UtilsStorageWriter::UtilsStorageWriter(
+const std::string& UtilsStorageWriter::COLUMNAR_ROWS_PER_CHUNK_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".columnar.rows_per_chunk";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::COLUMN_PLAN_BUILD_THREADS_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".column_plan.build_threads";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::CHECKPOINT_PERIOD_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".checkpoint.period_ms";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::CHECKPOINT_RESUME_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".checkpoint.resume";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::STATS_OUTPUT_FILE_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".stats.output_file";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::STATS_FORMAT_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".stats.format";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::STATS_PERIOD_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".stats.period_ms";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::MEMORY_BUDGET_LIMIT_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".memory_budget.limit_bytes";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::MEMORY_BUDGET_POLICY_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".memory_budget.policy";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::MEMORY_BUDGET_BLOCK_TIMEOUT_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".memory_budget.block_timeout_ms";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::TRACE_OUTPUT_FILE_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".trace.output_file";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::TRACE_EVENTS_PER_THREAD_PROPERTY_NAME()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".trace.events_per_thread";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::PROJECTION_PROPERTY_NAME_PREFIX()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".projection.";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::FILTER_PROPERTY_NAME_PREFIX()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".filter.";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::DECIMATION_PROPERTY_NAME_PREFIX()
+{
+    static const std::string value = PROPERTY_NAMESPACE()
+            + ".decimation.";
+    return value;
+}
+
+
+const std::string& UtilsStorageWriter::CSV_FILE_EXTENSION()
+{
+    static const std::string value = ".csv";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::COLUMNAR_FILE_EXTENSION()
+{
+    static const std::string value = ".columnar";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::JSON_LINES_FILE_EXTENSION()
+{
+    static const std::string value = ".jsonl";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::CDR_FILE_EXTENSION()
+{
+    static const std::string value = ".cdrseg";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::CDR_INDEX_FILE_EXTENSION()
+{
+    static const std::string value = ".cdridx";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::STATISTICS_FILE_EXTENSION()
+{
+    static const std::string value = ".stats.csv";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::CSV_DICTIONARY_FILE_SUFFIX()
+{
+    static const std::string value = "-dictionary";
+    return value;
+}
+
+const std::string& UtilsStorageWriter::OUTPUT_FILE_BASENAME_DEFAULT()
+{
+    static const std::string value = "csv_converted";
+    return value;
+}
+
+
+char UtilsStorageWriter::FILE_NAME_REPLACEMENT_CHAR()
+{
+    static char value = '#';
+
+    return value;
+}
+
+
+/*
+ * @brief Helper for the static initialization of the constant default
+ * values for a UtilsStorageProperty.
+ *
+ * Instead of declaring a constructor that takes all the parameters, this
+ * patterns allows to set each member individually through a setter within
+ * the constructor of this initializer class. Then an object of this class
+ * can be statically initialized and guarantee atomic construction as per the
+ * C++ conditions.
+ */
+struct UtilsStoragePropertDefaultInitializer {
+
+    UtilsStoragePropertDefaultInitializer()
+    {
+        value.merge_output_files(true);
+        value.output_dir_path(".");
+        value.output_file_basename(UtilsStorageWriter::OUTPUT_FILE_BASENAME_DEFAULT());
+        value.output_format_kind(OutputFormatKind::CSV_FORMAT);
+    }
+    UtilsStorageProperty value;
+};
+
+const UtilsStorageProperty& UtilsStorageWriter::PROPERTY_DEFAULT()
+{
+    static UtilsStoragePropertDefaultInitializer property;
+    return property.value;
+}
+
+
+/*
+ * In the xml configuration, under the property tag for the storage plugin, a
+ * collection of name/value pairs can be passed. In this case, this example
+ * chooses to define a property to name the filename to use.
+ */
+UtilsStorageWriter::UtilsStorageWriter(
         const rti::routing::PropertySet& properties) :
     StorageWriter(properties),
     property_(PROPERTY_DEFAULT()),
-    csv_property_(PrintFormatCsv::PROPERTY_DEFAULT())
+    csv_property_(PrintFormatCsv::PROPERTY_DEFAULT()),
+    column_plan_thread_count_(0),
+    checkpoint_period_ms_(0),
+    checkpoint_resume_(false),
+    trace_events_per_thread_(Tracer::EVENTS_PER_THREAD_DEFAULT())
 {
 
     // verbosity
@@ -339,7 +886,14 @@ UtilsStorageWriter::UtilsStorageWriter(
     // output format
     found = properties.find(OUTPUT_FORMAT_PROPERTY_NAME());
     if (found != properties.end()) {
-        if (found->second != "CSV") {
+        bool is_supported = false;
+        for (auto kind : output_format_kinds()) {
+            if (found->second == output_format_name(kind)) {
+                property_.output_format_kind(kind);
+                is_supported = true;
+            }
+        }
+        if (!is_supported) {
             throw dds::core::UnsupportedError(
                     "unsupported output format=" + found->second);
         }
@@ -362,6 +916,32 @@ UtilsStorageWriter::UtilsStorageWriter(
         property_.merge_output_files(value);
 
     }
+
+    // output files of the streams without samples
+    found = properties.find(OUTPUT_EMPTY_STREAMS_PROPERTY_NAME());
+    if (found != properties.end()) {
+        std::istringstream bool_as_string(found->second);
+        bool value = false;
+        try {
+            bool_as_string >> std::boolalpha >> value;
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + OUTPUT_EMPTY_STREAMS_PROPERTY_NAME()
+                    + ": valid values are 'true' or 'false'");
+        }
+        property_.write_empty_streams(value);
+    }
+    if (property_.merge_output_files()
+            && property_.output_format_kind() != OutputFormatKind::CSV_FORMAT) {
+        // Only text files can be consolidated
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                rti::config::Verbosity::WARNING,
+                "UtilsStorageWriter: merge of output files is only supported "
+                "for CSV format. Merge disabled.");
+        property_.merge_output_files(false);
+    }
     if (property_.merge_output_files()) {
         // build output file name
         std::string output_file_name =
@@ -400,64 +980,676 @@ UtilsStorageWriter::UtilsStorageWriter(
         csv_property_.enum_as_string(value);
     }
 
-    /* Log summary of configuration */
-    if (Logger::instance().verbosity().underlying()
-            >= rti::config::Verbosity::STATUS_LOCAL) {
-        std::ostringstream summary;
+    // sequences written into child tables
+    found = properties.find(CSV_EXPLODED_SEQUENCE_MIN_BOUND_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + CSV_EXPLODED_SEQUENCE_MIN_BOUND_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+        csv_property_.exploded_sequence_min_bound(value);
+    }
 
-        summary << "Utils Storage plug-in configuration:" << "\n";
-        summary << property_;
-        summary << csv_property_;
+    // element columns of the unbounded sequences
+    found = properties.find(UNBOUNDED_SEQUENCE_INLINE_LENGTH_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + UNBOUNDED_SEQUENCE_INLINE_LENGTH_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+        csv_property_.unbounded_sequence_inline_length(value);
+    }
 
-        RTI_RECORDER_UTILS_LOG_MESSAGE(
-                    rti::config::Verbosity::STATUS_LOCAL,
-                    summary.str().c_str());
+    // primitive collections in a single column
+    found = properties.find(CSV_PACKED_PRIMITIVE_COLLECTIONS_PROPERTY_NAME());
+    if (found != properties.end()) {
+        std::istringstream bool_as_string(found->second);
+        bool value = false;
+        try {
+            bool_as_string >> std::boolalpha >> value;
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + CSV_PACKED_PRIMITIVE_COLLECTIONS_PROPERTY_NAME()
+                    + ": valid values are 'true' or 'false'");
+        }
+        csv_property_.packed_primitive_collections(value);
     }
-}
 
-UtilsStorageWriter::~UtilsStorageWriter()
-{
-    if (property_.merge_output_files()) {
-        RTI_RECORDER_UTILS_LOG_MESSAGE(
-                rti::config::Verbosity::STATUS_LOCAL,
-                "UtilsStorageWriter: delete output files after merge");
-        for (auto it = output_files_.begin();
-                it != output_files_.end();
-                ++it) {
-            if (std::remove(it->first.c_str()) != 0) {
-                RTI_RECORDER_UTILS_LOG_MESSAGE(
-                        rti::config::Verbosity::EXCEPTION,
-                        "error deleting output file=" + it->first+
-                        + " with error code=" + std::to_string(errno));
+    // separator of the packed elements
+    found = properties.find(CSV_PACKED_VALUE_SEPARATOR_PROPERTY_NAME());
+    if (found != properties.end()) {
+        if (found->second.empty()
+                || found->second.find(PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT())
+                        != std::string::npos) {
+            throw dds::core::Error(
+                    "Invalid value for property with name="
+                    + CSV_PACKED_VALUE_SEPARATOR_PROPERTY_NAME()
+                    + ": value must be non-empty and cannot contain the column "
+                    "separator");
+        }
+        csv_property_.packed_value_separator(found->second);
+    }
+
+    // encoding of the packed octets
+    found = properties.find(CSV_OCTET_ENCODING_PROPERTY_NAME());
+    if (found != properties.end()) {
+        bool is_supported = false;
+        for (auto kind : octet_encoding_kinds()) {
+            if (found->second == octet_encoding_name(kind)) {
+                csv_property_.octet_encoding(kind);
+                is_supported = true;
             }
         }
+        if (!is_supported) {
+            throw dds::core::UnsupportedError(
+                    "unsupported octet encoding=" + found->second);
+        }
     }
-}
 
-rti::recording::storage::StorageStreamWriter *
-UtilsStorageWriter::create_stream_writer(
-        const rti::routing::StreamInfo& stream_info,
-        const rti::routing::PropertySet&)
-{
-    std::string output_file_name =
-            property_.output_file_basename()
-            + "-"
-            + stream_info.stream_name();
-    // replace any invalid character
-    for (auto &reserved_char : reserved_filename_chars()) {
-        std::replace(
-                output_file_name.begin(),
-                output_file_name.end(),
-                reserved_char,
-                FILE_NAME_REPLACEMENT_CHAR());
+    // columns replaced by dictionary codes
+    found = properties.find(CSV_DICTIONARY_ENCODING_PROPERTY_NAME());
+    if (found != properties.end()) {
+        bool is_supported = false;
+        for (auto kind : dictionary_encoding_kinds()) {
+            if (found->second == dictionary_encoding_name(kind)) {
+                csv_property_.dictionary_encoding(kind);
+                is_supported = true;
+            }
+        }
+        if (!is_supported) {
+            throw dds::core::UnsupportedError(
+                    "unsupported dictionary encoding=" + found->second);
+        }
     }
-    std::string output_file_path =
+
+    // rows compared with the previous row of their instance
+    found = properties.find(CSV_DELTA_ROWS_PROPERTY_NAME());
+    if (found != properties.end()) {
+        bool is_supported = false;
+        for (auto kind : delta_row_kinds()) {
+            if (found->second == delta_rows_name(kind)) {
+                csv_property_.delta_rows(kind);
+                is_supported = true;
+            }
+        }
+        if (!is_supported) {
+            throw dds::core::UnsupportedError(
+                    "unsupported delta rows=" + found->second);
+        }
+    }
+
+    // samples between rows with all their cells
+    found = properties.find(CSV_KEYFRAME_INTERVAL_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + CSV_KEYFRAME_INTERVAL_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+        csv_property_.keyframe_interval(value);
+    }
+
+    // sample information written after the timestamp
+    found = properties.find(CSV_METADATA_COLUMNS_PROPERTY_NAME());
+    if (found != properties.end()) {
+        const std::string& names = found->second;
+        uint32_t columns = 0;
+        size_t begin = 0;
+        while (begin <= names.length()) {
+            size_t end = names.find(',', begin);
+            if (end == std::string::npos) {
+                end = names.length();
+            }
+            // surrounding spaces are ignored
+            size_t first = names.find_first_not_of(" \t", begin);
+            size_t last = names.find_last_not_of(" \t", end - 1);
+            if (first != std::string::npos && first < end && last >= first) {
+                std::string name = names.substr(first, last - first + 1);
+                bool is_supported = false;
+                for (auto kind : MetadataEmitter::column_kinds()) {
+                    if (name == MetadataEmitter::column_name(kind)) {
+                        columns |= static_cast<uint32_t>(kind);
+                        is_supported = true;
+                    }
+                }
+                if (!is_supported) {
+                    throw dds::core::UnsupportedError(
+                            "unsupported metadata column=" + name);
+                }
+            }
+            begin = end + 1;
+        }
+        csv_property_.metadata_columns(columns);
+    }
+
+    // Columnar-specific properties
+    // rows buffered per chunk
+    found = properties.find(COLUMNAR_ROWS_PER_CHUNK_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + COLUMNAR_ROWS_PER_CHUNK_PROPERTY_NAME()
+                    + ": value must be a positive integer");
+        }
+        if (value == 0) {
+            throw dds::core::Error(
+                    "Invalid value for property with name="
+                    + COLUMNAR_ROWS_PER_CHUNK_PROPERTY_NAME()
+                    + ": value must be a positive integer");
+        }
+        columnar_property_.rows_per_chunk(value);
+    }
+
+    // performance counters report
+    found = properties.find(STATS_OUTPUT_FILE_PROPERTY_NAME());
+    if (found != properties.end()) {
+        stats_property_.output_file_path(found->second);
+    }
+    found = properties.find(STATS_FORMAT_PROPERTY_NAME());
+    if (found != properties.end()) {
+        bool is_supported = false;
+        for (auto kind : stats_format_kinds()) {
+            if (found->second == stats_format_name(kind)) {
+                stats_property_.format(kind);
+                is_supported = true;
+            }
+        }
+        if (!is_supported) {
+            throw dds::core::UnsupportedError(
+                    "unsupported stats format=" + found->second);
+        }
+    }
+    found = properties.find(STATS_PERIOD_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + STATS_PERIOD_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+        stats_property_.period_ms(value);
+    }
+    if (!stats_property_.output_file_path().empty()) {
+        stats_reporter_.reset(new StatsReporter(stats_property_));
+    }
+
+    // memory budget
+    found = properties.find(MEMORY_BUDGET_LIMIT_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint64_t value = 0;
+        try {
+            value = static_cast<uint64_t>(std::stoull(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + MEMORY_BUDGET_LIMIT_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+        memory_budget_property_.limit_bytes(value);
+    }
+    found = properties.find(MEMORY_BUDGET_POLICY_PROPERTY_NAME());
+    if (found != properties.end()) {
+        bool is_valid = false;
+        for (auto kind : memory_budget_policy_kinds()) {
+            if (found->second == memory_budget_policy_name(kind)) {
+                memory_budget_property_.policy(kind);
+                is_valid = true;
+            }
+        }
+        if (!is_valid) {
+            throw dds::core::Error(
+                    "unsupported memory budget policy=" + found->second);
+        }
+    }
+    found = properties.find(MEMORY_BUDGET_BLOCK_TIMEOUT_PROPERTY_NAME());
+    if (found != properties.end()) {
+        uint32_t value = 0;
+        try {
+            value = static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + MEMORY_BUDGET_BLOCK_TIMEOUT_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+        memory_budget_property_.block_timeout_ms(value);
+    }
+    memory_budget_ = std::make_shared<MemoryBudget>(memory_budget_property_);
+    // the column plans are reported, but they can't be released
+    plan_memory_account_ = memory_budget_->add_account(false);
+    if (stats_reporter_) {
+        stats_reporter_->memory_budget(memory_budget_);
+    }
+
+    // trace events
+    found = properties.find(TRACE_EVENTS_PER_THREAD_PROPERTY_NAME());
+    if (found != properties.end()) {
+        try {
+            trace_events_per_thread_ =
+                    static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + TRACE_EVENTS_PER_THREAD_PROPERTY_NAME()
+                    + ": value must be a positive integer");
+        }
+        if (trace_events_per_thread_ == 0) {
+            throw dds::core::Error(
+                    "Invalid value for property with name="
+                    + TRACE_EVENTS_PER_THREAD_PROPERTY_NAME()
+                    + ": value must be a positive integer");
+        }
+    }
+    found = properties.find(TRACE_OUTPUT_FILE_PROPERTY_NAME());
+    if (found != properties.end()) {
+        trace_output_file_path_ = found->second;
+        Tracer::instance().enable(trace_events_per_thread_);
+    }
+
+    // column projections, one property per stream
+    for (auto& entry : properties) {
+        if (entry.first.compare(
+                0,
+                PROJECTION_PROPERTY_NAME_PREFIX().length(),
+                PROJECTION_PROPERTY_NAME_PREFIX()) != 0) {
+            continue;
+        }
+        try {
+            projections_[entry.first.substr(
+                    PROJECTION_PROPERTY_NAME_PREFIX().length())] =
+                    ColumnProjection(entry.second);
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + entry.first);
+        }
+    }
+
+    // row filters, one property per stream. They are compiled with the
+    // type of the stream.
+    for (auto& entry : properties) {
+        if (entry.first.compare(
+                0,
+                FILTER_PROPERTY_NAME_PREFIX().length(),
+                FILTER_PROPERTY_NAME_PREFIX()) == 0) {
+            filters_[entry.first.substr(FILTER_PROPERTY_NAME_PREFIX().length())] =
+                    entry.second;
+        }
+    }
+
+    // decimation, one property per stream
+    for (auto& entry : properties) {
+        if (entry.first.compare(
+                0,
+                DECIMATION_PROPERTY_NAME_PREFIX().length(),
+                DECIMATION_PROPERTY_NAME_PREFIX()) != 0) {
+            continue;
+        }
+        try {
+            decimations_[entry.first.substr(
+                    DECIMATION_PROPERTY_NAME_PREFIX().length())] =
+                    DecimatorProperty(entry.second);
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + entry.first);
+        }
+    }
+
+    // the column layout of the CSV format depends on its configuration,
+    // other formats use the default layout
+    layout_property_ =
+            property_.output_format_kind() == OutputFormatKind::CSV_FORMAT
+                    ? csv_property_
+                    : PrintFormatCsv::PROPERTY_DEFAULT();
+    layout_property_.unbounded_sequence_inline_length(
+            csv_property_.unbounded_sequence_inline_length());
+    found = properties.find(COLUMN_PLAN_BUILD_THREADS_PROPERTY_NAME());
+    if (found != properties.end()) {
+        try {
+            column_plan_thread_count_ =
+                    static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + COLUMN_PLAN_BUILD_THREADS_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+    }
+    column_plan_cache_.reset(new ColumnPlanCache(
+            layout_property_,
+            column_plan_thread_count_));
+
+    // checkpoints
+    found = properties.find(CHECKPOINT_PERIOD_PROPERTY_NAME());
+    if (found != properties.end()) {
+        try {
+            checkpoint_period_ms_ =
+                    static_cast<uint32_t>(std::stoul(found->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + CHECKPOINT_PERIOD_PROPERTY_NAME()
+                    + ": value must be a non-negative integer");
+        }
+    }
+    found = properties.find(CHECKPOINT_RESUME_PROPERTY_NAME());
+    if (found != properties.end()) {
+        std::istringstream bool_as_string(found->second);
+        try {
+            bool_as_string >> std::boolalpha >> checkpoint_resume_;
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + CHECKPOINT_RESUME_PROPERTY_NAME()
+                    + ": valid values are 'true' or 'false'");
+        }
+    }
+    if (checkpoint_period_ms_ > 0) {
+        // only files of complete rows without state can be continued
+        if (property_.output_format_kind() != OutputFormatKind::CSV_FORMAT
+                && property_.output_format_kind()
+                        != OutputFormatKind::JSON_LINES_FORMAT) {
+            throw dds::core::Error(
+                    "checkpoints are only supported for CSV and JSONL formats");
+        }
+        if (property_.output_format_kind() == OutputFormatKind::CSV_FORMAT
+                && csv_property_.dictionary_encoding()
+                        != DictionaryEncodingKind::NONE) {
+            throw dds::core::Error(
+                    "checkpoints are not supported with dictionary encoding");
+        }
+        if (!decimations_.empty()) {
+            throw dds::core::Error(
+                    "checkpoints are not supported with decimation");
+        }
+    } else if (checkpoint_resume_) {
+        throw dds::core::Error(
+                "Invalid value for property with name="
+                + CHECKPOINT_RESUME_PROPERTY_NAME()
+                + ": resume requires property with name="
+                + CHECKPOINT_PERIOD_PROPERTY_NAME());
+    }
+
+    /* Log summary of configuration */
+    if (Logger::instance().verbosity().underlying()
+            >= rti::config::Verbosity::STATUS_LOCAL) {
+        std::ostringstream summary;
+
+        summary << "Utils Storage plug-in configuration:" << "\n";
+        summary << property_;
+        summary << csv_property_;
+        if (property_.output_format_kind() == OutputFormatKind::COLUMNAR_FORMAT) {
+            summary << "\n" << columnar_property_;
+        }
+        if (stats_reporter_) {
+            summary << "\n" << stats_property_;
+        }
+        summary << "\n" << memory_budget_property_;
+        size_t namespace_length = PROPERTY_NAMESPACE().length() + 1;
+        summary << "\n\t"
+                << COLUMN_PLAN_BUILD_THREADS_PROPERTY_NAME().substr(namespace_length)
+                << "="
+                << column_plan_thread_count_;
+        if (checkpoint_period_ms_ > 0) {
+            summary << "\n\t"
+                    << CHECKPOINT_PERIOD_PROPERTY_NAME().substr(namespace_length)
+                    << "="
+                    << checkpoint_period_ms_
+                    << "\n\t"
+                    << CHECKPOINT_RESUME_PROPERTY_NAME().substr(namespace_length)
+                    << "="
+                    << std::boolalpha << checkpoint_resume_;
+        }
+        for (auto& entry : projections_) {
+            summary << "\n\t"
+                    << PROJECTION_PROPERTY_NAME_PREFIX().substr(namespace_length)
+                    << entry.first
+                    << "="
+                    << entry.second.patterns();
+        }
+        for (auto& entry : filters_) {
+            summary << "\n\t"
+                    << FILTER_PROPERTY_NAME_PREFIX().substr(namespace_length)
+                    << entry.first
+                    << "="
+                    << entry.second;
+        }
+        for (auto& entry : decimations_) {
+            summary << "\n\t"
+                    << DECIMATION_PROPERTY_NAME_PREFIX().substr(namespace_length)
+                    << entry.first
+                    << "="
+                    << entry.second.value();
+        }
+        if (!trace_output_file_path_.empty()) {
+            summary << "\n\t"
+                    << TRACE_OUTPUT_FILE_PROPERTY_NAME().substr(namespace_length)
+                    << "="
+                    << trace_output_file_path_
+                    << "\n\t"
+                    << TRACE_EVENTS_PER_THREAD_PROPERTY_NAME().substr(namespace_length)
+                    << "="
+                    << trace_events_per_thread_;
+        }
+
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                    rti::config::Verbosity::STATUS_LOCAL,
+                    summary.str().c_str());
+    }
+}
+
+UtilsStorageWriter::~UtilsStorageWriter()
+{
+    if (stats_reporter_) {
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                rti::config::Verbosity::STATUS_LOCAL,
+                "UtilsStorageWriter: stream counters="
+                        + stats_reporter_->summary());
+        // writes the final dump
+        stats_reporter_.reset();
+    }
+    if (!trace_output_file_path_.empty()) {
+        Tracer::instance().disable();
+        try {
+            Tracer::instance().write(trace_output_file_path_);
+        } catch (const std::exception& ex) {
+            RTI_RECORDER_UTILS_LOG_MESSAGE(
+                    rti::config::Verbosity::EXCEPTION,
+                    ex.what());
+        }
+    }
+    if (property_.merge_output_files()) {
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                rti::config::Verbosity::STATUS_LOCAL,
+                "UtilsStorageWriter: delete output files after merge");
+        for (auto it = output_files_.begin();
+                it != output_files_.end();
+                ++it) {
+            if (std::remove(it->first.c_str()) != 0) {
+                RTI_RECORDER_UTILS_LOG_MESSAGE(
+                        rti::config::Verbosity::EXCEPTION,
+                        "error deleting output file=" + it->first+
+                        + " with error code=" + std::to_string(errno));
+            }
+            if (checkpoint_period_ms_ > 0) {
+                CheckpointFile(
+                        it->first + CheckpointFile::FILE_EXTENSION()).remove();
+            }
+        }
+    }
+}
+
+rti::recording::storage::StorageStreamWriter *
+UtilsStorageWriter::create_stream_writer(
+        const rti::routing::StreamInfo& stream_info,
+        const rti::routing::PropertySet&)
+{
+    uint32_t trace_detail = Tracer::instance().is_enabled()
+            ? Tracer::instance().detail_id(stream_info.stream_name())
+            : Tracer::NO_DETAIL();
+    TraceScope trace_scope("create_stream_writer", trace_detail);
+
+    std::string output_file_name =
+            property_.output_file_basename()
+            + "-"
+            + stream_info.stream_name();
+    // replace any invalid character
+    for (auto &reserved_char : reserved_filename_chars()) {
+        std::replace(
+                output_file_name.begin(),
+                output_file_name.end(),
+                reserved_char,
+                FILE_NAME_REPLACEMENT_CHAR());
+    }
+    std::string output_file_path =
             property_.output_dir_path()
             + RTI_RECORDER_UTILS_PATH_SEPARATOR
             + output_file_name
-            + CSV_FILE_EXTENSION();
+            + file_extension();
+    // an invalid filter is reported when the stream is created. An invalid
+    // projection is reported when the column plan is built.
+    std::unique_ptr<RowFilter> row_filter;
+    auto found_filter = filters_.find(stream_info.stream_name());
+    if (found_filter != filters_.end()) {
+        try {
+            row_filter.reset(new RowFilter(
+                    dynamic_type(stream_info),
+                    found_filter->second));
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Invalid value for property with name="
+                    + FILTER_PROPERTY_NAME_PREFIX()
+                    + found_filter->first);
+        }
+    }
+
+    // the output files are created with the first sample, the column plan
+    // may be built before in the background
+    if (property_.output_format_kind() != OutputFormatKind::CDR_FORMAT) {
+        prefetch_column_plan(stream_info);
+    }
+    rti::routing::StreamInfo lazy_stream_info(stream_info);
+    LazyStreamWriter *stream_writer = new LazyStreamWriter(
+            stream_info.stream_name(),
+            [this, lazy_stream_info, output_file_path, trace_detail]() {
+                return materialize_stream_writer(
+                        lazy_stream_info,
+                        output_file_path,
+                        trace_detail);
+            });
+    stream_writer->row_filter(std::move(row_filter));
+    if (stats_reporter_) {
+        stream_writer->counters(
+                stats_reporter_->add_stream(stream_info.stream_name()));
+    }
+    stream_writer->trace_detail(trace_detail);
+    stream_writer->memory_account(memory_budget_->add_account());
+
+    return stream_writer;
+}
+
+UtilsStreamWriter * UtilsStorageWriter::materialize_stream_writer(
+        const rti::routing::StreamInfo& stream_info,
+        const std::string& output_file_path,
+        uint32_t trace_detail)
+{
+    // an invalid projection is reported before creating the output file
+    ColumnPlanCache::ColumnPlanPtr column_plan;
+    if (property_.output_format_kind() != OutputFormatKind::CDR_FORMAT) {
+        TraceScope column_plan_scope("column_plan", trace_detail);
+        column_plan = this->column_plan(stream_info);
+    }
+
+    // the checkpoint of a previous conversion, if it's resumed
+    std::unique_ptr<CheckpointFile> checkpoint_file;
+    StreamCheckpoint resumed;
+    bool is_resumed = false;
+    if (checkpoint_period_ms_ > 0) {
+        checkpoint_file.reset(new CheckpointFile(
+                output_file_path + CheckpointFile::FILE_EXTENSION()));
+        try {
+            if (checkpoint_resume_) {
+                is_resumed = checkpoint_file->read(resumed);
+            } else {
+                checkpoint_file->remove();
+            }
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Failed to resume stream with name="
+                    + stream_info.stream_name());
+        }
+        if (is_resumed && resumed.file_sizes.empty()) {
+            throw dds::core::Error(
+                    "No file sizes in checkpoint file="
+                    + checkpoint_file->path());
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(output_files_mutex_);
+    if (column_plan) {
+        plan_memory_account_->update(column_plan_cache_->memory_size());
+    }
+    std::ios::openmode open_mode =
+            property_.output_format_kind() == OutputFormatKind::COLUMNAR_FORMAT
+                    || property_.output_format_kind() == OutputFormatKind::CDR_FORMAT
+                    ? std::ios::binary
+                    : std::ios::openmode();
     std::ofstream output_file;
-    output_file.open(output_file_path.c_str(), std::ios::out);
+    if (is_resumed) {
+        try {
+            resume_file(
+                    output_file,
+                    output_file_path,
+                    resumed.file_sizes[0],
+                    open_mode);
+        } catch (const std::exception& ex) {
+            throw dds::core::Error(
+                    std::string(ex.what())
+                    + ". Failed to resume stream with name="
+                    + stream_info.stream_name());
+        }
+    } else {
+        output_file.open(output_file_path.c_str(), std::ios::out | open_mode);
+    }
     if (!output_file.good()) {
         throw dds::core::Error(
                 "Failed to open file="
@@ -465,175 +1657,1366 @@ UtilsStorageWriter::create_stream_writer(
                 + " to store data samples for stream with name="
                 + stream_info.stream_name());
     }
-    // Write table header
-    output_file << "Topic name: " << stream_info.stream_name() << std::endl;
-    // add to collection
-    output_files_.insert(std::make_pair(
-            output_file_path,
-            std::move(output_file)));
+    if (property_.output_format_kind() == OutputFormatKind::CSV_FORMAT
+            && !is_resumed) {
+        // Write table header
+        output_file << "Topic name: " << stream_info.stream_name() << std::endl;
+    }
+    // add to collection
+    output_files_.insert(std::make_pair(
+            output_file_path,
+            std::move(output_file)));
+    FileSetEntry& output_file_entry = *(output_files_.find(output_file_path));
+    lock.unlock();
+
+    RTI_RECORDER_UTILS_LOG_MESSAGE(
+            rti::config::Verbosity::STATUS_LOCAL,
+            ((is_resumed
+                    ? "UtilsStorageWriter: resume StreamWriter for file="
+                    : "UtilsStorageWriter: create StreamWriter for file=")
+                    + output_file_path).c_str());
+
+    std::unique_ptr<UtilsStreamWriter> stream_writer;
+    switch(property_.output_format_kind()) {
+
+    case OutputFormatKind::CSV_FORMAT:
+    {
+        auto found_decimation = decimations_.find(stream_info.stream_name());
+        stream_writer.reset(new CsvStreamWriter(
+                csv_property_,
+                stream_info,
+                column_plan,
+                found_decimation != decimations_.end()
+                        ? found_decimation->second
+                        : DecimatorProperty(),
+                output_file_entry,
+                is_resumed ? &resumed : nullptr));
+    }
+        break;
+
+    case OutputFormatKind::COLUMNAR_FORMAT:
+        stream_writer.reset(new ColumnarStreamWriter(
+                columnar_property_,
+                stream_info,
+                column_plan,
+                output_file_entry));
+        break;
+
+    case OutputFormatKind::JSON_LINES_FORMAT:
+        stream_writer.reset(new JsonLinesStreamWriter(
+                stream_info,
+                column_plan,
+                output_file_entry));
+        break;
+
+    case OutputFormatKind::CDR_FORMAT:
+        stream_writer.reset(new CdrStreamWriter(
+                stream_info,
+                output_file_entry));
+        break;
+
+    case OutputFormatKind::STATISTICS_FORMAT:
+        stream_writer.reset(new StatisticsStreamWriter(
+                stream_info,
+                column_plan,
+                output_file_entry));
+        break;
+
+    default:
+        throw dds::core::UnsupportedError("unsupported output format kind");
+    };
+
+    if (checkpoint_file) {
+        stream_writer->checkpointing(
+                std::move(checkpoint_file),
+                checkpoint_period_ms_,
+                is_resumed ? &resumed : nullptr);
+    }
+
+    return stream_writer.release();
+}
+
+ColumnPlanCache::ColumnPlanPtr UtilsStorageWriter::column_plan(
+        const rti::routing::StreamInfo& stream_info)
+{
+    auto found = projections_.find(stream_info.stream_name());
+    if (found == projections_.end()) {
+        return column_plan_cache_->plan(dynamic_type(stream_info));
+    }
+
+    return column_plan_cache_->plan(dynamic_type(stream_info), found->second);
+}
+
+void UtilsStorageWriter::prefetch_column_plan(
+        const rti::routing::StreamInfo& stream_info)
+{
+    auto found = projections_.find(stream_info.stream_name());
+    if (found == projections_.end()) {
+        column_plan_cache_->prefetch(dynamic_type(stream_info));
+        return;
+    }
+
+    column_plan_cache_->prefetch(dynamic_type(stream_info), found->second);
+}
+
+void UtilsStorageWriter::delete_stream_writer(
+        rti::recording::storage::StorageStreamWriter *writer)
+{
+    LazyStreamWriter *lazy_writer = static_cast<LazyStreamWriter*> (writer);
+    TraceScope trace_scope(
+            "delete_stream_writer",
+            lazy_writer->trace_detail());
+    if (!lazy_writer->is_materialized() && property_.write_empty_streams()) {
+        try {
+            lazy_writer->materialize();
+        } catch (const std::exception& ex) {
+            RTI_RECORDER_UTILS_LOG_MESSAGE(
+                    rti::config::Verbosity::EXCEPTION,
+                    ex.what());
+        }
+    }
+    if (!lazy_writer->is_materialized()) {
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                rti::config::Verbosity::STATUS_LOCAL,
+                ("UtilsStorageWriter: delete StreamWriter without samples for stream="
+                        + lazy_writer->stream_name()).c_str());
+        delete writer;
+        return;
+    }
+
+    UtilsStreamWriter *stream_writer = &lazy_writer->stream_writer();
+    RTI_RECORDER_UTILS_LOG_MESSAGE(
+            rti::config::Verbosity::STATUS_LOCAL,
+            ("UtilsStorageWriter: delete StreamWriter for file="
+                    + stream_writer->file_entry().first).c_str());
+    // the buffers are no longer reclaimed by other streams
+    stream_writer->memory_account(nullptr);
+    try {
+        stream_writer->finalize();
+        // with the final checkpoint, a resumed conversion skips the stream
+        stream_writer->checkpoint();
+        if (property_.merge_output_files()) {
+             RTI_RECORDER_UTILS_LOG_MESSAGE(
+                    rti::config::Verbosity::STATUS_LOCAL,
+                    ("UtilsStorageWriter: merge file="
+                            + stream_writer->file_entry().first).c_str());
+            merge_output_file(stream_writer->file_entry());
+        }
+        stream_writer->file_entry().second.close();
+    } catch (const std::exception& ex) {
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                rti::config::Verbosity::EXCEPTION,
+                ex.what());
+    } catch (...) {
+        std::string message =
+                "unexpected exception occurred while merging file with name="
+                + stream_writer->file_entry().first;
+        RTI_RECORDER_UTILS_LOG_MESSAGE(
+                rti::config::Verbosity::EXCEPTION,
+                message);
+    }
+
+    delete writer;
+}
+
+const std::string& UtilsStorageWriter::file_extension() const
+{
+    switch (property_.output_format_kind()) {
+    case OutputFormatKind::COLUMNAR_FORMAT:
+        return COLUMNAR_FILE_EXTENSION();
+
+    case OutputFormatKind::JSON_LINES_FORMAT:
+        return JSON_LINES_FILE_EXTENSION();
+
+    case OutputFormatKind::CDR_FORMAT:
+        return CDR_FILE_EXTENSION();
+
+    case OutputFormatKind::STATISTICS_FORMAT:
+        return STATISTICS_FILE_EXTENSION();
+
+    default:
+        return CSV_FILE_EXTENSION();
+    }
+}
+
+void UtilsStorageWriter::merge_output_file(
+        FileSetEntry& file_entry)
+{
+    TraceScope trace_scope("merge_output_file");
+    std::ifstream input_file(file_entry.first);
+    std::string line;
+    while (std::getline(input_file, line)) {
+        output_merged_file_ << line << std::endl;
+    }
+}
+
+
+/*
+ * --- LazyStreamWriter -------------------------------------------------------
+ */
+
+LazyStreamWriter::LazyStreamWriter(
+            const std::string& stream_name,
+            Factory factory) :
+    stream_name_(stream_name),
+    factory_(std::move(factory)),
+    trace_detail_(Tracer::NO_DETAIL())
+{
+}
+
+LazyStreamWriter::~LazyStreamWriter()
+{
+    if (stream_writer_) {
+        // no reclaim may run on a writer being destroyed
+        stream_writer_->memory_account(nullptr);
+    }
+}
+
+void LazyStreamWriter::store(
+        const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+        const std::vector<dds::sub::SampleInfo *>& info_seq)
+{
+    UtilsStreamWriter& stream_writer = materialize();
+    std::lock_guard<std::mutex> guard(stream_writer.buffer_mutex());
+    stream_writer.store(sample_seq, info_seq);
+}
+
+UtilsStreamWriter& LazyStreamWriter::materialize()
+{
+    if (!stream_writer_) {
+        TraceScope trace_scope("materialize_stream_writer", trace_detail_);
+        // the configuration is kept if the creation fails
+        std::unique_ptr<UtilsStreamWriter> stream_writer(factory_());
+        stream_writer->row_filter(std::move(row_filter_));
+        if (counters_) {
+            stream_writer->counters(counters_);
+        }
+        stream_writer->trace_detail(trace_detail_);
+        stream_writer->memory_account(std::move(memory_account_));
+        stream_writer_ = std::move(stream_writer);
+    }
+
+    return *stream_writer_;
+}
+
+bool LazyStreamWriter::is_materialized() const
+{
+    return stream_writer_ != nullptr;
+}
+
+UtilsStreamWriter& LazyStreamWriter::stream_writer()
+{
+    return *stream_writer_;
+}
+
+const std::string& LazyStreamWriter::stream_name() const
+{
+    return stream_name_;
+}
+
+void LazyStreamWriter::row_filter(std::unique_ptr<RowFilter> filter)
+{
+    row_filter_ = std::move(filter);
+}
+
+void LazyStreamWriter::counters(std::shared_ptr<StreamCounters> counters)
+{
+    counters_ = std::move(counters);
+}
+
+void LazyStreamWriter::trace_detail(uint32_t detail)
+{
+    trace_detail_ = detail;
+}
+
+uint32_t LazyStreamWriter::trace_detail() const
+{
+    return trace_detail_;
+}
+
+void LazyStreamWriter::memory_account(
+        std::unique_ptr<MemoryBudget::Account> account)
+{
+    memory_account_ = std::move(account);
+}
+
+
+/*
+ * --- UtilsStreamWriter ------------------------------------------------------
+ */
+
+UtilsStreamWriter::UtilsStreamWriter() :
+    counters_(std::make_shared<StreamCounters>()),
+    trace_detail_(Tracer::NO_DETAIL()),
+    checkpoint_period_ns_(0),
+    last_checkpoint_ns_(0),
+    is_resuming_(false)
+{
+}
+
+void UtilsStreamWriter::row_filter(std::unique_ptr<RowFilter> filter)
+{
+    row_filter_ = std::move(filter);
+}
+
+void UtilsStreamWriter::counters(std::shared_ptr<StreamCounters> counters)
+{
+    counters_ = std::move(counters);
+}
+
+StreamCounters& UtilsStreamWriter::counters()
+{
+    return *counters_;
+}
+
+void UtilsStreamWriter::trace_detail(uint32_t detail)
+{
+    trace_detail_ = detail;
+}
+
+uint32_t UtilsStreamWriter::trace_detail() const
+{
+    return trace_detail_;
+}
+
+void UtilsStreamWriter::memory_account(
+        std::unique_ptr<MemoryBudget::Account> account)
+{
+    // the previous account is deregistered before it's replaced
+    memory_account_.reset();
+    memory_account_ = std::move(account);
+    if (!memory_account_) {
+        return;
+    }
+
+    memory_account_->reclaimer([this](MemoryBudget::Account& account) {
+        std::unique_lock<std::mutex> lock(buffer_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            // the stream is being stored
+            return false;
+        }
+        TraceScope trace_scope("memory_budget_reclaim", trace_detail_);
+        release_buffers(account.budget().property().policy());
+        uint64_t size = buffer_size();
+        counters_->buffer_bytes(size);
+        account.update(size);
+        return true;
+    });
+}
+
+std::mutex& UtilsStreamWriter::buffer_mutex()
+{
+    return buffer_mutex_;
+}
+
+void UtilsStreamWriter::release_buffers(MemoryBudgetPolicyKind policy)
+{
+    switch (policy) {
+    case MemoryBudgetPolicyKind::FLUSH:
+        flush_buffers();
+        shrink_buffers();
+        break;
+
+    case MemoryBudgetPolicyKind::SHRINK:
+    case MemoryBudgetPolicyKind::BLOCK:
+        shrink_buffers();
+        break;
+    }
+}
+
+void UtilsStreamWriter::check_memory_budget()
+{
+    if (!memory_account_) {
+        return;
+    }
+
+    uint64_t size = buffer_size();
+    counters_->buffer_bytes(size);
+    if (memory_account_->update(size)) {
+        return;
+    }
+
+    // the idle streams are reclaimed first, so the stream being stored
+    // keeps its buffers
+    MemoryBudget& budget = memory_account_->budget();
+    if (budget.reclaim(*memory_account_)) {
+        return;
+    }
+
+    release_buffers(budget.property().policy());
+    size = buffer_size();
+    counters_->buffer_bytes(size);
+    if (!memory_account_->update(size)
+            && budget.property().policy() == MemoryBudgetPolicyKind::BLOCK) {
+        // only another thread storing a stream can release memory
+        TraceScope trace_scope("memory_budget_wait", trace_detail_);
+        budget.wait_available();
+    }
+}
+
+void UtilsStreamWriter::checkpointing(
+        std::unique_ptr<CheckpointFile> file,
+        uint32_t period_ms,
+        const StreamCheckpoint *resumed)
+{
+    checkpoint_file_ = std::move(file);
+    checkpoint_period_ns_ = static_cast<uint64_t>(period_ms) * 1000000;
+    last_checkpoint_ns_ = StreamCounters::now();
+    progress_ = StreamCheckpoint();
+    is_resuming_ = resumed != nullptr;
+    if (resumed != nullptr) {
+        resumed_ = *resumed;
+    }
+}
+
+void UtilsStreamWriter::checkpoint()
+{
+    if (!checkpoint_file_) {
+        return;
+    }
+
+    TraceScope trace_scope("checkpoint", trace_detail_);
+    // the output files are durable before the checkpoint that covers them
+    StreamCheckpoint checkpoint = progress_;
+    checkpoint_paths_.clear();
+    try {
+        checkpoint_files(checkpoint, checkpoint_paths_);
+        for (auto& path : checkpoint_paths_) {
+            sync_file(path);
+        }
+        checkpoint_file_->write(checkpoint);
+    } catch (const std::exception& ex) {
+        throw dds::core::Error(
+                std::string(ex.what())
+                + ". Failed to write checkpoint file="
+                + checkpoint_file_->path());
+    }
+    last_checkpoint_ns_ = StreamCounters::now();
+}
+
+void UtilsStreamWriter::checkpoint_files(
+        StreamCheckpoint&,
+        std::vector<std::string>&)
+{
+    throw dds::core::UnsupportedError(
+            "checkpoints are not supported by the output format");
+}
+
+void UtilsStreamWriter::check_checkpoint()
+{
+    if (checkpoint_file_
+            && StreamCounters::now() - last_checkpoint_ns_
+                    >= checkpoint_period_ns_) {
+        checkpoint();
+    }
+}
+
+bool UtilsStreamWriter::is_resumed_sample(const dds::sub::SampleInfo& info)
+{
+    int64_t timestamp =
+            (int64_t) info->reception_timestamp().sec() * NANOSECS_PER_SEC;
+    timestamp += info->reception_timestamp().nanosec();
+    if (timestamp == progress_.timestamp) {
+        ++progress_.timestamp_sample_count;
+    } else {
+        progress_.timestamp = timestamp;
+        progress_.timestamp_sample_count = 1;
+    }
+    if (!is_resuming_) {
+        return false;
+    }
+
+    if (progress_.timestamp < resumed_.timestamp
+            || (progress_.timestamp == resumed_.timestamp
+                    && progress_.timestamp_sample_count
+                            <= resumed_.timestamp_sample_count)) {
+        return true;
+    }
+    // the rest of the samples are new
+    is_resuming_ = false;
+
+    return false;
+}
+
+bool UtilsStreamWriter::is_stored(
+        dds::core::xtypes::DynamicData& sample,
+        const dds::sub::SampleInfo& info)
+{
+    counters_->add_sample();
+    if (checkpoint_file_ && is_resumed_sample(info)) {
+        return false;
+    }
+    if (!info->valid()) {
+        counters_->add_invalid_sample();
+        return false;
+    }
+
+    return !row_filter_ || row_filter_->evaluate(sample, info);
+}
+
+
+/*
+ * --- CsvStreamWriter --------------------------------------------------------
+ */
+
+CsvStreamWriter::CsvStreamWriter(
+            const PrintFormatCsvProperty& property,
+            const rti::routing::StreamInfo& stream_info,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            const DecimatorProperty& decimation,
+            UtilsStorageWriter::FileSetEntry& output_file_entry,
+            const StreamCheckpoint *resumed) :
+    output_file_entry_(output_file_entry),
+    print_format_csv_(
+            property,
+            column_plan,
+            output_file_entry.second,
+            resumed == nullptr),
+    row_id_(resumed != nullptr ? resumed->row_id : 0),
+    batch_write_ns_(0),
+    batch_row_count_(0)
+{
+    if (decimation.kind() != DecimationKind::NONE) {
+        decimator_.reset(new Decimator(decimation, dynamic_type(stream_info)));
+    }
+    if (property.delta_rows() != DeltaRowKind::NONE) {
+        delta_row_encoder_.reset(new DeltaRowEncoder(property, *column_plan));
+    }
+    if (property.metadata_columns() != 0) {
+        metadata_emitter_ =
+                MetadataEmitter::create(property.metadata_columns());
+    }
+
+    // exploded tables are placed next to the output file
+    const std::string& output_file_path = output_file_entry_.first;
+    std::string path_prefix = output_file_path.substr(
+            0,
+            output_file_path.length()
+                    - UtilsStorageWriter::CSV_FILE_EXTENSION().length());
+    // the checkpoint has the size of the output file and of each table
+    if (resumed != nullptr
+            && resumed->file_sizes.size()
+                    != print_format_csv_.exploded_tables().size() + 1) {
+        throw dds::core::Error(
+                "The checkpoint of file=" + output_file_path
+                + " doesn't match the exploded tables of stream with name="
+                + stream_info.stream_name());
+    }
+    size_t table_index = 1;
+    for (auto& table : print_format_csv_.exploded_tables()) {
+        std::string table_file_path =
+                path_prefix
+                + table.name()
+                + UtilsStorageWriter::CSV_FILE_EXTENSION();
+        exploded_files_.emplace_back();
+        exploded_file_paths_.push_back(table_file_path);
+        std::ofstream& table_file = exploded_files_.back();
+        if (resumed != nullptr) {
+            try {
+                resume_file(
+                        table_file,
+                        table_file_path,
+                        resumed->file_sizes[table_index++]);
+            } catch (const std::exception& ex) {
+                throw dds::core::Error(
+                        std::string(ex.what())
+                        + ". Failed to resume the elements of sequence with name="
+                        + table.name());
+            }
+            continue;
+        }
+        table_file.open(table_file_path.c_str());
+        if (!table_file.good()) {
+            throw dds::core::Error(
+                    "Failed to open file="
+                    + table_file_path
+                    + " to store the elements of sequence with name="
+                    + table.name());
+        }
+        table_file << table.header() << std::endl;
+    }
+
+    if (print_format_csv_.has_dictionary_columns()) {
+        std::string dictionary_file_path =
+                path_prefix
+                + UtilsStorageWriter::CSV_DICTIONARY_FILE_SUFFIX()
+                + UtilsStorageWriter::CSV_FILE_EXTENSION();
+        dictionary_file_.open(dictionary_file_path.c_str());
+        if (!dictionary_file_.good()) {
+            throw dds::core::Error(
+                    "Failed to open file="
+                    + dictionary_file_path
+                    + " to store the dictionary of stream with name="
+                    + stream_info.stream_name());
+        }
+        dictionary_file_ << "column,code,value" << std::endl;
+    }
+}
+
+CsvStreamWriter::~CsvStreamWriter()
+{
+
+}
+
+/*
+ * This function is called by Recorder whenever there are samples available for
+ * one of the streams previously discovered and accepted (see the
+ * FileStorageWriter_create_stream_writer() function below). Recorder provides
+ * the samples and their associated information objects in Routing Service
+ * format, this is, untyped format.
+ * In our case we know that, except for the built-in DDS discovery topics which
+ * are received in their own format - and that we're not really storing -, that
+ * the format of the data we're receiving is DDS Dynamic Data. This will always
+ * be the format received for types recorded from DDS.
+ * The function traverses the collection of samples and stores the data in a
+ * textual format.
+ */
+void CsvStreamWriter::store(
+        const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+        const std::vector<dds::sub::SampleInfo *>& info_seq)
+{
+    using namespace dds::core::xtypes;
+    using namespace rti::core::xtypes;
+    using namespace dds::sub;
+
+    StreamCounters::StoreScope store_scope(counters());
+    TraceScope trace_scope("store", trace_detail());
+    const int32_t count = sample_seq.size();
+    for (int32_t i = 0; i < count; ++i) {
+        const SampleInfo& sample_info = *(info_seq[i]);
+        // we first first print the sample's metadata
+        int64_t timestamp =
+                (int64_t) sample_info->reception_timestamp().sec()
+                * NANOSECS_PER_SEC;
+        timestamp += sample_info->reception_timestamp().nanosec();
+
+        // print sample data
+        if (is_stored(*sample_seq[i], sample_info)) {
+            if (decimator_) {
+                decimator_->add(
+                        *sample_seq[i],
+                        sample_info,
+                        timestamp,
+                        [this](
+                                DynamicData& row,
+                                const SampleInfo& row_info,
+                                int64_t row_timestamp) {
+                            write_row(row, row_info, row_timestamp);
+                        });
+            } else {
+                write_row(*sample_seq[i], sample_info, timestamp);
+            }
+        }
+    }
+    end_batch();
+    check_memory_budget();
+    check_checkpoint();
+}
+
+void CsvStreamWriter::write_row(
+        dds::core::xtypes::DynamicData& sample,
+        const dds::sub::SampleInfo& info,
+        int64_t timestamp)
+{
+    uint64_t format_begin = StreamCounters::now();
+    DDS_UnsignedLong data_as_csv_size = 0;
+    print_format_csv_.row_id(row_id_);
+    print_format_csv_.sample(sample);
+
+    // compute required size
+    DDS_ReturnCode_t native_retcode = DDS_DynamicDataFormatter_to_string_w_format(
+            &sample.native(),
+            NULL,
+            &data_as_csv_size,
+            print_format_csv_.native());
+    rti::core::check_return_code(
+            native_retcode,
+            "failed to compute CSV data required length");
+    if (data_as_csv_size > data_as_csv_.capacity()) {
+        counters().add_buffer_growth();
+    }
+    data_as_csv_.resize(data_as_csv_size);
+    native_retcode = DDS_DynamicDataFormatter_to_string_w_format(
+            &sample.native(),
+            &data_as_csv_[0],
+            &data_as_csv_size,
+            print_format_csv_.native());
+    rti::core::check_return_code(
+            native_retcode,
+            "failed convert to DynamicData to CSV");
+
+    /**
+     * Eliminating the trailing '\0' character needed by the C APIs. 
+     * Note that C++ internally keeps the null terminating character and 
+     * as such doesn't count it in the size() call.
+     *
+     * The computed size is an upper bound: the elements of exploded
+     * sequences and packed octets are rewritten in the output. The
+     * length is hence given by the terminating character.
+     */
+    data_as_csv_.resize(std::strlen(data_as_csv_.c_str()));
+    counters().row_size(data_as_csv_.size());
+
+    bool is_keyframe = true;
+    if (delta_row_encoder_
+            && !delta_row_encoder_->encode(
+                    data_as_csv_,
+                    print_format_csv_.exploded_tables(),
+                    is_keyframe)) {
+        // the row id is reused by the next row
+        for (auto& table : print_format_csv_.exploded_tables()) {
+            table.rows().clear();
+        }
+        counters().add_format_time(StreamCounters::now() - format_begin);
+        return;
+    }
+
+    // metadata columns: timestamp first
+    row_prefix_.clear();
+    append_integer(row_prefix_, timestamp);
+    if (metadata_emitter_) {
+        metadata_emitter_->emit(info, row_prefix_);
+    }
+    if (!exploded_files_.empty()) {
+        row_prefix_ += PrintFormatCsv::COLUMN_SEPARATOR_DEFAULT();
+        append_unsigned(row_prefix_, row_id_);
+    }
+    if (print_format_csv_.property().delta_rows()
+            == DeltaRowKind::CHANGED_CELLS) {
+        row_prefix_ += is_keyframe ? ",1" : ",0";
+    }
+    uint64_t write_begin = StreamCounters::now();
+    counters().add_format_time(write_begin - format_begin);
+
+    // new codes are available before the rows that use them
+    std::string& dictionary_entries =
+            print_format_csv_.dictionary_entries();
+    if (!dictionary_entries.empty()) {
+        dictionary_file_ << dictionary_entries;
+        dictionary_file_.flush();
+        counters().add_bytes(dictionary_entries.size());
+        counters().add_flush();
+        dictionary_entries.clear();
+    }
+
+    output_file_entry_.second.write(row_prefix_.c_str(), row_prefix_.size());
+    // add formatted sample content to file
+    output_file_entry_.second.write(
+            data_as_csv_.c_str(),
+            data_as_csv_.size());
+    // end of row, the files are flushed at the end of the batch
+    output_file_entry_.second.put('\n');
+    counters().add_bytes(row_prefix_.size() + data_as_csv_.size() + 1);
+
+    // add the elements of the exploded sequences to their tables
+    auto table_file = exploded_files_.begin();
+    for (auto& table : print_format_csv_.exploded_tables()) {
+        *table_file << table.rows();
+        counters().add_bytes(table.rows().size());
+        table.rows().clear();
+        ++table_file;
+    }
+    ++row_id_;
+    batch_write_ns_ += StreamCounters::now() - write_begin;
+    ++batch_row_count_;
+}
+
+void CsvStreamWriter::end_batch()
+{
+    if (batch_row_count_ > 0) {
+        uint64_t flush_begin = StreamCounters::now();
+        flush_buffers();
+        counters().add_write_time(
+                batch_write_ns_ + StreamCounters::now() - flush_begin);
+    }
+    batch_write_ns_ = 0;
+    batch_row_count_ = 0;
+}
+
+UtilsStorageWriter::FileSetEntry& CsvStreamWriter::file_entry()
+{
+    return output_file_entry_;
+}
+
+void CsvStreamWriter::finalize()
+{
+    TraceScope trace_scope("finalize", trace_detail());
+    if (decimator_) {
+        decimator_->flush([this](
+                dds::core::xtypes::DynamicData& row,
+                const dds::sub::SampleInfo& row_info,
+                int64_t row_timestamp) {
+            write_row(row, row_info, row_timestamp);
+        });
+        end_batch();
+    }
+    // the headers of a stream without rows
+    flush_buffers();
+    if (dictionary_file_.is_open()) {
+        dictionary_file_.flush();
+        counters().add_flush();
+    }
+}
+
+uint64_t CsvStreamWriter::buffer_size()
+{
+    uint64_t size = data_as_csv_.capacity() + row_prefix_.capacity();
+    for (auto& table : print_format_csv_.exploded_tables()) {
+        size += table.rows().capacity();
+    }
+
+    return size;
+}
+
+void CsvStreamWriter::flush_buffers()
+{
+    output_file_entry_.second.flush();
+    counters().add_flush();
+    for (auto& table_file : exploded_files_) {
+        table_file.flush();
+        counters().add_flush();
+    }
+}
+
+void CsvStreamWriter::checkpoint_files(
+        StreamCheckpoint& checkpoint,
+        std::vector<std::string>& paths)
+{
+    output_file_entry_.second.flush();
+    counters().add_flush();
+    checkpoint.file_sizes.push_back(
+            static_cast<uint64_t>(output_file_entry_.second.tellp()));
+    paths.push_back(output_file_entry_.first);
+    auto table_file_path = exploded_file_paths_.begin();
+    for (auto& table_file : exploded_files_) {
+        table_file.flush();
+        counters().add_flush();
+        checkpoint.file_sizes.push_back(
+                static_cast<uint64_t>(table_file.tellp()));
+        paths.push_back(*table_file_path);
+        ++table_file_path;
+    }
+    checkpoint.row_id = row_id_;
+}
+
+void CsvStreamWriter::shrink_buffers()
+{
+    // the buffers are empty between calls to store()
+    std::string().swap(data_as_csv_);
+    std::string().swap(row_prefix_);
+    for (auto& table : print_format_csv_.exploded_tables()) {
+        std::string().swap(table.rows());
+    }
+}
+
+
+/*
+ * --- ColumnarStreamWriter ---------------------------------------------------
+ */
+
+ColumnarStreamWriter::ColumnarStreamWriter(
+            const ColumnarFormatProperty& property,
+            const rti::routing::StreamInfo& stream_info,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            UtilsStorageWriter::FileSetEntry& output_file_entry) :
+    output_file_entry_(output_file_entry),
+    column_plan_(column_plan),
+    column_reader_(column_plan_->column_info()),
+    file_writer_(output_file_entry.second, property.rows_per_chunk()),
+    column_index_(0),
+    is_truncation_logged_(false),
+    counted_size_(0)
+{
+
+    file_writer_.add_metadata("topic_name", stream_info.stream_name());
+    file_writer_.add_metadata("type_name", dynamic_type(stream_info).name());
+    // metadata column
+    file_writer_.add_column("timestamp", columnar::TypeCode::INT64);
+    add_columns(column_plan_->column_info());
+}
+
+ColumnarStreamWriter::~ColumnarStreamWriter()
+{
+}
+
+void ColumnarStreamWriter::add_columns(const PrintFormatCsv::ColumnInfo& info)
+{
+    if (DataColumnReader::is_leaf(info)) {
+        file_writer_.add_column(info.path(), type_code(info.type_kind()));
+        return;
+    }
 
-    RTI_RECORDER_UTILS_LOG_MESSAGE(
-            rti::config::Verbosity::STATUS_LOCAL,
-            ("UtilsStorageWriter: create StreamWriter for file=" + output_file_path).c_str());
+    for (auto& child : info.children()) {
+        if (!child.is_element_template()) {
+            add_columns(child);
+        }
+    }
+}
 
-    switch(property_.output_format_kind()) {
+columnar::TypeCode ColumnarStreamWriter::type_code(
+        const dds::core::xtypes::TypeKind& type_kind)
+{
+    using dds::core::xtypes::TypeKind;
+
+    switch (type_kind.underlying()) {
+    case TypeKind::BOOLEAN_TYPE:
+        return columnar::TypeCode::BOOLEAN;
+    case TypeKind::CHAR_8_TYPE:
+        return columnar::TypeCode::CHAR8;
+    case TypeKind::CHAR_16_TYPE:
+        return columnar::TypeCode::CHAR16;
+    case TypeKind::UINT_8_TYPE:
+        return columnar::TypeCode::UINT8;
+    case TypeKind::INT_16_TYPE:
+        return columnar::TypeCode::INT16;
+    case TypeKind::UINT_16_TYPE:
+        return columnar::TypeCode::UINT16;
+    case TypeKind::INT_32_TYPE:
+        return columnar::TypeCode::INT32;
+    case TypeKind::UINT_32_TYPE:
+        return columnar::TypeCode::UINT32;
+    case TypeKind::INT_64_TYPE:
+        return columnar::TypeCode::INT64;
+    case TypeKind::UINT_64_TYPE:
+        return columnar::TypeCode::UINT64;
+    case TypeKind::FLOAT_32_TYPE:
+        return columnar::TypeCode::FLOAT32;
+    case TypeKind::FLOAT_64_TYPE:
+        return columnar::TypeCode::FLOAT64;
+    case TypeKind::ENUMERATION_TYPE:
+        return columnar::TypeCode::ENUM32;
+    case TypeKind::STRING_TYPE:
+    case TypeKind::WSTRING_TYPE:
+        return columnar::TypeCode::STRING;
+    default:
+        return columnar::TypeCode::UNSUPPORTED;
+    }
+}
 
-    case OutputFormatKind::CSV_FORMAT:
-    {
-        return new CsvStreamWriter(
-                csv_property_,
-                stream_info,
-                *(output_files_.find(output_file_path)));
+void ColumnarStreamWriter::store(
+        const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+        const std::vector<dds::sub::SampleInfo *>& info_seq)
+{
+    using namespace dds::sub;
+
+    StreamCounters::StoreScope store_scope(counters());
+    TraceScope trace_scope("store", trace_detail());
+
+    uint64_t write_ns = 0;
+    uint32_t row_count = 0;
+    const int32_t count = sample_seq.size();
+    for (int32_t i = 0; i < count; ++i) {
+        const SampleInfo& sample_info = *(info_seq[i]);
+        if (!is_stored(*sample_seq[i], sample_info)) {
+            continue;
+        }
+
+        uint64_t format_begin = StreamCounters::now();
+        int64_t timestamp =
+                (int64_t) sample_info->reception_timestamp().sec()
+                * NANOSECS_PER_SEC;
+        timestamp += sample_info->reception_timestamp().nanosec();
+        file_writer_.integer_value(0, timestamp);
+
+        // member columns follow the metadata column
+        column_index_ = 1;
+        column_reader_.read(*sample_seq[i], *this);
+        uint64_t write_begin = StreamCounters::now();
+        counters().add_format_time(write_begin - format_begin);
+        // writes the chunk once it's complete
+        file_writer_.end_row();
+        write_ns += StreamCounters::now() - write_begin;
+        ++row_count;
+        if (column_reader_.is_truncated()) {
+            log_truncation();
+        }
+    }
+    if (row_count > 0) {
+        counters().add_write_time(write_ns);
+    }
+    add_written_bytes();
+    check_memory_budget();
+}
+
+void ColumnarStreamWriter::add_written_bytes()
+{
+    uint64_t size = file_writer_.size();
+    counters().add_bytes(size - counted_size_);
+    counted_size_ = size;
+}
+
+void ColumnarStreamWriter::log_truncation()
+{
+    counters().add_truncated_sample();
+    if (is_truncation_logged_) {
+        return;
     }
+    is_truncation_logged_ = true;
+    RTI_RECORDER_UTILS_LOG_MESSAGE(
+            rti::config::Verbosity::WARNING,
+            ("ColumnarStreamWriter: sequence elements beyond their columns"
+                    " are not written for file="
+                    + output_file_entry_.first
+                    + ". Increase unbounded_sequence_inline_length to keep"
+                    " them").c_str());
+}
+
+void ColumnarStreamWriter::value(
+        const PrintFormatCsv::ColumnInfo&,
+        const DataColumnReader::Value& value)
+{
+    switch (file_writer_.columns()[column_index_].type_code) {
+    case columnar::TypeCode::FLOAT32:
+    case columnar::TypeCode::FLOAT64:
+        file_writer_.real_value(column_index_, value.real_value());
+        break;
+
+    case columnar::TypeCode::STRING:
+        file_writer_.text_value(column_index_, value.text_value());
         break;
 
     default:
-        throw dds::core::UnsupportedError("unsupported output format kind");
-    };
+        file_writer_.integer_value(column_index_, value.integer_value());
+        break;
+    }
+    ++column_index_;
+}
 
+void ColumnarStreamWriter::empty(const PrintFormatCsv::ColumnInfo&)
+{
+    // columns without value are null
+    ++column_index_;
 }
 
-void UtilsStorageWriter::delete_stream_writer(
-        rti::recording::storage::StorageStreamWriter *writer)
+UtilsStorageWriter::FileSetEntry& ColumnarStreamWriter::file_entry()
 {
-    CsvStreamWriter *stream_writer = static_cast<CsvStreamWriter*> (writer);
-    RTI_RECORDER_UTILS_LOG_MESSAGE(
-            rti::config::Verbosity::STATUS_LOCAL,
-            ("UtilsStorageWriter: delete StreamWriter for file="
-                    + stream_writer->file_entry().first).c_str());
-    try {
-        stream_writer->file_entry().second.flush();
-        if (property_.merge_output_files()) {
-             RTI_RECORDER_UTILS_LOG_MESSAGE(
-                    rti::config::Verbosity::STATUS_LOCAL,
-                    ("UtilsStorageWriter: merge file="
-                            + stream_writer->file_entry().first).c_str());
-            merge_output_file(stream_writer->file_entry());
+    return output_file_entry_;
+}
+
+void ColumnarStreamWriter::finalize()
+{
+    uint64_t write_begin = StreamCounters::now();
+    file_writer_.finish();
+    counters().add_write_time(StreamCounters::now() - write_begin);
+    counters().add_flush();
+    add_written_bytes();
+}
+
+uint64_t ColumnarStreamWriter::buffer_size()
+{
+    return file_writer_.buffer_size();
+}
+
+void ColumnarStreamWriter::flush_buffers()
+{
+    file_writer_.flush_chunk();
+    counters().add_flush();
+    add_written_bytes();
+}
+
+void ColumnarStreamWriter::shrink_buffers()
+{
+    file_writer_.shrink();
+}
+
+
+/*
+ * --- JsonLinesStreamWriter --------------------------------------------------
+ */
+
+JsonLinesStreamWriter::JsonLinesStreamWriter(
+            const rti::routing::StreamInfo&,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            UtilsStorageWriter::FileSetEntry& output_file_entry) :
+    output_file_entry_(output_file_entry),
+    column_plan_(column_plan),
+    json_lines_format_(column_plan_->column_info())
+{
+}
+
+JsonLinesStreamWriter::~JsonLinesStreamWriter()
+{
+}
+
+void JsonLinesStreamWriter::store(
+        const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+        const std::vector<dds::sub::SampleInfo *>& info_seq)
+{
+    using namespace dds::sub;
+
+    StreamCounters::StoreScope store_scope(counters());
+    TraceScope trace_scope("store", trace_detail());
+
+    // all the lines of the batch are written at once
+    data_as_json_.clear();
+    const size_t capacity = data_as_json_.capacity();
+    const int32_t count = sample_seq.size();
+    for (int32_t i = 0; i < count; ++i) {
+        const SampleInfo& sample_info = *(info_seq[i]);
+        if (!is_stored(*sample_seq[i], sample_info)) {
+            continue;
         }
-        stream_writer->file_entry().second.close();
-    } catch (const std::exception& ex) {
-        RTI_RECORDER_UTILS_LOG_MESSAGE(
-                rti::config::Verbosity::EXCEPTION,
-                ex.what());
-    } catch (...) {
-        std::string message =
-                "unexpected exception occurred while merging file with name="
-                + stream_writer->file_entry().first;
-        RTI_RECORDER_UTILS_LOG_MESSAGE(
-                rti::config::Verbosity::EXCEPTION,
-                message);
+
+        uint64_t format_begin = StreamCounters::now();
+        const size_t line_begin = data_as_json_.size();
+        int64_t timestamp =
+                (int64_t) sample_info->reception_timestamp().sec()
+                * NANOSECS_PER_SEC;
+        timestamp += sample_info->reception_timestamp().nanosec();
+        json_lines_format_.format(*sample_seq[i], timestamp, data_as_json_);
+        counters().add_format_time(StreamCounters::now() - format_begin);
+        counters().row_size(data_as_json_.size() - line_begin);
+    }
+    if (data_as_json_.capacity() > capacity) {
+        counters().add_buffer_growth();
     }
+    if (!data_as_json_.empty()) {
+        TraceScope write_scope("write", trace_detail());
+        uint64_t write_begin = StreamCounters::now();
+        output_file_entry_.second.write(
+                data_as_json_.data(),
+                data_as_json_.size());
+        counters().add_write_time(StreamCounters::now() - write_begin);
+        counters().add_bytes(data_as_json_.size());
+    }
+    check_memory_budget();
+    check_checkpoint();
+}
 
-    delete writer;
+UtilsStorageWriter::FileSetEntry& JsonLinesStreamWriter::file_entry()
+{
+    return output_file_entry_;
 }
 
-void UtilsStorageWriter::merge_output_file(
-        FileSetEntry& file_entry)
+void JsonLinesStreamWriter::finalize()
 {
-    std::ifstream input_file(file_entry.first);
-    std::string line;
-    while (std::getline(input_file, line)) {
-        output_merged_file_ << line << std::endl;
-    }
+    output_file_entry_.second.flush();
+    counters().add_flush();
+}
+
+uint64_t JsonLinesStreamWriter::buffer_size()
+{
+    return data_as_json_.capacity();
+}
+
+void JsonLinesStreamWriter::flush_buffers()
+{
+    output_file_entry_.second.flush();
+    counters().add_flush();
+}
+
+void JsonLinesStreamWriter::checkpoint_files(
+        StreamCheckpoint& checkpoint,
+        std::vector<std::string>& paths)
+{
+    output_file_entry_.second.flush();
+    counters().add_flush();
+    checkpoint.file_sizes.push_back(
+            static_cast<uint64_t>(output_file_entry_.second.tellp()));
+    paths.push_back(output_file_entry_.first);
+}
+
+void JsonLinesStreamWriter::shrink_buffers()
+{
+    std::string().swap(data_as_json_);
 }
 
 
 /*
- * --- CsvStreamWriter --------------------------------------------------------
+ * --- CdrStreamWriter --------------------------------------------------------
  */
 
-CsvStreamWriter::CsvStreamWriter(
-            const PrintFormatCsvProperty& property,
+std::string cdr_index_file_path(const std::string& segment_file_path)
+{
+    return segment_file_path.substr(
+                    0,
+                    segment_file_path.length()
+                            - UtilsStorageWriter::CDR_FILE_EXTENSION().length())
+            + UtilsStorageWriter::CDR_INDEX_FILE_EXTENSION();
+}
+
+CdrStreamWriter::CdrStreamWriter(
             const rti::routing::StreamInfo& stream_info,
             UtilsStorageWriter::FileSetEntry& output_file_entry) :
     output_file_entry_(output_file_entry),
-    print_format_csv_(
-            property,
-            dynamic_type(stream_info),
-            output_file_entry.second)
+    index_file_(
+            cdr_index_file_path(output_file_entry.first).c_str(),
+            std::ios::out | std::ios::binary),
+    segment_writer_(
+            output_file_entry.second,
+            index_file_,
+            stream_info.stream_name(),
+            dynamic_type(stream_info).name())
 {
+    if (!index_file_.good()) {
+        throw dds::core::Error(
+                "Failed to open file="
+                + cdr_index_file_path(output_file_entry.first)
+                + " to store the index of stream with name="
+                + stream_info.stream_name());
+    }
 }
 
-CsvStreamWriter::~CsvStreamWriter()
+CdrStreamWriter::~CdrStreamWriter()
+{
+}
+
+void CdrStreamWriter::store(
+        const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+        const std::vector<dds::sub::SampleInfo *>& info_seq)
+{
+    using namespace dds::sub;
+
+    StreamCounters::StoreScope store_scope(counters());
+    TraceScope trace_scope("store", trace_detail());
+
+    uint64_t write_ns = 0;
+    uint32_t record_count = 0;
+    const int32_t count = sample_seq.size();
+    for (int32_t i = 0; i < count; ++i) {
+        const SampleInfo& sample_info = *(info_seq[i]);
+        if (!is_stored(*sample_seq[i], sample_info)) {
+            continue;
+        }
+
+        uint64_t format_begin = StreamCounters::now();
+        int64_t timestamp =
+                (int64_t) sample_info->reception_timestamp().sec()
+                * NANOSECS_PER_SEC;
+        timestamp += sample_info->reception_timestamp().nanosec();
+        const size_t capacity = cdr_buffer_.capacity();
+        rti::core::xtypes::to_cdr_buffer(cdr_buffer_, *sample_seq[i]);
+        if (cdr_buffer_.capacity() > capacity) {
+            counters().add_buffer_growth();
+        }
+        uint64_t write_begin = StreamCounters::now();
+        counters().add_format_time(write_begin - format_begin);
+        counters().row_size(cdr_buffer_.size());
+
+        segment_writer_.append(
+                timestamp,
+                cdr_buffer_.data(),
+                static_cast<uint32_t>(cdr_buffer_.size()));
+        write_ns += StreamCounters::now() - write_begin;
+        ++record_count;
+        // the record in the segment and its entry in the index
+        counters().add_bytes(
+                cdr_segment::RECORD_HEADER_SIZE
+                + cdr_buffer_.size()
+                + cdr_segment::INDEX_ENTRY_SIZE);
+    }
+    if (record_count > 0) {
+        counters().add_write_time(write_ns);
+    }
+    check_memory_budget();
+}
+
+UtilsStorageWriter::FileSetEntry& CdrStreamWriter::file_entry()
+{
+    return output_file_entry_;
+}
+
+void CdrStreamWriter::finalize()
+{
+    segment_writer_.flush();
+    counters().add_flush();
+}
+
+uint64_t CdrStreamWriter::buffer_size()
+{
+    return cdr_buffer_.capacity();
+}
+
+void CdrStreamWriter::flush_buffers()
 {
+    segment_writer_.flush();
+    counters().add_flush();
+}
 
+void CdrStreamWriter::shrink_buffers()
+{
+    std::vector<char>().swap(cdr_buffer_);
 }
 
+
 /*
- * This function is called by Recorder whenever there are samples available for
- * one of the streams previously discovered and accepted (see the
- * FileStorageWriter_create_stream_writer() function below). Recorder provides
- * the samples and their associated information objects in Routing Service
- * format, this is, untyped format.
- * In our case we know that, except for the built-in DDS discovery topics which
- * are received in their own format - and that we're not really storing -, that
- * the format of the data we're receiving is DDS Dynamic Data. This will always
- * be the format received for types recorded from DDS.
- * The function traverses the collection of samples and stores the data in a
- * textual format.
+ * --- StatisticsStreamWriter -------------------------------------------------
  */
-void CsvStreamWriter::store(
+
+StatisticsStreamWriter::StatisticsStreamWriter(
+            const rti::routing::StreamInfo&,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            UtilsStorageWriter::FileSetEntry& output_file_entry) :
+    output_file_entry_(output_file_entry),
+    column_plan_(column_plan),
+    column_statistics_(column_plan_->column_info())
+{
+}
+
+StatisticsStreamWriter::~StatisticsStreamWriter()
+{
+}
+
+void StatisticsStreamWriter::store(
         const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
         const std::vector<dds::sub::SampleInfo *>& info_seq)
 {
-    using namespace dds::core::xtypes;
-    using namespace rti::core::xtypes;
     using namespace dds::sub;
 
+    StreamCounters::StoreScope store_scope(counters());
+    TraceScope trace_scope("store", trace_detail());
+
     const int32_t count = sample_seq.size();
     for (int32_t i = 0; i < count; ++i) {
         const SampleInfo& sample_info = *(info_seq[i]);
-        // we first first print the sample's metadata
+        if (!is_stored(*sample_seq[i], sample_info)) {
+            continue;
+        }
+
+        uint64_t format_begin = StreamCounters::now();
         int64_t timestamp =
                 (int64_t) sample_info->reception_timestamp().sec()
                 * NANOSECS_PER_SEC;
         timestamp += sample_info->reception_timestamp().nanosec();
-
-        // print sample data
-        if (sample_info->valid()) {
-            DDS_UnsignedLong data_as_csv_size = 0;
-
-            // compute required size
-            DDS_ReturnCode_t native_retcode = DDS_DynamicDataFormatter_to_string_w_format(
-                    &sample_seq[i]->native(),
-                    NULL,
-                    &data_as_csv_size,
-                    print_format_csv_.native());
-            rti::core::check_return_code(
-                    native_retcode,
-                    "failed to compute CSV data required length");
-            data_as_csv_.resize(data_as_csv_size);
-            native_retcode = DDS_DynamicDataFormatter_to_string_w_format(
-                    &sample_seq[i]->native(),
-                    &data_as_csv_[0],
-                    &data_as_csv_size,
-                    print_format_csv_.native());
-            rti::core::check_return_code(
-                    native_retcode,
-                    "failed convert to DynamicData to CSV");
-
-            /**
-             * Eliminating the trailing '\0' character needed by the C APIs. 
-             * Note that C++ internally keeps the null terminating character and 
-             * as such doesn't count it in the size() call.
-             */
-            data_as_csv_.resize(data_as_csv_size - 1);
-
-            // add timestamp metadata (first column)
-            output_file_entry_.second << timestamp;
-
-            // add formatted sample content to file
-            output_file_entry_.second << data_as_csv_;
-            // end of row
-            output_file_entry_ .second << std::endl;
-        }
+        column_statistics_.add(*sample_seq[i], timestamp);
+        counters().add_format_time(StreamCounters::now() - format_begin);
     }
+    check_memory_budget();
 }
 
-UtilsStorageWriter::FileSetEntry& CsvStreamWriter::file_entry()
+UtilsStorageWriter::FileSetEntry& StatisticsStreamWriter::file_entry()
 {
     return output_file_entry_;
 }
 
-} } }
+void StatisticsStreamWriter::finalize()
+{
+    // the statistics are only written at the end
+    std::ofstream& output = output_file_entry_.second;
+    uint64_t write_begin = StreamCounters::now();
+    std::streampos begin = output.tellp();
+    column_statistics_.write(output);
+    output.flush();
+    std::streampos end = output.tellp();
+    counters().add_write_time(StreamCounters::now() - write_begin);
+    counters().add_flush();
+    if (begin != std::streampos(-1) && end != std::streampos(-1)) {
+        counters().add_bytes(static_cast<uint64_t>(end - begin));
+    }
+}
+
+uint64_t StatisticsStreamWriter::buffer_size()
+{
+    // the statistics have a fixed size per column
+    return 0;
+}
+
+void StatisticsStreamWriter::flush_buffers()
+{
+}
 
+void StatisticsStreamWriter::shrink_buffers()
+{
+}
+
+} } }
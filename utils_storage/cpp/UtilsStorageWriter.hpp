@@ -13,12 +13,31 @@
 #define RTI_RECORDER_UTILS_STORAGE_WRITER_HPP_
 
 #include <fstream>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include "rti/recording/storage/StorageWriter.hpp"
 #include "rti/recording/storage/StorageStreamWriter.hpp"
 #include "rti/recording/storage/StorageDiscoveryStreamWriter.hpp"
 
 #include "PrintFormatCsv.hpp"
+#include "ColumnarFormat.hpp"
+#include "DataColumnReader.hpp"
+#include "JsonLinesFormat.hpp"
+#include "CdrSegmentFormat.hpp"
+#include "Checkpoint.hpp"
+#include "ColumnPlanCache.hpp"
+#include "RowFilter.hpp"
+#include "Decimator.hpp"
+#include "ColumnStatistics.hpp"
+#include "DeltaRowEncoder.hpp"
+#include "MetadataEmitter.hpp"
+#include "MemoryBudget.hpp"
+#include "StreamCounters.hpp"
+#include "Tracer.hpp"
 
 namespace rti { namespace recorder { namespace utils {
 
@@ -38,9 +57,15 @@ RTI_RECORDING_STORAGE_WRITER_CREATE_DECL(UtilsStorageWriter);
  * @brief Definition of the support output formats.
  */
 enum class OutputFormatKind {
-        CSV_FORMAT
+        CSV_FORMAT,
+        COLUMNAR_FORMAT,
+        JSON_LINES_FORMAT,
+        CDR_FORMAT,
+        STATISTICS_FORMAT
 };
 
+class UtilsStreamWriter;
+
 /**
  * @brief Configuration elements of the Utils storage plug-in.
  *
@@ -51,7 +76,7 @@ public:
 
     /**
      * @brief Selects the format in which samples are stored in an output
-     * text file.
+     * file.
      *
      * Default: CSV_FORMAT
      */
@@ -99,11 +124,26 @@ public:
      */
     UtilsStorageProperty& merge_output_files(bool);
 
+    /**
+     * @brief Indicates whether the output files of the streams that
+     * didn't receive any sample are written. Otherwise, the output files of
+     * a stream are created when its first sample is stored.
+     *
+     * Default: false
+     */
+    bool write_empty_streams() const;
+
+    /**
+     * @brief Gets the write_empty_streams
+     */
+    UtilsStorageProperty& write_empty_streams(bool);
+
 private:
     OutputFormatKind output_format_kind_;
     std::string output_dir_path_;
     std::string output_file_basename_;
     bool merge_output_files_;
+    bool write_empty_streams_;
 };
 
 /***
@@ -120,6 +160,20 @@ std::ostream& operator<<(
         std::ostream& os,
         const PrintFormatCsvProperty& property);
 
+/**
+ * @brief String representation of ColumnarFormatProperty
+ */
+std::ostream& operator<<(
+        std::ostream& os,
+        const ColumnarFormatProperty& property);
+
+/**
+ * @brief String representation of StatsReporterProperty
+ */
+std::ostream& operator<<(
+        std::ostream& os,
+        const StatsReporterProperty& property);
+
 /**
  * @brief Implementation of a StorageWriter plug-in that allows storing
  * DynamicData samples represented in a text-compatible format, such as CSV.
@@ -170,7 +224,13 @@ public:
      */
     static const std::string& OUTPUT_FILE_BASENAME_PROPERTY_NAME();
 
-
+    /**
+     * @brief Returns the name of the property that configures
+     * UtilsStorageProperty::output_format_kind. Valid values are
+     * CSV, COLUMNAR, JSONL, CDR and STATISTICS.
+     *
+     * Value: [namespace].output_format
+     */
     static const std::string& OUTPUT_FORMAT_PROPERTY_NAME();
 
     /**
@@ -181,6 +241,14 @@ public:
      */
     static const std::string& OUTPUT_MERGE_PROPERTY_NAME();
 
+    /**
+     * @brief Returns the name of the property that configures
+     * UtilsStorageProperty::write_empty_streams
+     *
+     * Value: [namespace].write_empty_streams
+     */
+    static const std::string& OUTPUT_EMPTY_STREAMS_PROPERTY_NAME();
+
     /**
      * @brief Returns the name of the property that configures
      * the verbosity level for the logging messages.
@@ -205,6 +273,221 @@ public:
      */
     static const std::string& CSV_ENUM_AS_STRING_PROPERTY_NAME();
 
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::exploded_sequence_min_bound
+     *
+     * Value: [namespace].csv.exploded_sequence_min_bound
+     */
+    static const std::string& CSV_EXPLODED_SEQUENCE_MIN_BOUND_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::unbounded_sequence_inline_length. It applies
+     * to all the output formats.
+     *
+     * Value: [namespace].unbounded_sequence_inline_length
+     */
+    static const std::string& UNBOUNDED_SEQUENCE_INLINE_LENGTH_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::packed_primitive_collections
+     *
+     * Value: [namespace].csv.packed_primitive_collections
+     */
+    static const std::string& CSV_PACKED_PRIMITIVE_COLLECTIONS_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::packed_value_separator
+     *
+     * Value: [namespace].csv.packed_value_separator
+     */
+    static const std::string& CSV_PACKED_VALUE_SEPARATOR_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::octet_encoding. Valid values are HEX and
+     * BASE64.
+     *
+     * Value: [namespace].csv.octet_encoding
+     */
+    static const std::string& CSV_OCTET_ENCODING_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::dictionary_encoding. Valid values are NONE,
+     * ENUMS and ENUMS_AND_STRINGS.
+     *
+     * Value: [namespace].csv.dictionary_encoding
+     */
+    static const std::string& CSV_DICTIONARY_ENCODING_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::delta_rows. Valid values are NONE,
+     * CHANGED_ROWS and CHANGED_CELLS.
+     *
+     * Value: [namespace].csv.delta_rows
+     */
+    static const std::string& CSV_DELTA_ROWS_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::keyframe_interval
+     *
+     * Value: [namespace].csv.keyframe_interval
+     */
+    static const std::string& CSV_KEYFRAME_INTERVAL_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * PrintFormatCsvProperty::metadata_columns, as a comma-separated list
+     * of column names: source_timestamp, sequence_number, writer_guid and
+     * instance_handle.
+     *
+     * Value: [namespace].csv.metadata_columns
+     */
+    static const std::string& CSV_METADATA_COLUMNS_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * ColumnarFormatProperty::rows_per_chunk
+     *
+     * Value: [namespace].columnar.rows_per_chunk
+     */
+    static const std::string& COLUMNAR_ROWS_PER_CHUNK_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures the number
+     * of threads that build the column plans of the streams as soon as
+     * they are created. With 0, the plan of a stream is built when its
+     * first sample is stored.
+     *
+     * Value: [namespace].column_plan.build_threads
+     */
+    static const std::string& COLUMN_PLAN_BUILD_THREADS_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures the period in
+     * milliseconds of the checkpoints of the output files of each stream.
+     * With 0, there are no checkpoints.
+     *
+     * Value: [namespace].checkpoint.period_ms
+     */
+    static const std::string& CHECKPOINT_PERIOD_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that indicates whether the
+     * output files of a previous conversion are continued from their
+     * checkpoints.
+     *
+     * Value: [namespace].checkpoint.resume
+     */
+    static const std::string& CHECKPOINT_RESUME_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * StatsReporterProperty::output_file_path. The performance counters of
+     * the streams are only reported if this property is set.
+     *
+     * Value: [namespace].stats.output_file
+     */
+    static const std::string& STATS_OUTPUT_FILE_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * StatsReporterProperty::format: JSON or PROMETHEUS
+     *
+     * Value: [namespace].stats.format
+     */
+    static const std::string& STATS_FORMAT_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * StatsReporterProperty::period_ms
+     *
+     * Value: [namespace].stats.period_ms
+     */
+    static const std::string& STATS_PERIOD_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * MemoryBudgetProperty::limit_bytes
+     *
+     * Value: [namespace].memory_budget.limit_bytes
+     */
+    static const std::string& MEMORY_BUDGET_LIMIT_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * MemoryBudgetProperty::policy: FLUSH, SHRINK or BLOCK
+     *
+     * Value: [namespace].memory_budget.policy
+     */
+    static const std::string& MEMORY_BUDGET_POLICY_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures
+     * MemoryBudgetProperty::block_timeout_ms
+     *
+     * Value: [namespace].memory_budget.block_timeout_ms
+     */
+    static const std::string& MEMORY_BUDGET_BLOCK_TIMEOUT_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that enables the Tracer and
+     * specifies the path of the Chrome trace file written when the
+     * UtilsStorageWriter is deleted.
+     *
+     * Value: [namespace].trace.output_file
+     */
+    static const std::string& TRACE_OUTPUT_FILE_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the name of the property that configures the number
+     * of events of the trace buffer of each thread.
+     *
+     * Value: [namespace].trace.events_per_thread
+     */
+    static const std::string& TRACE_EVENTS_PER_THREAD_PROPERTY_NAME();
+
+    /**
+     * @brief Returns the prefix of the names of the properties that select
+     * the columns of a stream. The rest of the name is the stream name and
+     * the value is a comma-separated list of ColumnProjection patterns,
+     * e.g. ".pose.position.*,.m_array[0..9]".
+     *
+     * Streams without a projection property have all their columns. The
+     * projection applies to all the output formats but CDR.
+     *
+     * Value: [namespace].projection.
+     */
+    static const std::string& PROJECTION_PROPERTY_NAME_PREFIX();
+
+    /**
+     * @brief Returns the prefix of the names of the properties that filter
+     * the samples of a stream. The rest of the name is the stream name and
+     * the value is a RowFilter expression, e.g. "state = 'ERROR'".
+     *
+     * Streams without a filter property store all their valid samples.
+     *
+     * Value: [namespace].filter.
+     */
+    static const std::string& FILTER_PROPERTY_NAME_PREFIX();
+
+    /**
+     * @brief Returns the prefix of the names of the properties that
+     * decimate the samples of a stream. The rest of the name is the stream
+     * name and the value is a DecimatorProperty, e.g. "MEAN:100ms".
+     *
+     * The decimation applies to the CSV format only.
+     *
+     * Value: [namespace].decimation.
+     */
+    static const std::string& DECIMATION_PROPERTY_NAME_PREFIX();
+
     /**
      * @brief Returns the file extension for the files that contain the data
      * in CSV format.
@@ -213,6 +496,54 @@ public:
      */
     static const std::string& CSV_FILE_EXTENSION();
 
+    /**
+     * @brief Returns the file extension for the files that contain the data
+     * in columnar format.
+     *
+     * Value: .columnar
+     */
+    static const std::string& COLUMNAR_FILE_EXTENSION();
+
+    /**
+     * @brief Returns the file extension for the files that contain the data
+     * in JSON Lines format.
+     *
+     * Value: .jsonl
+     */
+    static const std::string& JSON_LINES_FILE_EXTENSION();
+
+    /**
+     * @brief Returns the file extension for the segment files that contain
+     * the serialized samples in CDR format.
+     *
+     * Value: .cdrseg
+     */
+    static const std::string& CDR_FILE_EXTENSION();
+
+    /**
+     * @brief Returns the file extension for the index of a CDR segment file.
+     * The index file has the same name as its segment file.
+     *
+     * Value: .cdridx
+     */
+    static const std::string& CDR_INDEX_FILE_EXTENSION();
+
+    /**
+     * @brief Returns the file extension for the files that contain the
+     * column statistics of a stream.
+     *
+     * Value: .stats.csv
+     */
+    static const std::string& STATISTICS_FILE_EXTENSION();
+
+    /**
+     * @brief Returns the suffix appended to the name of a CSV file, before
+     * the extension, to name the file with its dictionary entries.
+     *
+     * Value: -dictionary
+     */
+    static const std::string& CSV_DICTIONARY_FILE_SUFFIX();
+
     /**
      * @brief Returns the default value of the prefix used for the output file
      * names.
@@ -232,8 +563,11 @@ public:
     /* --- StorateWriter implementation ------------------------------------ */
 
     /**
-     * @brief Creates a UtilsStreamWriter for each stream/topic.
+     * @brief Creates a LazyStreamWriter for each stream/topic. Its
+     * UtilsStreamWriter, output files and column plan are created when the
+     * first sample is stored.
      *
+     * @see LazyStreamWriter
      * @see UtilsStreamWriter
      */
     rti::recording::storage::StorageStreamWriter * create_stream_writer(
@@ -241,7 +575,8 @@ public:
             const rti::routing::PropertySet&) override;
 
     /**
-     * @brief Deletes the UtilsStreamWriter.
+     * @brief Finalizes the UtilsStreamWriter of the stream, if it was
+     * created, and deletes the LazyStreamWriter.
      */
     void delete_stream_writer(
             rti::recording::storage::StorageStreamWriter *writer) override;
@@ -249,13 +584,150 @@ public:
 private:
     void merge_output_file(FileSetEntry& file_entry);
 
+    // opens the output file of a stream and creates its UtilsStreamWriter
+    UtilsStreamWriter * materialize_stream_writer(
+            const rti::routing::StreamInfo& stream_info,
+            const std::string& output_file_path,
+            uint32_t trace_detail);
+
+    // extension of the output files for the configured format
+    const std::string& file_extension() const;
+
+    // column plan of a stream, with its projection if any
+    ColumnPlanCache::ColumnPlanPtr column_plan(
+            const rti::routing::StreamInfo& stream_info);
+
+    // queues the build of the column plan of a stream, if enabled
+    void prefetch_column_plan(const rti::routing::StreamInfo& stream_info);
+
     UtilsStorageProperty property_;
-    // Collection of output files, one for each stream
+    // Collection of output files, one for each stream with samples
     OutputFileSet output_files_;
+    // protects the output files and the column plans, which are created
+    // by the threads that store the first sample of each stream
+    std::mutex output_files_mutex_;
     // The final file if merging is enabled
     std::ofstream output_merged_file_;
     // Property per output kind
     PrintFormatCsvProperty csv_property_;
+    ColumnarFormatProperty columnar_property_;
+    // configuration of the column layout of the output format
+    PrintFormatCsvProperty layout_property_;
+    // column plans shared by the streams of the same type, built in the
+    // background by the configured number of threads
+    uint32_t column_plan_thread_count_;
+    std::unique_ptr<ColumnPlanCache> column_plan_cache_;
+    // selected columns by stream name
+    std::map<std::string, ColumnProjection> projections_;
+    // filter expressions by stream name, compiled for each stream
+    std::map<std::string, std::string> filters_;
+    // decimation by stream name
+    std::map<std::string, DecimatorProperty> decimations_;
+    // reports the counters of the streams, if enabled
+    StatsReporterProperty stats_property_;
+    std::unique_ptr<StatsReporter> stats_reporter_;
+    // memory of the buffers of all the streams
+    MemoryBudgetProperty memory_budget_property_;
+    std::shared_ptr<MemoryBudget> memory_budget_;
+    // charged with the memory of the column plans
+    std::unique_ptr<MemoryBudget::Account> plan_memory_account_;
+    // checkpoints of the output files, if enabled
+    uint32_t checkpoint_period_ms_;
+    bool checkpoint_resume_;
+    // file of the trace events, if tracing is enabled
+    std::string trace_output_file_path_;
+    uint32_t trace_events_per_thread_;
+};
+
+/**
+ * @brief StreamWriter returned by UtilsStorageWriter for each stream. It
+ * defers the creation of the UtilsStreamWriter of the stream, and with it
+ * the output files and the column plan, until the first call to store().
+ *
+ * Streams that don't receive any sample cost only this object, unless
+ * UtilsStorageProperty::write_empty_streams is enabled.
+ */
+class LazyStreamWriter :
+        public rti::recording::storage::DynamicDataStorageStreamWriter {
+public:
+    typedef std::function<UtilsStreamWriter *()> Factory;
+
+    /**
+     * @brief Creates a LazyStreamWriter
+     *
+     * @param[in] stream_name Name of the stream
+     * @param[in] factory Creates the UtilsStreamWriter of the stream
+     */
+    LazyStreamWriter(const std::string& stream_name, Factory factory);
+
+    virtual ~LazyStreamWriter() override;
+
+    /**
+     * @brief Creates the UtilsStreamWriter, if needed, and stores the
+     * samples with it.
+     *
+     * @override Implementation of DynamicDataStorageStreamWriter::store
+     */
+    void store(
+            const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+            const std::vector<dds::sub::SampleInfo *>& info_seq) override;
+
+    /**
+     * @brief Creates the UtilsStreamWriter, if it wasn't created yet
+     */
+    UtilsStreamWriter& materialize();
+
+    /**
+     * @brief Returns whether the UtilsStreamWriter has been created
+     */
+    bool is_materialized() const;
+
+    /**
+     * @brief Returns the UtilsStreamWriter. Requires is_materialized().
+     */
+    UtilsStreamWriter& stream_writer();
+
+    const std::string& stream_name() const;
+
+    /**
+     * @brief Sets the row filter given to the UtilsStreamWriter
+     *
+     * @see UtilsStreamWriter::row_filter
+     */
+    void row_filter(std::unique_ptr<RowFilter> filter);
+
+    /**
+     * @brief Sets the performance counters given to the UtilsStreamWriter
+     *
+     * @see UtilsStreamWriter::counters
+     */
+    void counters(std::shared_ptr<StreamCounters> counters);
+
+    /**
+     * @brief Sets the Tracer detail given to the UtilsStreamWriter
+     *
+     * @see UtilsStreamWriter::trace_detail
+     */
+    void trace_detail(uint32_t detail);
+
+    uint32_t trace_detail() const;
+
+    /**
+     * @brief Sets the MemoryBudget account given to the UtilsStreamWriter
+     *
+     * @see UtilsStreamWriter::memory_account
+     */
+    void memory_account(std::unique_ptr<MemoryBudget::Account> account);
+
+private:
+    std::string stream_name_;
+    Factory factory_;
+    std::unique_ptr<UtilsStreamWriter> stream_writer_;
+    // configuration handed over to the UtilsStreamWriter when it's created
+    std::unique_ptr<RowFilter> row_filter_;
+    std::shared_ptr<StreamCounters> counters_;
+    uint32_t trace_detail_;
+    std::unique_ptr<MemoryBudget::Account> memory_account_;
 };
 
 /**
@@ -272,13 +744,167 @@ private:
  *
  * Known implementations:
  * - CsvStreamWriter
+ * - ColumnarStreamWriter
+ * - JsonLinesStreamWriter
+ * - CdrStreamWriter
+ * - StatisticsStreamWriter
  *
  */
 class UtilsStreamWriter :
         public rti::recording::storage::DynamicDataStorageStreamWriter {
 public:
+    UtilsStreamWriter();
 
     virtual UtilsStorageWriter::FileSetEntry& file_entry() = 0;
+
+    /**
+     * @brief Writes any pending content into the output file. Called before
+     * the output file is closed.
+     */
+    virtual void finalize() = 0;
+
+    /**
+     * @brief Sets the filter of the samples to store. Samples rejected by
+     * the filter are skipped before they are formatted.
+     */
+    void row_filter(std::unique_ptr<RowFilter> filter);
+
+    /**
+     * @brief Sets the performance counters updated by this StreamWriter. By
+     * default, the counters are not reported.
+     */
+    void counters(std::shared_ptr<StreamCounters> counters);
+
+    /**
+     * @brief Sets the Tracer detail attached to the events of this
+     * StreamWriter, usually the identifier of the stream name.
+     */
+    void trace_detail(uint32_t detail);
+
+    /**
+     * @brief Gets the Tracer detail of this StreamWriter
+     */
+    uint32_t trace_detail() const;
+
+    /**
+     * @brief Sets the MemoryBudget account charged with the buffers of this
+     * StreamWriter. By default, the buffers are not accounted.
+     *
+     * While the account is set, other streams exceeding the budget may
+     * release the buffers of this StreamWriter when it's idle, that is,
+     * when buffer_mutex() is not locked. The account must be reset before
+     * this StreamWriter is finalized.
+     */
+    void memory_account(std::unique_ptr<MemoryBudget::Account> account);
+
+    /**
+     * @brief Gets the mutex that must be locked while store() is called,
+     * when a memory account is set.
+     */
+    std::mutex& buffer_mutex();
+
+    /**
+     * @brief Enables the checkpoints of the output files of this
+     * StreamWriter. By default, there are no checkpoints.
+     *
+     * @param[in] file File where the checkpoints are written
+     * @param[in] period_ms Minimum time between two checkpoints written
+     *                      after a call to store().
+     * @param[in] resumed Checkpoint the output files were resumed from, if
+     *                    any. The samples it covers are skipped: the
+     *                    samples are expected in reception timestamp order.
+     */
+    void checkpointing(
+            std::unique_ptr<CheckpointFile> file,
+            uint32_t period_ms,
+            const StreamCheckpoint *resumed);
+
+    /**
+     * @brief Writes a checkpoint of the samples stored so far, if
+     * checkpoints are enabled.
+     */
+    void checkpoint();
+
+protected:
+    /**
+     * @brief Flushes the output files and adds their sizes, and the state
+     * needed to continue them, to a checkpoint. Only the formats that
+     * support checkpoints implement it.
+     *
+     * @param[out] checkpoint The checkpoint being written
+     * @param[out] paths The paths of the output files, in the order of
+     *                   StreamCheckpoint::file_sizes
+     */
+    virtual void checkpoint_files(
+            StreamCheckpoint& checkpoint,
+            std::vector<std::string>& paths);
+
+    /**
+     * @brief Writes a checkpoint if the checkpoint period has elapsed.
+     * Called at the end of each store().
+     */
+    void check_checkpoint();
+
+    /**
+     * @brief Returns the bytes currently reserved by the buffers of this
+     * StreamWriter.
+     */
+    virtual uint64_t buffer_size() = 0;
+
+    /**
+     * @brief Writes the buffered output into the output files ahead of time
+     */
+    virtual void flush_buffers() = 0;
+
+    /**
+     * @brief Releases the memory of the buffers that are not in use
+     */
+    virtual void shrink_buffers() = 0;
+
+    /**
+     * @brief Charges the buffers to the memory account. If the budget is
+     * exceeded, reclaims the buffers of the idle streams first, and then
+     * applies the MemoryBudgetPolicyKind to this StreamWriter. Called at the
+     * end of each store().
+     */
+    void check_memory_budget();
+
+    /**
+     * @brief Returns whether a sample has to be stored: it's valid and it's
+     * accepted by the row filter, if any.
+     */
+    bool is_stored(
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info);
+
+    /**
+     * @brief Gets the performance counters of this StreamWriter
+     */
+    StreamCounters& counters();
+
+private:
+    std::unique_ptr<RowFilter> row_filter_;
+    std::shared_ptr<StreamCounters> counters_;
+    uint32_t trace_detail_;
+    std::unique_ptr<MemoryBudget::Account> memory_account_;
+    // held by store() and by the reclaim of other streams
+    std::mutex buffer_mutex_;
+
+    // releases the buffers according to the MemoryBudgetPolicyKind
+    void release_buffers(MemoryBudgetPolicyKind policy);
+
+    // returns whether a sample is covered by the resumed checkpoint
+    bool is_resumed_sample(const dds::sub::SampleInfo& info);
+
+    std::unique_ptr<CheckpointFile> checkpoint_file_;
+    uint64_t checkpoint_period_ns_;
+    uint64_t last_checkpoint_ns_;
+    // samples received so far
+    StreamCheckpoint progress_;
+    // samples to skip, while is_resuming_
+    StreamCheckpoint resumed_;
+    bool is_resuming_;
+    std::vector<std::string> checkpoint_paths_;
 };
 
 /**
@@ -296,19 +922,30 @@ public:
      *
      * @param[in] property CSV output configuration elements.
      * @param[in] stream_info Information associated to the stream/topic
+     * @param[in] column_plan Column layout of the stream type, built with
+     *                        the same property.
+     * @param[in] decimation Selection or aggregation of the samples written
+     *                       as rows.
      * @param[in] output_file_entry The output file where data is pushed.
+     * @param[in] resumed Checkpoint the output files are resumed from. The
+     *                    output file is already resumed, with its header.
+     *                    nullptr if the files are new.
      */
     CsvStreamWriter(
             const PrintFormatCsvProperty& property,
             const rti::routing::StreamInfo& stream_info,
-            UtilsStorageWriter::FileSetEntry& output_file_entry);
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            const DecimatorProperty& decimation,
+            UtilsStorageWriter::FileSetEntry& output_file_entry,
+            const StreamCheckpoint *resumed = nullptr);
 
 
     virtual ~CsvStreamWriter() override;
 
     /**
      * @brief Writes the input samples into a CSV file. Each sample is placed
-     * in a separate row.
+     * in a separate row, unless the stream is decimated. The elements of
+     * exploded sequences are placed in the file of their table.
      *
      * @override Implementation of DynamicDataStorageStreamWriter::store
      */
@@ -324,15 +961,400 @@ public:
      */
     UtilsStorageWriter::FileSetEntry& file_entry() override;
 
+    /**
+     * @brief Writes the row of the last bucket of a decimated stream and
+     * flushes the output file and the files of the exploded tables and
+     * dictionary.
+     *
+     * @override UtilsStreamWriter::finalize
+     */
+    void finalize() override;
+
+protected:
+    /**
+     * @override UtilsStreamWriter::buffer_size
+     */
+    uint64_t buffer_size() override;
+
+    /**
+     * @override UtilsStreamWriter::flush_buffers
+     */
+    void flush_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::shrink_buffers
+     */
+    void shrink_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::checkpoint_files
+     */
+    void checkpoint_files(
+            StreamCheckpoint& checkpoint,
+            std::vector<std::string>& paths) override;
+
 private:
+    void write_row(
+            dds::core::xtypes::DynamicData& sample,
+            const dds::sub::SampleInfo& info,
+            int64_t timestamp);
+    // flushes the rows of a call to store() and adds their write time
+    void end_batch();
+
     // PrintFormat implementation used to convert data samples
     PrintFormatCsv print_format_csv_;
     UtilsStorageWriter::FileSetEntry& output_file_entry_;
     // a buffer to represent a single CSV sample
     std::string data_as_csv_;
+    // one file for each exploded table, in the same order
+    std::list<std::ofstream> exploded_files_;
+    std::vector<std::string> exploded_file_paths_;
+    // entries of the dictionary encoded columns, if any
+    std::ofstream dictionary_file_;
+    // identifier of the next row, key of the exploded table rows
+    uint64_t row_id_;
+    // selects the samples written, if the stream is decimated
+    std::unique_ptr<Decimator> decimator_;
+    // suppresses the redundant rows and cells, if enabled
+    std::unique_ptr<DeltaRowEncoder> delta_row_encoder_;
+    // writes the metadata columns of the samples, if any are selected
+    std::unique_ptr<MetadataEmitter> metadata_emitter_;
+    // a buffer for the metadata columns of a single row, which precede the
+    // sample content
+    std::string row_prefix_;
+    // write time and number of the rows written in the current call to
+    // store()
+    uint64_t batch_write_ns_;
+    uint64_t batch_row_count_;
+};
+
+/**
+ * @brief Implementation of a UtilsStreamWriter that writes samples into
+ * a binary file in columnar format.
+ *
+ * There is a column for each leaf column of the ColumnInfo tree of the
+ * stream type, preceded by the reception timestamp column. Values are read
+ * from the samples with a DataColumnReader and stored with their native
+ * binary representation. Sequence elements beyond the inline element
+ * columns are dropped and the samples are counted as truncated.
+ *
+ * @see columnar::FileWriter for the details of the file layout.
+ */
+class ColumnarStreamWriter :
+        public UtilsStreamWriter,
+        private DataColumnReader::Visitor {
+public:
+
+    /**
+     * @brief Creates an UtilsStreamWriter responsible for storing the
+     * data in a file in columnar format.
+     *
+     * @param[in] property Columnar output configuration elements.
+     * @param[in] stream_info Information associated to the stream/topic
+     * @param[in] column_plan Column layout of the stream type
+     * @param[in] output_file_entry The output file where data is pushed.
+     */
+    ColumnarStreamWriter(
+            const ColumnarFormatProperty& property,
+            const rti::routing::StreamInfo& stream_info,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            UtilsStorageWriter::FileSetEntry& output_file_entry);
+
+    virtual ~ColumnarStreamWriter() override;
+
+    /**
+     * @brief Adds the input samples as rows of the current chunk. Chunks
+     * are written into the file as they are completed.
+     *
+     * @override Implementation of DynamicDataStorageStreamWriter::store
+     */
+    void store(
+            const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+            const std::vector<dds::sub::SampleInfo *>& info_seq) override;
+
+    /**
+     * @override UtilsStreamWriter::file_entry
+     */
+    UtilsStorageWriter::FileSetEntry& file_entry() override;
+
+    /**
+     * @brief Writes the pending chunk and the file footer.
+     *
+     * @override UtilsStreamWriter::finalize
+     */
+    void finalize() override;
+
+    /**
+     * @brief Returns the columnar type used to store the values of a
+     * member with the specified type kind.
+     */
+    static columnar::TypeCode type_code(
+            const dds::core::xtypes::TypeKind& type_kind);
+
+protected:
+    /**
+     * @override UtilsStreamWriter::buffer_size
+     */
+    uint64_t buffer_size() override;
+
+    /**
+     * @override UtilsStreamWriter::flush_buffers
+     */
+    void flush_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::shrink_buffers
+     */
+    void shrink_buffers() override;
+
+private:
+    void value(
+            const PrintFormatCsv::ColumnInfo& info,
+            const DataColumnReader::Value& value) override;
+
+    void empty(const PrintFormatCsv::ColumnInfo& info) override;
+
+    void add_columns(const PrintFormatCsv::ColumnInfo& info);
+
+    // counts a sample with dropped sequence elements, logged once
+    void log_truncation();
+
+    // adds the bytes written into the file since the last call
+    void add_written_bytes();
+
+    UtilsStorageWriter::FileSetEntry& output_file_entry_;
+    ColumnPlanCache::ColumnPlanPtr column_plan_;
+    DataColumnReader column_reader_;
+    columnar::FileWriter file_writer_;
+    // index of the column notified by the column reader
+    uint32_t column_index_;
+    bool is_truncation_logged_;
+    // bytes of the file already added to the counters
+    uint64_t counted_size_;
+};
+
+/**
+ * @brief Implementation of a UtilsStreamWriter that writes samples into
+ * a text file in JSON Lines format, one JSON object per sample.
+ *
+ * @see JsonLinesFormat for the details of the representation.
+ */
+class JsonLinesStreamWriter : public UtilsStreamWriter {
+public:
+
+    /**
+     * @brief Creates an UtilsStreamWriter responsible for storing the
+     * data in a file in JSON Lines format.
+     *
+     * @param[in] stream_info Information associated to the stream/topic
+     * @param[in] column_plan Column layout of the stream type
+     * @param[in] output_file_entry The output file where data is pushed.
+     */
+    JsonLinesStreamWriter(
+            const rti::routing::StreamInfo& stream_info,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            UtilsStorageWriter::FileSetEntry& output_file_entry);
+
+    virtual ~JsonLinesStreamWriter() override;
+
+    /**
+     * @brief Writes the input samples into a JSON Lines file. Each sample is
+     * placed in a separate line.
+     *
+     * @override Implementation of DynamicDataStorageStreamWriter::store
+     */
+    void store(
+            const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+            const std::vector<dds::sub::SampleInfo *>& info_seq) override;
+
+    /**
+     * @override UtilsStreamWriter::file_entry
+     */
+    UtilsStorageWriter::FileSetEntry& file_entry() override;
+
+    /**
+     * @brief Flushes the output file.
+     *
+     * @override UtilsStreamWriter::finalize
+     */
+    void finalize() override;
+
+protected:
+    /**
+     * @override UtilsStreamWriter::buffer_size
+     */
+    uint64_t buffer_size() override;
+
+    /**
+     * @override UtilsStreamWriter::flush_buffers
+     */
+    void flush_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::shrink_buffers
+     */
+    void shrink_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::checkpoint_files
+     */
+    void checkpoint_files(
+            StreamCheckpoint& checkpoint,
+            std::vector<std::string>& paths) override;
+
+private:
+    UtilsStorageWriter::FileSetEntry& output_file_entry_;
+    ColumnPlanCache::ColumnPlanPtr column_plan_;
+    JsonLinesFormat json_lines_format_;
+    // a buffer to represent the lines of a batch of samples
+    std::string data_as_json_;
+};
+
+/**
+ * @brief Implementation of a UtilsStreamWriter that appends the serialized
+ * samples into a CDR segment file, deferring their conversion.
+ *
+ * Each valid sample is serialized into CDR and appended, together with its
+ * reception timestamp, as a record of the segment file. The offset of each
+ * record is added to an index file placed next to the segment file.
+ *
+ * Segment files are converted into the other output formats with the
+ * utilsstorage_cdr_replay tool.
+ *
+ * @see cdr_segment::SegmentWriter for the details of the file layout.
+ */
+class CdrStreamWriter : public UtilsStreamWriter {
+public:
+
+    /**
+     * @brief Creates an UtilsStreamWriter responsible for storing the
+     * data in a CDR segment file.
+     *
+     * @param[in] stream_info Information associated to the stream/topic
+     * @param[in] output_file_entry The output file where data is pushed.
+     */
+    CdrStreamWriter(
+            const rti::routing::StreamInfo& stream_info,
+            UtilsStorageWriter::FileSetEntry& output_file_entry);
+
+    virtual ~CdrStreamWriter() override;
+
+    /**
+     * @brief Appends the input samples to the segment file.
+     *
+     * @override Implementation of DynamicDataStorageStreamWriter::store
+     */
+    void store(
+            const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+            const std::vector<dds::sub::SampleInfo *>& info_seq) override;
+
+    /**
+     * @override UtilsStreamWriter::file_entry
+     */
+    UtilsStorageWriter::FileSetEntry& file_entry() override;
+
+    /**
+     * @brief Flushes the segment file and its index.
+     *
+     * @override UtilsStreamWriter::finalize
+     */
+    void finalize() override;
+
+protected:
+    /**
+     * @override UtilsStreamWriter::buffer_size
+     */
+    uint64_t buffer_size() override;
+
+    /**
+     * @override UtilsStreamWriter::flush_buffers
+     */
+    void flush_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::shrink_buffers
+     */
+    void shrink_buffers() override;
+
+private:
+    UtilsStorageWriter::FileSetEntry& output_file_entry_;
+    std::ofstream index_file_;
+    cdr_segment::SegmentWriter segment_writer_;
+    // reused buffer for the serialized sample
+    std::vector<char> cdr_buffer_;
+};
+
+/**
+ * @brief Implementation of a UtilsStreamWriter that keeps the statistics of
+ * the columns of a stream and writes them when the stream is deleted.
+ *
+ * No sample is written: the output file contains a row per column of the
+ * stream with the summary of its values.
+ *
+ * @see ColumnStatistics for the details of the file content.
+ */
+class StatisticsStreamWriter : public UtilsStreamWriter {
+public:
+
+    /**
+     * @brief Creates an UtilsStreamWriter responsible for computing the
+     * statistics of the columns of a stream.
+     *
+     * @param[in] stream_info Information associated to the stream/topic
+     * @param[in] column_plan Column layout of the stream type
+     * @param[in] output_file_entry The output file where the statistics are
+     *                              written.
+     */
+    StatisticsStreamWriter(
+            const rti::routing::StreamInfo& stream_info,
+            ColumnPlanCache::ColumnPlanPtr column_plan,
+            UtilsStorageWriter::FileSetEntry& output_file_entry);
+
+    virtual ~StatisticsStreamWriter() override;
+
+    /**
+     * @brief Adds the values of the input samples to the statistics.
+     *
+     * @override Implementation of DynamicDataStorageStreamWriter::store
+     */
+    void store(
+            const std::vector<dds::core::xtypes::DynamicData *>& sample_seq,
+            const std::vector<dds::sub::SampleInfo *>& info_seq) override;
+
+    /**
+     * @override UtilsStreamWriter::file_entry
+     */
+    UtilsStorageWriter::FileSetEntry& file_entry() override;
+
+    /**
+     * @brief Writes the statistics into the output file.
+     *
+     * @override UtilsStreamWriter::finalize
+     */
+    void finalize() override;
+
+protected:
+    /**
+     * @override UtilsStreamWriter::buffer_size
+     */
+    uint64_t buffer_size() override;
+
+    /**
+     * @override UtilsStreamWriter::flush_buffers
+     */
+    void flush_buffers() override;
+
+    /**
+     * @override UtilsStreamWriter::shrink_buffers
+     */
+    void shrink_buffers() override;
+
+private:
+    UtilsStorageWriter::FileSetEntry& output_file_entry_;
+    ColumnPlanCache::ColumnPlanPtr column_plan_;
+    ColumnStatistics column_statistics_;
 };
 
 } } }
 
 #endif
-